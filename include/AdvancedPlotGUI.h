@@ -11,6 +11,8 @@
 #include <TGTextView.h>
 #include <TGComboBox.h>
 #include <TGDNDManager.h>
+#include <TGProgressBar.h>
+#include <TGLabel.h>
 
 #include "FileHandler.h"
 #include "PlotManager.h"
@@ -38,7 +40,12 @@ private:
         kSaveScriptButton,
         kClearEditorButton,
         kEntrySelector,
-        kClearOutputButton
+        kClearOutputButton,
+        kCancelLoadButton,
+        kInterruptScriptButton,
+        kExportButton,
+        kDefineColumnButton,
+        kConvertButton
     };
 
     // GUI Components
@@ -46,9 +53,11 @@ private:
     TGTextEntry* fFileEntry;  // CHANGED: Regular TGTextEntry instead of DropTextEntry
     TGTextButton* fBrowseButton;
     TGTextButton* fAddPlotButton;
+    TGTextButton* fDefineColumnButton;
     TGTextButton* fRemovePlotButton;
     TGTextButton* fClearAllButton;
     TGTextButton* fPlotButton;
+    TGTextButton* fExportButton;
     TGListBox* fPlotListBox;
     TGTextEntry* fCanvasTitleEntry;
     TGCheckButton* fSameCanvasCheck;
@@ -56,14 +65,26 @@ private:
     TGNumberEntry* fNRowsEntry;
     TGNumberEntry* fNColsEntry;
     TGComboBox* fFitFunctionCombo;
+    TGCheckButton* fUnbinnedCheck;
     TGTextEntry* fCustomFuncEntry;
     TGTextButton* fEntrySelectorButton;
+    TGTextButton* fConvertButton;
+
+    // Background load status
+    TGHProgressBar* fLoadProgressBar;
+    TGLabel*        fLoadStatusLabel;
+    TGTextButton*   fCancelLoadButton;
     
     // Script panel
     TGComboBox* fScriptLangCombo;
+    TGCheckButton* fCompiledScriptCheck;
+    TGTextEntry* fScriptEntryPoint;   // compiled mode: function to call
     TGTextEdit* fScriptEditor;
     TGTextView* fScriptOutput;
     TGTextEntry* fCommandEntry;
+    TGTextButton* fRunScriptButton;
+    TGTextButton* fInterruptButton;
+    TGLabel* fScriptStatusLabel;
     
     // Manager objects
     FileHandler* fFileHandler;
@@ -76,6 +97,9 @@ private:
     void BuildCanvasOptionsSection();
     void BuildFitSection();
     void BuildScriptPanel();
+
+    // Asks for "name = expression" (see DerivedColumns)
+    void DefineColumn();
     
 public:
     AdvancedPlotGUI(const TGWindow* p, UInt_t w, UInt_t h);
@@ -86,6 +110,9 @@ public:
     
     // Message processing
     Bool_t ProcessMessage(Long_t msg, Long_t parm1, Long_t parm2);
+
+    // Poll timers owned by the managers are delivered here
+    Bool_t HandleTimer(TTimer* timer);
     
     // Getters for managers to access GUI state
     const char* GetFilePath() const { return fFileEntry->GetText(); }
@@ -95,16 +122,28 @@ public:
     
     Int_t GetNRows() const { return (Int_t)fNRowsEntry->GetNumber(); }
     Int_t GetNCols() const { return (Int_t)fNColsEntry->GetNumber(); }
+    Bool_t UseUnbinnedFit() const { return fUnbinnedCheck && fUnbinnedCheck->IsOn(); }
     
     TGTextEdit* GetScriptEditor() { return fScriptEditor; }
     TGTextView* GetScriptOutput() { return fScriptOutput; }
     TGTextEntry* GetCommandEntry() { return fCommandEntry; }
+    Bool_t UseCompiledScripts() const { return fCompiledScriptCheck && fCompiledScriptCheck->IsOn(); }
+    TString GetScriptEntryPoint() const;
+    void SetScriptEntryPoint(const char* name);
     
     // GUI state manipulation helpers for managers
     void EnablePlotControls(Bool_t enable);
     void AddPlotToListBox(const char* desc, Int_t id);
     void RebuildPlotListBox(const std::vector<PlotConfig>& configs);
     void ClearPlotListBox();
+
+    // Background load status display
+    void SetLoadBusy(Bool_t busy, const char* what);
+    void SetLoadProgress(Float_t percent, const char* status);
+
+    // Script execution status display
+    void SetScriptRunning(Bool_t running);
+    void SetScriptStatus(const char* status);
     
     ClassDef(AdvancedPlotGUI, 1)
 };
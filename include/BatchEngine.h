@@ -0,0 +1,108 @@
+#ifndef BATCHENGINE_H
+#define BATCHENGINE_H
+
+#include "PlotTypes.h"
+#include "FitUtils.h"
+#include "DerivedColumns.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+// ============================================================================
+// Exit codes of `AdvancedPlotGUIApp --batch ...` (stable; scripts rely on them)
+// ============================================================================
+enum BatchExitCode {
+    kBatchOK          = 0,   // every job succeeded
+    kBatchJobsFailed  = 1,   // some jobs failed, at least one succeeded
+    kBatchAllFailed   = 2,   // no job succeeded
+    kBatchBadJobFile  = 3,   // job file missing or malformed
+    kBatchUsage       = 4    // bad command line
+};
+
+// ============================================================================
+// BatchPlot — one PlotConfig of a job plus the fit to apply to it.
+// Columns given by header name in the job file are resolved once the
+// input has been read (namedColumns holds "x"/"y"/... -> header name).
+// ============================================================================
+struct BatchPlot {
+    PlotConfig                                       config;
+    FitUtils::FitType                                fit = FitUtils::kNoFit;
+    std::string                                      fitFormula;
+    unsigned                                         fitStarts = 1;
+    std::vector<std::pair<std::string, std::string>> namedColumns;
+};
+
+// ============================================================================
+// BatchJob — one canvas: an input file, its plots and the files to write
+// ============================================================================
+struct BatchJob {
+    std::string              name;
+    std::string              input;
+    std::vector<BatchPlot>   plots;
+    std::vector<DerivedColumnDef> defines;      // computed columns, in order
+    std::vector<std::string> outputs;
+    bool                     overlay = false;   // default: one pad per plot
+    int                      nCols   = 0;       // pad grid; 0 = near-square
+    int                      nRows   = 0;
+    int                      width   = 800;
+    int                      height  = 600;
+    int                      line    = 0;       // [Job] line in the job file
+};
+
+struct BatchResult {
+    std::string              name;
+    bool                     ok = false;
+    double                   seconds = 0.0;
+    std::vector<std::string> written;
+    std::string              message;
+};
+
+// ============================================================================
+// BatchEngine — headless pipeline behind `--batch`.
+// Runs jobs without TRint or the GUI: inputs are read once on a ThreadPool,
+// canvases are rendered by PlotExporter's worker processes.
+// Job file format (INI-like, as .selchain):
+//
+//   [Job energy]
+//   Input=run42.csv
+//   Define=pt = sqrt(px^2 + py^2)   (a column computed from the others)
+//   Plot=TH1D x=energy bins=200 fit=gaus
+//   Plot=TGraphErrors x=0 y=1 yerr=2 fit=custom formula="[0]*x+[1]"
+//   Plot=TGraph x=t y=v fit=dampedsine starts=8
+//   Plot=TH1D x=pt cut="pt > 20 && abs(eta) < 2.4"
+//   Layout=divided            (or overlay)
+//   Grid=2x1                  (pads, columns x rows; default near-square)
+//   Size=1200x800
+//   Output=out/energy.png
+//   Output=out/energy.pdf
+//
+// Relative Input=/Output= paths are taken relative to the job file.
+//
+// `--batch --convert in.csv out.root [--rntuple]` writes a text file to a
+// ROOT file once (CSVConverter); Input=out.root then reads the typed tree
+// instead of parsing text on every run.
+// ============================================================================
+class BatchEngine {
+public:
+    static bool ParseJobFile(const std::string& path, std::vector<BatchJob>& jobs,
+                             std::string& error);
+    static bool ParsePlot(const std::string& spec, BatchPlot& plot, std::string& error);
+
+    // The pre-job-file behaviour: TH1D of column 0 -> batch_output.png/.pdf
+    static BatchJob DefaultJob(const std::string& input);
+
+    // Builds the job's canvas offscreen from already-read data and writes
+    // its outputs. Thread-safe; SaveAs itself is serialised per process.
+    static BatchResult RenderJob(const BatchJob& job, const ColumnData& data);
+
+    // Reads inputs on nThreads threads, renders on nWorkers forked worker
+    // processes (0 = in this process) and writes the manifest if named.
+    static int Run(const std::vector<BatchJob>& jobs, unsigned nThreads = 0,
+                   unsigned nWorkers = 0, const std::string& manifest = "");
+
+    // Entry point for main(): argv[1] == "--batch"
+    static int Main(int argc, char** argv);
+};
+
+#endif // BATCHENGINE_H
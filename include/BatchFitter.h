@@ -0,0 +1,92 @@
+#ifndef BATCHFITTER_H
+#define BATCHFITTER_H
+
+#include "FitModels.h"
+#include "FitUtils.h"
+
+#include <TF1.h>
+#include <TObject.h>
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// FitSpec — what to fit: one of the FitUtils models, a custom formula, or
+// any model registered with FitModelRegistry by name
+// ============================================================================
+struct FitSpec {
+    FitUtils::FitType type = FitUtils::kNoFit;
+    std::string       formula;                 // kCustom only
+    std::string       model;                   // registry name; overrides type
+    std::string       minimizer = "Minuit2";   // thread-safe; TMinuit is not
+    bool              useCache  = true;        // consult and fill FitCache
+    unsigned          starts    = 1;           // >1: fit from that many starting
+                                               // points in parallel, keep the best
+
+    bool IsSet() const { return !model.empty() || type != FitUtils::kNoFit; }
+
+    // Registry model used, "" for custom formulas
+    std::string ModelName() const {
+        if (!model.empty()) return model;
+        return type == FitUtils::kCustom ? "" : FitUtils::GetFitFunctions().at(type).first;
+    }
+
+    // Identifies the fit in FitCache; bump the "g" tag when the guesses change
+    std::string CacheKey() const {
+        return "t" + std::to_string(type) + "|m" + model + "|" + minimizer + "|g3|s" +
+               std::to_string(starts) + "|" + formula;
+    }
+};
+
+// ============================================================================
+// FitRow — one row of the batch fit result table
+// ============================================================================
+struct FitRow {
+    std::string              object;           // name of the fitted object
+    std::string              model;
+    std::vector<std::string> parNames;
+    std::vector<double>      params;
+    std::vector<double>      errors;
+    double                   chi2    = 0.0;
+    int                      ndf     = 0;
+    int                      status  = -1;     // minimizer status, -1 = not fitted
+    bool                     valid   = false;
+    bool                     cached  = false;  // restored from FitCache
+    double                   seconds = 0.0;
+    std::string              message;
+
+    double Chi2NDF() const { return ndf > 0 ? chi2 / ndf : 0.0; }
+};
+
+// ============================================================================
+// BatchFitter — fits many TGraph/TH1 objects concurrently on a ThreadPool.
+// The prototype TF1 comes from FitModelRegistry (compiled models, custom
+// formulas JIT-compiled once per string); every object gets its own copy,
+// made on the calling thread, and its own ROOT::Fit::Fitter. Workers only read the
+// objects, so nothing shared is modified while fits run. Results already
+// in FitCache for the same data and spec are restored without fitting.
+// With spec.starts > 1 each object is fitted from the registry model's
+// starting points concurrently and the lowest chi2 is kept.
+// ============================================================================
+class BatchFitter {
+public:
+    // Returns one row per object, in order. When fitted is given it receives
+    // the fitted TF1 per object (nullptr where the fit failed); caller owns.
+    static std::vector<FitRow> FitAll(const std::vector<TObject*>& objects,
+                                      const FitSpec& spec, unsigned nThreads = 0,
+                                      std::vector<TF1*>* fitted = nullptr);
+
+    static void PrintTable(const std::vector<FitRow>& rows, std::ostream& os);
+    static bool WriteTable(const std::string& path, const std::vector<FitRow>& rows);
+
+private:
+    static TF1* MakePrototype(const FitSpec& spec, std::string& error);
+    static bool SetRange(TF1& f, const TObject* obj, FitRow& row);
+    static bool Restore(TF1& f, const std::string& key, FitRow& row);
+    static void Store(const std::string& key, const FitRow& row);
+    static void FitOne(TF1& f, const FitSpec& spec, const TObject* obj, FitRow& row,
+                       const std::vector<double>* start = nullptr);
+};
+
+#endif // BATCHFITTER_H
@@ -0,0 +1,61 @@
+#ifndef CSVCONVERTER_H
+#define CSVCONVERTER_H
+
+#include "DataReader.h"
+
+#include <string>
+#include <vector>
+
+// ============================================================================
+// CSVConverter — writes a delimited text file to a compressed ROOT file once,
+// so later sessions read typed, columnar branches instead of re-parsing text.
+// Two passes over the input, both parsed in chunks on a ThreadPool:
+//   1. infer each column's type: Int_t if every value is an integer that
+//      fits, Long64_t if wider, Double_t otherwise (missing or non-numeric
+//      values are stored as NaN)
+//   2. parse again into typed chunks, filled into the output in file order
+//      by the calling thread (ROOT I/O stays on one thread)
+// Header handling matches DataReader::ReadDelimitedFile. Column names are
+// made valid branch/field names ([A-Za-z0-9_], unique).
+// ============================================================================
+class CSVConverter {
+public:
+    enum Format {
+        kTTree,     // readable by every ROOT version
+        kRNTuple    // needs a build with RNTuple (APG_HAVE_RNTUPLE)
+    };
+
+    enum ColumnType {   // ordered: a column takes the widest type seen
+        kInt,
+        kLong,
+        kDouble
+    };
+
+    struct Options {
+        char     delim       = ',';
+        int      skipRows    = 0;
+        bool     useHeader   = false;
+        bool     autoHeader  = true;     // header if the first token is non-numeric
+        Format   format      = kTTree;
+        std::string treeName = "data";   // TTree / RNTuple name in the file
+        int      compression = 505;      // ROOT setting: algorithm*100 + level (ZSTD 5)
+        unsigned nThreads    = 0;        // parse threads; 0 = ThreadPool::DefaultSize()
+        size_t   chunkLines  = 65536;
+    };
+
+    // Writes rootPath (recreated). progress counts bytes over both passes;
+    // a cancel request removes the partial output. message holds the summary
+    // or the reason for failure.
+    static bool Convert(const std::string& inputPath, const std::string& rootPath,
+                        const Options& options, std::string& message,
+                        ReadProgress* progress = nullptr);
+
+    static bool HaveRNTuple();
+    static const char* TypeName(ColumnType type);
+
+    // Name usable as a TTree branch / RNTuple field: other characters
+    // become '_', a leading digit gets a '_' prefix
+    static std::string BranchName(const std::string& header);
+};
+
+#endif // CSVCONVERTER_H
@@ -0,0 +1,68 @@
+#ifndef COLUMNBUFFER_H
+#define COLUMNBUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+// ============================================================================
+// Column storage of ColumnData, laid out as Apache Arrow lays out a float64
+// array: a contiguous value buffer aligned to 64 bytes (whole cache lines,
+// full-width vector loads from element 0) and a validity bitmap, one bit
+// per row, LSB first, set = valid. Buffers in this layout can be handed to
+// SIMD kernels or exported without a copy.
+// ============================================================================
+template <class T, size_t Align>
+struct AlignedAllocator {
+    using value_type = T;
+    template <class U> struct rebind { using other = AlignedAllocator<U, Align>; };
+
+    AlignedAllocator() noexcept = default;
+    template <class U> AlignedAllocator(const AlignedAllocator<U, Align>&) noexcept {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Align)));
+    }
+    void deallocate(T* p, size_t) noexcept {
+        ::operator delete(p, std::align_val_t(Align));
+    }
+
+    template <class U> bool operator==(const AlignedAllocator<U, Align>&) const noexcept { return true; }
+    template <class U> bool operator!=(const AlignedAllocator<U, Align>&) const noexcept { return false; }
+};
+
+// ============================================================================
+// ValidityBitmap — the null rows of one column. Only nulls touch it: a
+// column without any has no words at all, and rows past the last word are
+// valid, so appending valid values costs nothing. Every bit that was not
+// nulled is 1, which makes the words usable as they are in a word-wise AND
+// with a RowSelection.
+// ============================================================================
+class ValidityBitmap {
+private:
+    std::vector<uint64_t> fWords;
+    size_t                fNulls = 0;
+
+public:
+    bool   AllValid()  const { return fNulls == 0; }
+    size_t NullCount() const { return fNulls; }
+
+    bool Test(size_t row) const {
+        size_t w = row >> 6;
+        return w >= fWords.size() || ((fWords[w] >> (row & 63)) & 1);
+    }
+
+    void SetNull(size_t row) {
+        size_t w = row >> 6;
+        if (w >= fWords.size()) fWords.resize(w + 1, ~uint64_t(0));
+        uint64_t bit = uint64_t(1) << (row & 63);
+        if (fWords[w] & bit) { fWords[w] &= ~bit; ++fNulls; }
+    }
+
+    // Words covering the first NumWords() * 64 rows; later rows are valid
+    const uint64_t* Words()    const { return fWords.data(); }
+    size_t          NumWords() const { return fWords.size(); }
+};
+
+#endif // COLUMNBUFFER_H
@@ -0,0 +1,80 @@
+#ifndef COLUMNEXPRESSION_H
+#define COLUMNEXPRESSION_H
+
+#include "DataReader.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class RowSelection;
+
+// ============================================================================
+// ColumnExpression — an arithmetic expression over the columns of a
+// ColumnData, e.g. "sqrt(px*px + py*py)". Compile() parses it once into a
+// small stack program with the column names resolved to indices and
+// constant subexpressions folded; Evaluate() runs the program over blocks
+// of kBlock rows, one instruction at a time across the whole block, so
+// every step is a plain loop the compiler vectorizes. Large tables are
+// split across threads.
+//
+// Syntax: numbers, column names (`back quotes` for names that are not
+// identifiers), + - * / ^ (or **), unary -, parentheses, the constants pi
+// and e, and the functions sqrt abs exp log log10 sin cos tan asin acos
+// atan sinh cosh tanh floor ceil (one argument), pow atan2 hypot min max
+// (two). Column names take precedence over constants. Comparisons
+// (< <= > >= == !=) and logic (&& || !, C precedence) give 1 or 0, so an
+// expression doubles as a cut (Select()).
+// ============================================================================
+class ColumnExpression {
+public:
+    static const int kBlock          = 256;       // rows per evaluation step
+    static const int kParallelRows   = 1 << 20;   // split tables at least this long
+
+    ColumnExpression() = default;
+
+    // false with a message (and its position) on a syntax error or an
+    // unknown column or function
+    bool Compile(const std::string& text, const std::vector<std::string>& headers,
+                 std::string& error);
+
+    // Syntax only: any identifier is taken for a column
+    static bool CheckSyntax(const std::string& text, std::string& error);
+
+    // Values of the first n rows, n the length of the shortest input column
+    // (of the table, for an expression without columns); NaN where an
+    // input is null
+    void Evaluate(const ColumnData& data, ColumnData::Column& out) const;
+
+    // Rows where the value is non-zero and not NaN (sqrt(-1), 0/0) and no
+    // input is null, over the same n rows
+    void Select(const ColumnData& data, RowSelection& out) const;
+
+    const std::string&      GetText()   const { return fText; }
+    const std::vector<int>& GetInputs() const { return fInputs; }   // column indices used
+    bool                    IsCompiled() const { return !fCode.empty(); }
+
+private:
+    enum Op : uint8_t { kColumn, kConst, kAdd, kSub, kMul, kDiv, kPow, kNeg, kCall1, kCall2,
+                        kLt, kLe, kGt, kGe, kEq, kNe, kAnd, kOr, kNot };
+    struct Instr {
+        Op     op;
+        int    arg   = 0;     // column index or function index
+        double value = 0.0;   // kConst
+    };
+
+    std::string        fText;
+    std::vector<Instr> fCode;       // postfix
+    std::vector<int>   fInputs;
+    int                fMaxDepth = 0;
+
+    class Parser;
+
+    size_t NumRows(const ColumnData& data) const;   // rows both calls cover
+    template <class Sink>
+    void ForEachBlock(const ColumnData& data, size_t n, Sink sink) const;
+    const double* RunBlock(const ColumnData& data, size_t row, size_t n,
+                           double* scratch, const double** slot) const;
+};
+
+#endif // COLUMNEXPRESSION_H
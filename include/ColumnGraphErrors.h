@@ -0,0 +1,55 @@
+#ifndef COLUMNGRAPHERRORS_H
+#define COLUMNGRAPHERRORS_H
+
+#include "DataReader.h"
+
+#include <TGraphErrors.h>
+
+#include <memory>
+
+// ============================================================================
+// ColumnGraphErrors — a TGraphErrors over the columns of a shared
+// ColumnData, borrowed instead of copied; the table is kept alive by the
+// graph. A missing error column points at one process-wide block of zeros
+// (calloc'd, so its untouched pages cost no memory) rather than a new zero
+// array per graph. The first change of a point or error copies everything
+// into arrays of its own. Do not write through GetX()/GetEX()... before
+// Materialize(). Not editable in the canvas: a dragged point would be
+// written into the table. Fits, painting and I/O (as TGraphErrors) see it
+// like any other TGraphErrors.
+// ============================================================================
+class ColumnGraphErrors : public TGraphErrors {
+private:
+    std::shared_ptr<const ColumnData> fData;    // set while the arrays are borrowed
+    std::shared_ptr<const double>     fZeros;   // backing for absent error columns
+
+public:
+    // Borrows the first n values; error columns < 0 mean no error.
+    // data must not be null.
+    ColumnGraphErrors(std::shared_ptr<const ColumnData> data, int xColumn, int yColumn,
+                      int xErrColumn, int yErrColumn, Int_t n);
+    ~ColumnGraphErrors() override;
+
+    // Point changes: own copies of the points first
+    void  SetPoint(Int_t i, Double_t x, Double_t y) override;
+    void  Set(Int_t n) override;
+    Int_t InsertPoint() override;
+    using TGraphErrors::RemovePoint;
+    Int_t RemovePoint(Int_t ipoint) override;
+    void  SetPointX(Int_t i, Double_t x) override;
+    void  SetPointY(Int_t i, Double_t y) override;
+    void  Apply(TF1* f) override;
+    void  Scale(Double_t c1 = 1., Option_t* option = "y") override;
+    void  Sort(Bool_t (*greater)(const TGraph*, Int_t, Int_t) = &TGraph::CompareX,
+               Bool_t ascending = kTRUE, Int_t low = 0, Int_t high = -1111) override;
+    void  SetPointError(Double_t ex, Double_t ey) override;
+    void  SetPointError(Int_t i, Double_t ex, Double_t ey) override;
+
+    bool IsBorrowed() const { return fData != nullptr; }
+    void Materialize();
+
+    // At least n zeros shared by all graphs; nullptr if the allocation fails
+    static std::shared_ptr<const double> ZeroBuffer(size_t n);
+};
+
+#endif // COLUMNGRAPHERRORS_H
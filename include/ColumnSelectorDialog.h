@@ -6,6 +6,7 @@
 #include <TGComboBox.h>
 #include <TGNumberEntry.h>
 #include <TGLabel.h>
+#include <TGTextEntry.h>
 #include <RQ_OBJECT.h>
 
 #include "DataReader.h"
@@ -59,6 +60,8 @@ private:
     TGCheckButton* radioTH3D;
     TGCheckButton* radioTH3F;
     TGCheckButton* radioTH3I;
+    TGCheckButton* radioTProfile;
+    TGCheckButton* radioTProfile2D;
 
     // Column selector combos
     TGComboBox* xColumnCombo;
@@ -66,6 +69,10 @@ private:
     TGComboBox* zColumnCombo;
     TGComboBox* xErrCombo;
     TGComboBox* yErrCombo;
+    TGComboBox* weightCombo;
+
+    // Row selection (see CutCache)
+    TGTextEntry* cutEntry;
 
     // Buttons
     TGTextButton* okButton;
@@ -0,0 +1,54 @@
+#ifndef CONCURRENTQUEUE_H
+#define CONCURRENTQUEUE_H
+
+#include <deque>
+#include <mutex>
+#include <vector>
+
+// ============================================================================
+// ConcurrentQueue — minimal mutex-protected FIFO used to hand results from
+// worker threads to the GUI thread. Producers call Push(); the GUI thread
+// polls with TryPop()/Drain() from a TTimer, so nothing ever blocks it.
+// ============================================================================
+template <typename T>
+class ConcurrentQueue {
+private:
+    mutable std::mutex fMutex;
+    std::deque<T>      fItems;
+
+public:
+    void Push(T item) {
+        std::lock_guard<std::mutex> lock(fMutex);
+        fItems.push_back(std::move(item));
+    }
+
+    bool TryPop(T& out) {
+        std::lock_guard<std::mutex> lock(fMutex);
+        if (fItems.empty()) return false;
+        out = std::move(fItems.front());
+        fItems.pop_front();
+        return true;
+    }
+
+    // Take everything queued so far in one lock
+    std::vector<T> Drain() {
+        std::lock_guard<std::mutex> lock(fMutex);
+        std::vector<T> out;
+        out.reserve(fItems.size());
+        for (auto& item : fItems) out.push_back(std::move(item));
+        fItems.clear();
+        return out;
+    }
+
+    void Clear() {
+        std::lock_guard<std::mutex> lock(fMutex);
+        fItems.clear();
+    }
+
+    bool Empty() const {
+        std::lock_guard<std::mutex> lock(fMutex);
+        return fItems.empty();
+    }
+};
+
+#endif // CONCURRENTQUEUE_H
@@ -3,6 +3,8 @@
 
 #include <TFile.h>
 #include <TTree.h>
+#include <TBranch.h>
+#include <TLeaf.h>
 #include <TKey.h>
 #include <TH1.h>
 #include <TH2.h>
@@ -12,39 +14,118 @@
 #include <TList.h>
 #include <TClass.h>
 #include <TPad.h>
+#include "ColumnBuffer.h"
+#include "RNTupleData.h"
 #include <string>
 #include <vector>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <memory>
 
 //////////////////////////////
-// Data structure to hold column data
+// Data structure to hold column data.
+// Columnar: each column is one float64 buffer, 64-byte aligned, with a
+// validity bitmap beside it (ColumnBuffer.h). A missing or unparsable value
+// is a null: NaN in the buffer and a cleared validity bit, so the rows of
+// all columns stay aligned. Code that only reads values sees the NaN; code
+// that must skip nulls asks IsValid()/Validity().
+// Tables held by a shared_ptr can be borrowed by plot objects
+// (weak_from_this()); columns must not be resized while they are.
 //////////////////////////////
-struct ColumnData {
+struct ColumnData : public std::enable_shared_from_this<ColumnData> {
+    static const size_t kAlignment = 64;
+    using Column = std::vector<double, AlignedAllocator<double, kAlignment>>;
+
     std::vector<std::string> headers;      // Column names/headers
-    std::vector<std::vector<double>> data; // Column data
+    std::vector<Column> data;              // Column values
+    std::vector<ValidityBitmap> validity;  // per column; shorter than data = rest all valid
     std::string filename;
     std::string name;
-    std::vector<double> xVals;
-    std::vector<double> yVals;
-    std::vector<std::string> labels;
+    uint64_t uid = NewUid();   // identity of the contents, for caches (see Touch)
+    std::vector<std::string> derived;  // expressions of the last derived.size() columns (DerivedColumns)
 
     // Constructor
     ColumnData() = default;
     
     // Clear data
     void Clear() {
-        xVals.clear();
-        yVals.clear();
-        labels.clear();
+        headers.clear();
+        data.clear();
+        validity.clear();
+        derived.clear();
+        Touch();
+    }
+
+    // Copies share the uid of their source. Anything that changes a table
+    // in place after it was handed out must call Touch(), so caches keyed
+    // on the uid stop matching it.
+    void Touch() { uid = NewUid(); }
+    static uint64_t NewUid() {
+        static std::atomic<uint64_t> next{0};
+        return ++next;
     }
     
     int GetNumColumns() const { return headers.size(); }
     int GetNumRows() const { 
         return data.empty() ? 0 : data[0].size(); 
     }
+
+    // Nulls
+    bool IsValid(int col, size_t row) const {
+        return col >= (int)validity.size() || validity[col].Test(row);
+    }
+    size_t NullCount(int col) const {
+        return col < (int)validity.size() ? validity[col].NullCount() : 0;
+    }
+    // nullptr when the column has no nulls
+    const ValidityBitmap* Validity(int col) const {
+        return NullCount(col) ? &validity[col] : nullptr;
+    }
+    void SetNull(int col, size_t row) {
+        if (col >= (int)validity.size()) validity.resize(col + 1);
+        validity[col].SetNull(row);
+        data[col][row] = std::numeric_limits<double>::quiet_NaN();
+    }
+    void AppendNull(int col) {
+        data[col].push_back(std::numeric_limits<double>::quiet_NaN());
+        SetNull(col, data[col].size() - 1);
+    }
+    // NaN values of a column become nulls (NaN is how ROOT files and
+    // CSVConverter store missing values)
+    void NullsFromNaN(int col) {
+        const Column& v = data[col];
+        for (size_t i = 0; i < v.size(); ++i)
+            if (v[i] != v[i]) SetNull(col, i);
+    }
+    // Columns from n on are dropped, with their validity
+    void ResizeColumns(size_t n) {
+        data.resize(n);
+        if (validity.size() > n) validity.resize(n);
+    }
+};
+
+//////////////////////////////
+// Progress / cancellation shared between a loader thread and the GUI.
+// The reader updates the counters; the GUI polls them and may set cancel.
+//////////////////////////////
+struct ReadProgress {
+    std::atomic<Long64_t> processed{0};  // bytes (text) or entries/objects (ROOT)
+    std::atomic<Long64_t> total{0};      // same unit as processed, 0 = unknown
+    std::atomic<Long64_t> rows{0};       // data rows parsed so far
+    std::atomic<bool>     cancel{false};
+
+    void Reset() { processed = 0; total = 0; rows = 0; cancel = false; }
+    bool Cancelled() const { return cancel.load(std::memory_order_relaxed); }
+    double Fraction() const {
+        Long64_t t = total.load();
+        return t > 0 ? std::min(1.0, (double)processed.load() / (double)t) : 0.0;
+    }
 };
 
 //////////////////////////////
@@ -74,140 +155,140 @@ public:
         return kText; // Default to text
     }
     
-    // Read text/dat file (space or tab separated)
-    static bool ReadTextFile(const std::string& filename, ColumnData& data) {
-        std::ifstream file(filename);
-        if (!file.is_open()) {
-            std::cerr << "Cannot open file: " << filename << std::endl;
-            return false;
+    // Lines between two progress updates / cancel checks. Small enough that
+    // a cancel request is honoured within a few milliseconds.
+    static const int kProgressStride = 256;
+
+    static Long64_t FileSize(const std::string& filename) {
+        std::ifstream f(filename, std::ios::binary | std::ios::ate);
+        return f.is_open() ? (Long64_t)f.tellg() : 0;
+    }
+
+    // Split a line on delim (' ' = any run of whitespace) and trim tokens
+    static void Tokenize(const std::string& line, char delim,
+                         std::vector<std::string>& tokens) {
+        tokens.clear();
+        std::stringstream ss(line);
+        std::string token;
+        if (delim == ' ') {
+            while (ss >> token) tokens.push_back(token);
+            return;
         }
-        
-        data.filename = filename;
-        std::string line;
-        bool firstLine = true;
-        
-        while (std::getline(file, line)) {
-            if (line.empty() || line[0] == '#') continue; // Skip empty and comment lines
-            
-            std::stringstream ss(line);
-            std::vector<std::string> tokens;
-            std::string token;
-            
-            while (ss >> token) {
-                tokens.push_back(token);
-            }
-            
-            if (tokens.empty()) continue;
-            
-            // First line could be headers (check if non-numeric)
-            if (firstLine) {
-                bool isHeader = false;
-                try {
-                    std::stod(tokens[0]);
-                } catch (...) {
-                    isHeader = true;
-                }
-                
-                if (isHeader) {
-                    data.headers = tokens;
-                    data.data.resize(tokens.size());
-                    firstLine = false;
-                    continue;
-                }
-            }
-            
-            // If no header found, create default headers
-            if (data.data.empty()) {
-                data.data.resize(tokens.size());
-                for (size_t i = 0; i < tokens.size(); ++i) {
-                    data.headers.push_back(Form("Col%zu", i));
-                }
-            }
-            
-            // Parse data
-            for (size_t i = 0; i < tokens.size() && i < data.data.size(); ++i) {
-                try {
-                    double val = std::stod(tokens[i]);
-                    data.data[i].push_back(val);
-                } catch (...) {
-                    // Skip non-numeric values
-                }
-            }
-            
-            firstLine = false;
+        while (std::getline(ss, token, delim)) {
+            token.erase(0, token.find_first_not_of(" \t\r\n"));
+            token.erase(token.find_last_not_of(" \t\r\n") + 1);
+            tokens.push_back(token);
         }
-        
-        return !data.data.empty();
     }
-    
-    // Read CSV file (comma separated)
-    static bool ReadCSVFile(const std::string& filename, ColumnData& data) {
+
+    // Empty, whitespace-only or CRLF blank line: not a row
+    static bool IsBlank(const std::string& line) {
+        return line.find_first_not_of(" \t\r") == std::string::npos;
+    }
+
+    // A whole token as a number: false for empty, partly numeric ("12abc")
+    // or NaN tokens, which the readers store as nulls
+    static bool ParseValue(const std::string& token, double& value) {
+        if (token.empty()) return false;
+        char* end = nullptr;
+        value = std::strtod(token.c_str(), &end);
+        return *end == '\0' && value == value;
+    }
+
+    // Generic delimited reader used by the text/CSV readers and by the
+    // CSV preview settings. With autoHeader the first line is treated as a
+    // header only if its first token is non-numeric; '#' lines are comments.
+    // If progress is given, it is updated every kProgressStride lines and a
+    // cancel request stops the parse, keeping the rows read so far.
+    static bool ReadDelimitedFile(const std::string& filename, char delim,
+                                  int skipRows, bool useHeader, bool autoHeader,
+                                  ColumnData& data, ReadProgress* progress = nullptr) {
         std::ifstream file(filename);
         if (!file.is_open()) {
             std::cerr << "Cannot open file: " << filename << std::endl;
             return false;
         }
-        
+
         data.filename = filename;
+        if (progress) progress->total = FileSize(filename);
+
         std::string line;
+        std::vector<std::string> tokens;
+        Long64_t bytes = 0;
+        int lineNum = 0;
         bool firstLine = true;
-        
+
         while (std::getline(file, line)) {
-            if (line.empty() || line[0] == '#') continue;
-            
-            std::stringstream ss(line);
-            std::vector<std::string> tokens;
-            std::string token;
-            
-            while (std::getline(ss, token, ',')) {
-                // Trim whitespace
-                token.erase(0, token.find_first_not_of(" \t"));
-                token.erase(token.find_last_not_of(" \t") + 1);
-                tokens.push_back(token);
+            bytes += (Long64_t)line.size() + 1;
+            if (progress && (++lineNum % kProgressStride) == 0) {
+                progress->processed = bytes;
+                progress->rows = data.GetNumRows();
+                if (progress->Cancelled()) break;
             }
-            
+
+            if (skipRows > 0) { --skipRows; continue; }
+            if (IsBlank(line) || (autoHeader && line[0] == '#')) continue;
+
+            Tokenize(line, delim, tokens);
             if (tokens.empty()) continue;
-            
-            // First line is typically header in CSV
+
             if (firstLine) {
-                bool isHeader = false;
-                try {
-                    std::stod(tokens[0]);
-                } catch (...) {
-                    isHeader = true;
+                firstLine = false;
+                bool isHeader = useHeader;
+                if (autoHeader) {
+                    try {
+                        std::stod(tokens[0]);
+                        isHeader = false;
+                    } catch (...) {
+                        isHeader = true;
+                    }
                 }
-                
                 if (isHeader) {
                     data.headers = tokens;
                     data.data.resize(tokens.size());
-                    firstLine = false;
                     continue;
                 }
             }
-            
-            // Create default headers if needed
+
+            // No header row: create default headers
             if (data.data.empty()) {
                 data.data.resize(tokens.size());
-                for (size_t i = 0; i < tokens.size(); ++i) {
-                    data.headers.push_back(Form("Col%zu", i));
+                if (data.headers.empty()) {
+                    for (size_t i = 0; i < tokens.size(); ++i) {
+                        data.headers.push_back(Form("Col%zu", i));
+                    }
                 }
             }
-            
-            // Parse data
-            for (size_t i = 0; i < tokens.size() && i < data.data.size(); ++i) {
-                try {
-                    double val = std::stod(tokens[i]);
-                    data.data[i].push_back(val);
-                } catch (...) {
-                    // Skip non-numeric values
-                }
+
+            // Parse data: one value per column and row; empty, non-numeric
+            // and missing trailing fields are nulls, so the row stays aligned
+            for (size_t i = 0; i < data.data.size(); ++i) {
+                double value;
+                if (i < tokens.size() && ParseValue(tokens[i], value))
+                    data.data[i].push_back(value);
+                else
+                    data.AppendNull((int)i);
             }
-            
-            firstLine = false;
         }
-        
+
+        if (progress) {
+            progress->processed = bytes;
+            progress->rows = data.GetNumRows();
+        }
         return !data.data.empty();
     }
+
+    // Read text/dat file (space or tab separated)
+    static bool ReadTextFile(const std::string& filename, ColumnData& data,
+                             ReadProgress* progress = nullptr) {
+        return ReadDelimitedFile(filename, ' ', 0, false, true, data, progress);
+    }
+
+    // Read CSV file (comma separated)
+    static bool ReadCSVFile(const std::string& filename, ColumnData& data,
+                            ReadProgress* progress = nullptr) {
+        return ReadDelimitedFile(filename, ',', 0, false, true, data, progress);
+    }
     
     // Helper function to extract data from TH1
     static bool ExtractFromTH1(TH1* hist, ColumnData& data) {
@@ -369,7 +450,8 @@ public:
     }
     
     // Read ROOT file - enhanced to handle histograms and canvases
-    static bool ReadROOTFile(const std::string& filename, ColumnData& data) {
+    static bool ReadROOTFile(const std::string& filename, ColumnData& data,
+                             ReadProgress* progress = nullptr) {
         TFile* file = TFile::Open(filename.c_str(), "READ");
         if (!file || file->IsZombie()) {
             std::cerr << "Cannot open ROOT file: " << filename << std::endl;
@@ -386,6 +468,16 @@ public:
         std::cout << "=== Scanning ROOT file for objects ===" << std::endl;
         
         while ((key = (TKey*)next())) {
+            // RNTuple anchors are not TObjects: read through RNTupleData
+            if (RNTupleData::IsRNTupleClass(key->GetClassName())) {
+                std::cout << "Found: " << key->GetName() << " (RNTuple)" << std::endl;
+                std::string error;
+                success = RNTupleData::Read(filename, key->GetName(), data, progress, error);
+                if (success) break;
+                std::cerr << error << std::endl;
+                continue;
+            }
+
             TObject* obj = key->ReadObj();
             if (!obj) continue;
             
@@ -414,21 +506,26 @@ public:
             }
             // Finally check for TTree
             else if (obj->InheritsFrom(TTree::Class())) {
-                success = ReadROOTTree((TTree*)obj, data);
+                success = ReadROOTTree((TTree*)obj, data, progress);
                 if (success) break;
             }
         }
         
         if (!success) {
-            std::cerr << "No compatible objects (TH1/TH2/TH3/TCanvas/TTree) found in ROOT file" << std::endl;
+            std::cerr << "No compatible objects (TH1/TH2/TH3/TCanvas/TTree/RNTuple) found in ROOT file" << std::endl;
         }
         
         file->Close();
         return success;
     }
     
-    // Helper function to read TTree (extracted from original ReadROOTFile)
-    static bool ReadROOTTree(TTree* tree, ColumnData& data) {
+    // Helper function to read TTree (extracted from original ReadROOTFile).
+    // One column per branch holding a single value of a basic type (any
+    // width, e.g. the Int_t/Long64_t/Double_t branches CSVConverter
+    // writes); array and object branches are skipped and not read. NaN
+    // values are read as nulls.
+    static bool ReadROOTTree(TTree* tree, ColumnData& data,
+                             ReadProgress* progress = nullptr) {
         if (!tree) return false;
         
         // Get branches
@@ -440,43 +537,91 @@ public:
             return false;
         }
         
-        data.headers.resize(nBranches);
-        data.data.resize(nBranches);
-        
-        std::vector<Double_t> branchValues(nBranches);
-        
+        std::vector<TLeaf*> leaves;
+        tree->SetBranchStatus("*", 0);
         for (int i = 0; i < nBranches; ++i) {
             TBranch* branch = (TBranch*)branches->At(i);
-            data.headers[i] = branch->GetName();
-            tree->SetBranchAddress(branch->GetName(), &branchValues[i]);
+            TLeaf* leaf = IsScalarBranch(branch)
+                ? (TLeaf*)branch->GetListOfLeaves()->At(0) : nullptr;
+            if (!leaf) {
+                std::cout << "  skipping branch " << branch->GetName() << std::endl;
+                continue;
+            }
+            tree->SetBranchStatus(branch->GetName(), 1);
+            data.headers.push_back(branch->GetName());
+            leaves.push_back(leaf);
         }
+        const int nColumns = leaves.size();
+        if (nColumns == 0) {
+            std::cerr << "TTree " << tree->GetName() << " has no scalar branches" << std::endl;
+            tree->SetBranchStatus("*", 1);
+            return false;
+        }
+        data.data.resize(nColumns);
         
         // Read all entries
         Long64_t nEntries = tree->GetEntries();
+        if (progress) progress->total = nEntries;
+        for (int i = 0; i < nColumns; ++i) data.data[i].reserve(nEntries);
         for (Long64_t entry = 0; entry < nEntries; ++entry) {
+            if (progress && (entry % kProgressStride) == 0) {
+                progress->processed = entry;
+                progress->rows = entry;
+                if (progress->Cancelled()) {
+                    nEntries = entry;
+                    break;
+                }
+            }
             tree->GetEntry(entry);
-            for (int i = 0; i < nBranches; ++i) {
-                data.data[i].push_back(branchValues[i]);
+            for (int i = 0; i < nColumns; ++i) {
+                double value = leaves[i]->GetValue(0);
+                if (value == value) data.data[i].push_back(value);
+                else                data.AppendNull(i);   // NaN: a missing value
             }
         }
         
+        if (progress) {
+            progress->processed = nEntries;
+            progress->rows = nEntries;
+        }
+        tree->SetBranchStatus("*", 1);
+
         std::cout << "Extracted TTree: " << tree->GetName() 
-                  << " (" << nBranches << " branches, " << nEntries << " entries)" << std::endl;
+                  << " (" << nColumns << " of " << nBranches << " branches, "
+                  << nEntries << " entries)" << std::endl;
         return true;
     }
+
+    // A branch with one leaf holding one value of a basic type
+    static bool IsScalarBranch(TBranch* branch) {
+        if (!branch || branch->GetListOfBranches()->GetEntries() > 0) return false;
+        if (branch->GetListOfLeaves()->GetEntries() != 1) return false;
+        TLeaf* leaf = (TLeaf*)branch->GetListOfLeaves()->At(0);
+        if (leaf->GetLeafCount() || leaf->GetLenStatic() != 1) return false;
+        static const char* kBasicTypes[] = {
+            "Char_t", "UChar_t", "Short_t", "UShort_t", "Int_t", "UInt_t",
+            "Long_t", "ULong_t", "Long64_t", "ULong64_t", "Float_t", "Float16_t",
+            "Double_t", "Double32_t", "Bool_t"
+        };
+        const std::string type = leaf->GetTypeName();
+        for (const char* t : kBasicTypes)
+            if (type == t) return true;
+        return false;
+    }
     
     // Main read function - auto-detects file type
-    static bool ReadFile(const std::string& filename, ColumnData& data) {
+    static bool ReadFile(const std::string& filename, ColumnData& data,
+                         ReadProgress* progress = nullptr) {
         FileType type = GetFileType(filename);
         
         switch (type) {
             case kCSV:
-                return ReadCSVFile(filename, data);
+                return ReadCSVFile(filename, data, progress);
             case kROOT:
-                return ReadROOTFile(filename, data);
+                return ReadROOTFile(filename, data, progress);
             case kText:
             default:
-                return ReadTextFile(filename, data);
+                return ReadTextFile(filename, data, progress);
         }
     }
 };
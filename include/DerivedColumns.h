@@ -0,0 +1,57 @@
+#ifndef DERIVEDCOLUMNS_H
+#define DERIVEDCOLUMNS_H
+
+#include "DataReader.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// DerivedColumnDef — "name = expression" (see ColumnExpression)
+// ============================================================================
+struct DerivedColumnDef {
+    std::string name;
+    std::string expression;
+};
+
+// ============================================================================
+// DerivedColumns — columns computed from the others, appended to a table
+// after its raw columns. The GUI's definitions live in the process-wide
+// Instance(); batch jobs carry their own list. Definitions are only parsed
+// when made; a table gets its values the next time it is used (Apply),
+// and only the columns it does not have yet are computed. Changing or
+// removing a definition recomputes all derived columns on a copy of the
+// table, so plots still borrowing the old one are unaffected.
+// ============================================================================
+class DerivedColumns {
+private:
+    std::mutex                    fMutex;
+    std::vector<DerivedColumnDef> fDefs;   // in definition order
+
+    DerivedColumns() = default;
+
+public:
+    static DerivedColumns& Instance();
+
+    // Replaces a definition of the same name; false on a syntax error.
+    // Column names are checked when the definition is applied.
+    bool Define(const std::string& name, const std::string& expression, std::string& error);
+    bool Remove(const std::string& name);
+    void Clear();
+    std::vector<DerivedColumnDef> GetDefinitions();
+
+    // Splits "name = expression"; the expression may be empty
+    static bool ParseDefinition(const std::string& text, DerivedColumnDef& def, std::string& error);
+
+    // Brings data's derived columns in line with defs. data is replaced by a
+    // copy when it is shared or its derived columns must be rebuilt. A
+    // definition that cannot be applied (unknown column, name of a raw
+    // column) is skipped with a line in messages. Returns true if data
+    // changed.
+    static bool Apply(const std::vector<DerivedColumnDef>& defs,
+                      std::shared_ptr<ColumnData>& data, std::string& messages);
+};
+
+#endif // DERIVEDCOLUMNS_H
@@ -6,25 +6,76 @@
 #include <TFile.h>
 #include <TString.h>
 #include <TSystem.h>
+#include <TTimer.h>
 #include "DataReader.h"
+#include "ConcurrentQueue.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 class AdvancedPlotGUI;  // Forward declaration
+struct ROOTObjectInfo;
+
+// ============================================================================
+// LoadResult — one message from the loader thread to the GUI thread
+// ============================================================================
+struct LoadResult {
+    enum Kind {
+        kColumnData,   // a (possibly partial) ColumnData table
+        kRootObject,   // one object read from a ROOT file (detached, caller owns)
+        kConverted,    // CSVConverter finished; name = output file
+        kFinished      // loader thread is done; always the last message
+    };
+
+    Kind                        kind = kFinished;
+    std::shared_ptr<ColumnData> data;
+    TObject*                    object = nullptr;
+    std::string                 name;
+    std::string                 category;
+    bool                        ok = true;
+    bool                        partial = false;   // stopped by Cancel
+    std::string                 message;
+};
 
 // ============================================================================
 // FileHandler — manages file browsing and loading
 // Plain C++ class (no TObject inheritance, no ClassDef).
+// Parsing runs on a worker thread; results come back through fLoadQueue,
+// which the GUI thread drains from a TTimer (see PollLoad()).
 // ============================================================================
 class FileHandler {
 private:
-    AdvancedPlotGUI* fMainGUI;
-    TFile*           fCurrentRootFile;
-    ColumnData       fCurrentData;
-    
+    AdvancedPlotGUI*            fMainGUI;
+    TFile*                      fCurrentRootFile;
+    std::shared_ptr<ColumnData> fCurrentData;
+
+    // Background loading
+    std::thread                 fLoadThread;
+    ReadProgress                fProgress;
+    ReadProgress                fEntryProgress;    // RNTuple read within a ROOT-file load
+    ConcurrentQueue<LoadResult> fLoadQueue;
+    TTimer*                     fPollTimer;
+    std::string                 fLoadingPath;
+    Bool_t                      fLoading;
+    Int_t                       fObjectsLoaded;    // -1: loading a table, not objects
+    std::string                 fLoadAfterFinish;   // converted file to open next
+
     // Helper methods for plotting ROOT objects
     void PlotHistogram(TObject* obj, const char* name);
     void PlotGraph(TObject* obj, const char* name);
     void ShowTreeInfo(TObject* obj, const char* name);
 
+    // Background loading helpers
+    void StartLoad(const std::string& path, std::function<void()> job);
+    void FinishLoad();
+    void HandleLoadResult(LoadResult& result);
+    void LoadRootObjects(const std::string& path,
+                         const std::vector<ROOTObjectInfo>& objects);
+    void LoadConvertedFile(const std::string& path);
+
 public:
     FileHandler(AdvancedPlotGUI* mainGUI);
     ~FileHandler();
@@ -34,14 +85,31 @@ public:
     void Load(const std::string& filepath);
     void LoadRootFile(const char* filepath);
     void LoadCSVFile(const char* filepath);
-    void LoadCSVWithSettings(const char* filepath, char delim, 
+    void LoadCSVWithSettings(const char* filepath, char delim,
                              Int_t skipRows, Bool_t useHeader);
 
     void OpenEntrySelector(const char* filepath);
 
-    const ColumnData& GetCurrentData()     const { return fCurrentData;    }
+    // Asks for a delimited text file, its settings and the output, then
+    // writes it to a ROOT file (CSVConverter) on the loader thread
+    void ConvertToROOT();
+
+    // Background loading control (GUI thread)
+    Bool_t IsLoading() const { return fLoading; }
+    void   CancelLoad();
+    void   PollLoad();
+    Bool_t HandleTimer(TTimer* timer);
+
+    // Adds/recomputes the columns of DerivedColumns::Instance(); returns
+    // the problems found (also printed), "" if none
+    std::string UpdateDerivedColumns();
+
+    const ColumnData& GetCurrentData()     const { return *fCurrentData;   }
+    std::shared_ptr<const ColumnData> GetCurrentDataPtr() const { return fCurrentData; }
     TFile*            GetCurrentRootFile() const { return fCurrentRootFile; }
-    void              SetCurrentData(const ColumnData& data) { fCurrentData = data; }
+    void              SetCurrentData(const ColumnData& data) {
+        fCurrentData = std::make_shared<ColumnData>(data);
+    }
 };
 
-#endif // FILEHANDLER_H
\ No newline at end of file
+#endif // FILEHANDLER_H
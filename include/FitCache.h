@@ -0,0 +1,67 @@
+#ifndef FITCACHE_H
+#define FITCACHE_H
+
+#include <TObject.h>
+#include <TString.h>
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ============================================================================
+// CachedFit — everything needed to restore a fit without re-running it
+// ============================================================================
+struct CachedFit {
+    std::vector<std::string> parNames;
+    std::vector<double>      params;
+    std::vector<double>      errors;
+    double                   chi2   = 0.0;
+    int                      ndf    = 0;
+    int                      status = -1;
+    bool                     valid  = false;
+};
+
+// ============================================================================
+// FitCache — fit results keyed on a content hash of the fitted data plus
+// the fit specification (model, formula, minimizer, guess strategy).
+// Process-wide and thread-safe. Entries persist in an append-only text file,
+// $APG_FIT_CACHE or ~/.cache/AdvancedPlotGUI/fitcache.txt; set
+// APG_FIT_CACHE=off to disable the cache.
+// ============================================================================
+class FitCache {
+private:
+    std::mutex                                 fMutex;
+    std::unordered_map<std::string, CachedFit> fEntries;
+    std::deque<std::string>                    fOrder;   // oldest first
+    bool                                       fLoaded  = false;
+    bool                                       fEnabled = true;
+    TString                                    fPath;
+
+    FitCache();
+    void LoadLocked();
+    void InsertLocked(const std::string& key, const CachedFit& fit);
+    void RewriteLocked();
+
+public:
+    static const size_t kMaxEntries = 20000;
+
+    static FitCache& Instance();
+
+    // FNV-1a over the bins (edges, contents, errors) of a TH1 or the
+    // points (and errors) of a TGraph; "" for anything else
+    static std::string HashData(const TObject* obj);
+
+    // Full key for obj fitted with spec; "" when obj cannot be hashed
+    static std::string MakeKey(const TObject* obj, const std::string& spec);
+
+    bool Lookup(const std::string& key, CachedFit& out);
+    void Store(const std::string& key, const CachedFit& fit);
+    void Clear();
+
+    bool    IsEnabled() const { return fEnabled; }
+    TString GetPath()   const { return fPath; }
+};
+
+#endif // FITCACHE_H
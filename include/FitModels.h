@@ -0,0 +1,149 @@
+#ifndef FITMODELS_H
+#define FITMODELS_H
+
+#include <TF1.h>
+#include <Math/IParamFunction.h>
+#include <Math/Types.h>   // ROOT::Double_v, R__HAS_VECCORE
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// FitModel — a compiled fit function: C++ evaluator, parameter names and
+// how to pick starting values from the (x, y) points being fitted. With
+// VecCore, evalVec can give a SIMD version that the fit uses instead of eval,
+// one ROOT::Double_v lane per data point.
+// ============================================================================
+struct FitModel {
+    using Eval  = std::function<double(const double* x, const double* p)>;
+#ifdef R__HAS_VECCORE
+    using EvalVec = std::function<ROOT::Double_v(const ROOT::Double_v* x, const double* p)>;
+#endif
+    using ParGrad = std::function<void(const double* x, const double* p, double* grad)>;
+    using Guess = std::function<void(TF1& f, const std::vector<double>& xs,
+                                     const std::vector<double>& ys)>;
+    using Starts = std::function<std::vector<std::vector<double>>(
+        const std::vector<double>& xs, const std::vector<double>& ys, unsigned n)>;
+
+    std::string              name;         // registry key, e.g. "gaus"
+    std::string              title;        // shown in stats boxes and tables
+    std::string              expression;   // for display only, never compiled
+    std::vector<std::string> parNames;     // also fixes the number of parameters
+    Eval                     eval;
+#ifdef R__HAS_VECCORE
+    EvalVec                  evalVec;      // optional
+#endif
+    ParGrad                  parGrad;      // optional d(eval)/d(p[i]) for all i
+    Guess                    guess;        // optional
+    Starts                   starts;       // optional: up to n starting points, best first
+};
+
+// ============================================================================
+// FitModelFunction — a model with an analytic parameter gradient, as the
+// model function of a ROOT::Fit::Fitter (SetFunction(f, true)). The chi2
+// gradient then costs one pass over the data instead of 2*Npar extra
+// evaluations per point for numerical derivatives.
+// ============================================================================
+class FitModelFunction : public ROOT::Math::IParamMultiGradFunction {
+private:
+    std::shared_ptr<const FitModel> fModel;
+    std::vector<double>             fParams;
+
+    // Last parGrad result and where it was taken: DoParameterDerivative is
+    // asked for one component at a time, at the same point for every ipar.
+    // Per object, so not for concurrent use (each Fitter owns a clone).
+    mutable std::vector<double>     fGrad;
+    mutable std::vector<double>     fGradPar;
+    mutable double                  fGradX = 0;
+    mutable bool                    fGradValid = false;
+
+    double DoEvalPar(const double* x, const double* p) const override;
+    double DoParameterDerivative(const double* x, const double* p, unsigned int ipar) const override;
+    double DoDerivative(const double* x, unsigned int icoord) const;   // d/dx, pure in older ROOT
+
+public:
+    // model must have parGrad; params are the starting values
+    FitModelFunction(std::shared_ptr<const FitModel> model, const double* params);
+
+    ROOT::Math::IBaseFunctionMultiDim* Clone() const override;
+    unsigned int  NDim() const override { return 1; }
+    unsigned int  NPar() const override { return fParams.size(); }
+    const double* Parameters() const override { return fParams.data(); }
+    void          SetParameters(const double* p) override;
+    std::string   ParameterName(unsigned int i) const override;
+    void          ParameterGradient(const double* x, const double* p, double* grad) const override;
+};
+
+// ============================================================================
+// FitModelRegistry — process-wide table of fit models. Each model's TF1 is
+// built once from its evaluator, vectorized when the model has evalVec (no
+// TFormula, no JIT, not in gROOT's list); MakeFunction hands out copies of
+// it. Custom formulas are compiled once per distinct string and copied the
+// same way. Thread-safe.
+//
+//   FitModel m;
+//   m.name     = "lorentz";
+//   m.title    = "Lorentzian";
+//   m.parNames = {"Height", "Peak", "Width"};
+//   m.eval     = [](const double* x, const double* p) {
+//       double d = (x[0] - p[1]) / p[2];
+//       return p[0] / (1 + d * d);
+//   };
+//   FitModelRegistry::Instance().Register(m);
+// ============================================================================
+class FitModelRegistry {
+private:
+    struct Entry {
+        std::shared_ptr<const FitModel> model;
+        std::unique_ptr<TF1>            prototype;
+    };
+
+    mutable std::mutex                          fMutex;
+    std::map<std::string, Entry>                fModels;
+    std::map<std::string, std::unique_ptr<TF1>> fFormulas;   // custom formula -> compiled TF1
+
+    FitModelRegistry();   // registers the built-in models
+
+public:
+    static FitModelRegistry& Instance();
+
+    // Adds or replaces a model; false when it has no name, evaluator or parameters
+    bool Register(const FitModel& model);
+
+    std::shared_ptr<const FitModel> Find(const std::string& name) const;
+    std::vector<std::string>        Names() const;
+
+    // New TF1 over [xmin, xmax] with the model's parameter names; caller owns.
+    // nullptr for an unknown model.
+    TF1* MakeFunction(const std::string& name, const char* fname,
+                      double xmin, double xmax) const;
+
+    // Same for a TFormula expression; nullptr when it does not compile to a
+    // 1-D function with parameters
+    TF1* MakeFormulaFunction(const std::string& formula, const char* fname,
+                             double xmin, double xmax);
+
+    // Runs the model's guess, if it has one, on the points of obj
+    // (TGraph points or 1-D histogram bin centres)
+    static void Guess(const FitModel& model, TF1& f, const TObject* obj);
+
+    // n starting parameter sets for a multi-start fit of obj, the guess
+    // first: the model's own alternatives, topped up with reproducible
+    // random perturbations of the guess
+    static std::vector<std::vector<double>> Starts(const FitModel& model, TF1& f,
+                                                   const TObject* obj, unsigned n);
+
+    // Angular frequencies of the n strongest Lomb-Scargle periodogram peaks
+    // of (xs, ys), strongest first; works on unevenly spaced points
+    static std::vector<double> DominantFrequencies(const std::vector<double>& xs,
+                                                   const std::vector<double>& ys,
+                                                   unsigned n);
+    static void CollectPoints(const TObject* obj, std::vector<double>& xs,
+                              std::vector<double>& ys);
+};
+
+#endif // FITMODELS_H
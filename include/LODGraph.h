@@ -0,0 +1,81 @@
+#ifndef LODGRAPH_H
+#define LODGRAPH_H
+
+#include "DataReader.h"
+
+#include <TGraph.h>
+
+#include <memory>
+#include <vector>
+
+// ============================================================================
+// LODGraph — a TGraph that keeps all its points but paints a level-of-detail
+// series: for every pixel column of the visible x range, the first, last,
+// lowest and highest point in it (min/max "M4" decimation), which draws
+// the same polyline as the full data at that resolution. The visible range
+// is re-decimated on every paint, so zooming in brings back detail down to
+// the raw points. For x sorted ascending a min/max pyramid over blocks of
+// points answers each column in O(log n); unsorted x costs one pass.
+// Everything else — fits, GetX()/GetY(), I/O (as TGraph) — sees the full
+// data. Picking uses the painted points; point editing is off.
+//
+// Built from a shared ColumnData, the graph borrows the x and y columns
+// instead of copying them and keeps the table alive; the first change of a
+// point (SetPoint, Set, InsertPoint, RemovePoint, Apply) copies them into
+// arrays of its own. Do not write through GetX()/GetY() before Materialize().
+// ============================================================================
+class LODGraph : public TGraph {
+private:
+    struct Level {
+        std::vector<int> minIdx;   // per block: index of the lowest y
+        std::vector<int> maxIdx;   // and of the highest
+    };
+
+    std::vector<Level>  fLevels;          // fLevels[k]: blocks of kBlock << k points
+    int                 fIndexedN = -1;   // fNpoints the pyramid was built for
+    bool                fSorted   = false;
+    std::vector<double> fShownX;          // series of the last paint
+    std::vector<double> fShownY;
+    bool                fDecimated = false;
+    std::shared_ptr<const ColumnData> fData;   // set while fX/fY are its columns
+
+    void BuildPyramid();
+    void RangeMinMax(int i0, int i1, int& imin, int& imax) const;
+    void Decimate(double xmin, double xmax, int pixels, bool logx);
+
+public:
+    static const int kBlock     = 64;      // points per level-0 block
+    static const int kMinPoints = 20000;   // below this everything is painted
+
+    LODGraph(Int_t n, const Double_t* x, const Double_t* y);
+    // Borrows the first n values of both columns; data must not be null
+    LODGraph(std::shared_ptr<const ColumnData> data, int xColumn, int yColumn, Int_t n);
+    ~LODGraph() override;
+
+    void  Paint(Option_t* option = "") override;
+    Int_t DistancetoPrimitive(Int_t px, Int_t py) override;
+
+    // Point changes: own copies of the points first
+    void  SetPoint(Int_t i, Double_t x, Double_t y) override;
+    void  Set(Int_t n) override;
+    Int_t InsertPoint() override;
+    using TGraph::RemovePoint;
+    Int_t RemovePoint(Int_t ipoint) override;
+    void  SetPointX(Int_t i, Double_t x) override;
+    void  SetPointY(Int_t i, Double_t y) override;
+    void  Apply(TF1* f) override;
+    void  Scale(Double_t c1 = 1., Option_t* option = "y") override;
+    void  Sort(Bool_t (*greater)(const TGraph*, Int_t, Int_t) = &TGraph::CompareX,
+               Bool_t ascending = kTRUE, Int_t low = 0, Int_t high = -1111) override;
+
+    bool IsBorrowed() const { return fData != nullptr; }
+    void Materialize();
+
+    // Call after changing points through GetX()/GetY()
+    void InvalidateLOD() { fIndexedN = -1; }
+
+    // Points painted last time (all of them when not decimated)
+    Int_t GetNShown() const { return fDecimated ? (Int_t)fShownX.size() : fNpoints; }
+};
+
+#endif // LODGRAPH_H
@@ -0,0 +1,88 @@
+#ifndef MASTERHISTOGRAM_H
+#define MASTERHISTOGRAM_H
+
+#include "DataReader.h"
+
+#include <TH1.h>
+
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// ============================================================================
+// MasterHistogram — one column binned once at high resolution (kBins equal
+// bins over the exact [min, max] of its finite values), with count, sum x
+// and sum x^2 per bin. 1-D histograms of the column whose bin edges fall on
+// master edges are derived from it in O(kBins) instead of refilling from
+// the raw values, with the same contents, entries and statistics; auto
+// ranges are widened onto master edges (AlignRange) so the default plot
+// qualifies unless its bins are too fine. Other binnings are refilled from
+// the values.
+// ============================================================================
+class MasterHistogram {
+private:
+    double              fMin   = 0.0;
+    double              fMax   = 0.0;
+    double              fWidth = 0.0;   // of one master bin
+    std::vector<double> fCount;
+    std::vector<double> fSumX;
+    std::vector<double> fSumX2;
+    double              fNegInf = 0.0;  // -inf values: always underflow
+    double              fPosInf = 0.0;  // +inf values: always overflow
+
+public:
+    static const int kBins = 65536;
+    static constexpr double kMaxWiden = 1.05;   // AlignRange: at most 5% wider
+
+    // false when the column has no finite values
+    bool Build(const ColumnData::Column& values);
+
+    double GetMin() const { return fMin; }
+    double GetMax() const { return fMax; }
+
+    // Whether nbins over [xmin, xmax] can be derived exactly: a whole
+    // number of master bins per target bin, starting on a master edge
+    bool CanDerive(int nbins, double xmin, double xmax) const;
+
+    // Widens [xmin, xmax] to the narrowest nbins bins that CanDerive;
+    // false (range unchanged) if that is more than kMaxWiden times wider
+    bool AlignRange(int nbins, double& xmin, double& xmax) const;
+
+    // Fills h (fresh, uniform bins) from the master: contents, entries, stats
+    void FillHistogram(TH1& h) const;
+};
+
+// ============================================================================
+// MasterHistCache — process-wide MasterHistograms keyed on (ColumnData::uid,
+// column), built on first use and shared; the oldest are dropped beyond
+// kMaxEntries. Thread-safe: concurrent requests for the same column wait
+// for one build, different columns build in parallel.
+// ============================================================================
+class MasterHistCache {
+private:
+    using Key   = std::pair<uint64_t, int>;
+    using Entry = std::shared_future<std::shared_ptr<const MasterHistogram>>;
+
+    std::mutex           fMutex;
+    std::map<Key, Entry> fEntries;
+    std::deque<Key>      fOrder;   // oldest first
+
+    MasterHistCache() = default;
+
+public:
+    static const size_t kMaxEntries = 32;
+
+    static MasterHistCache& Instance();
+
+    // nullptr when the column does not exist or has no finite values
+    std::shared_ptr<const MasterHistogram> Get(const ColumnData& data, int column);
+
+    void Clear();
+};
+
+#endif // MASTERHISTOGRAM_H
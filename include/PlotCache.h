@@ -0,0 +1,62 @@
+#ifndef PLOTCACHE_H
+#define PLOTCACHE_H
+
+#include "PlotTypes.h"
+
+#include <TObject.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+// ============================================================================
+// PlotCache — the filled histograms and graphs of the last Plot run, keyed
+// on the dataset (ColumnData::uid) and the PlotConfig fields that decide
+// the contents. A run asks for every object between BeginPass() and
+// EndPass(); unchanged configs get their object back (fits and styling
+// reset), changed or new ones are built with PlotCreator, and EndPass()
+// deletes whatever the run did not ask for. The cache owns its objects:
+// they are kept out of gDirectory and gROOT's lists, and deleting one
+// removes it from any pad it is drawn on.
+// ============================================================================
+class PlotCache {
+private:
+    struct Entry {
+        std::unique_ptr<TObject> object;
+        bool                     used = false;   // asked for in the current pass
+    };
+
+    std::map<std::string, Entry>        fEntries;
+    std::map<std::string, unsigned>     fOccurrences;   // identical configs this pass
+    uint64_t                            fDataUid = 0;
+    size_t                              fBuilt   = 0;
+    size_t                              fReused  = 0;
+
+    static TObject* Build(const ColumnData& data, const PlotConfig& config);
+    static void     Reset(TObject* obj, const PlotConfig& config);
+
+public:
+    PlotCache() = default;
+    PlotCache(const PlotCache&) = delete;
+    PlotCache& operator=(const PlotCache&) = delete;
+
+    // Content key of config: type, the columns and binning the type uses, titles
+    static std::string MakeKey(const PlotConfig& config);
+
+    void BeginPass(const ColumnData& data);
+
+    // The object for config on data (TGraph, TGraphErrors, TH1, TH2 or TH3
+    // by config.type); nullptr when PlotCreator cannot build it. Owned by
+    // the cache, valid until the EndPass() of a pass that does not ask for it.
+    TObject* Get(const ColumnData& data, const PlotConfig& config);
+
+    void EndPass();
+    void Clear();
+
+    size_t GetSize()   const { return fEntries.size(); }
+    size_t GetBuilt()  const { return fBuilt; }    // this pass
+    size_t GetReused() const { return fReused; }   // this pass
+};
+
+#endif // PLOTCACHE_H
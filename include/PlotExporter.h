@@ -0,0 +1,50 @@
+#ifndef PLOTEXPORTER_H
+#define PLOTEXPORTER_H
+
+#include "BatchEngine.h"
+#include "DataReader.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// PlotExporter — offscreen rendering of many canvases to files.
+// ROOT paints through process-wide state (gVirtualPS, TImageDump), so
+// canvases are rendered concurrently in forked worker processes; each
+// worker inherits the already-read data copy-on-write and reports its
+// results back over a pipe. Used by `--batch` and by the GUI's Export...
+// ============================================================================
+class PlotExporter {
+public:
+    // Returns the data for a BatchJob::input (nullptr = unreadable)
+    using DataLookup = std::function<std::shared_ptr<const ColumnData>(const std::string&)>;
+
+    // Called on the calling thread as jobs complete
+    using Progress = std::function<void(size_t done, size_t total)>;
+
+    // Renders every job; results come back in job order.
+    // nWorkers = 0 renders in this process on nThreads threads.
+    static std::vector<BatchResult> Render(const std::vector<BatchJob>& jobs,
+                                           const DataLookup& lookup,
+                                           unsigned nWorkers, unsigned nThreads = 1,
+                                           const Progress& progress = Progress());
+
+    // Tab-separated list of every expected output: job, status, format,
+    // bytes, seconds, file. Missing outputs are listed with status "missing".
+    static bool WriteManifest(const std::string& path,
+                              const std::vector<BatchJob>& jobs,
+                              const std::vector<BatchResult>& results);
+
+    static unsigned DefaultWorkers();
+
+private:
+    static std::vector<BatchResult> RenderInProcess(const std::vector<BatchJob>& jobs,
+                                                    const std::vector<size_t>& indices,
+                                                    const DataLookup& lookup,
+                                                    unsigned nThreads,
+                                                    const std::function<void(size_t, const BatchResult&)>& done);
+};
+
+#endif // PLOTEXPORTER_H
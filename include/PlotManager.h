@@ -4,17 +4,32 @@
 #include <TCanvas.h>
 #include <TH1.h>
 #include <TObject.h>
+#include <TVirtualPad.h>
+#include <memory>
 #include <vector>
 #include "PlotTypes.h"    // defines PlotConfig and PlotCreator
+#include "PlotCache.h"
 #include "FitUtils.h"
 #include "DataReader.h"
 
 class AdvancedPlotGUI;  // Forward declaration
+class TLegend;
 
 class PlotManager {
 private:
     AdvancedPlotGUI* fMainGUI;
     std::vector<PlotConfig> fPlotConfigs;
+    PlotCache               fPlotCache;   // owns the plotted objects of the last run
+
+    // Fits queued while the canvases are built, then run together
+    // (concurrently) by RunQueuedFits()
+    struct PendingFit {
+        TObject*     object;
+        TVirtualPad* pad;
+        Int_t        color;
+    };
+    std::vector<PendingFit> fPendingFits;
+    static const unsigned kPeriodicFitStarts = 4;   // multi-start for sine-type fits
     
     // Helper methods for different canvas modes
     void CreateDividedCanvas(const std::string& title, FitUtils::FitType fitType, 
@@ -23,10 +38,16 @@ private:
                             const std::string& customFunc, const ColumnData& data);
     void CreateSeparateCanvases(const std::string& title, FitUtils::FitType fitType, 
                                const std::string& customFunc, const ColumnData& data);
+    TObject* DrawPlot(const PlotConfig& config, Bool_t same, FitUtils::FitType fitType,
+                      const std::string& customFunc, const ColumnData& data, TLegend* legend);
     
     void ApplyFit(TObject* obj, FitUtils::FitType type, Int_t color, 
                  const std::string& customFunc);
     void ApplyRooFitGaussian(TH1* hist, Int_t color);
+    void ApplyUnbinnedFit(TH1* hist, const ColumnData& data, const PlotConfig& config,
+                          FitUtils::FitType fitType, const std::string& customFunc);
+    void QueueFit(TObject* obj, FitUtils::FitType type, Int_t color);
+    void RunQueuedFits(FitUtils::FitType type, const std::string& customFunc);
     void PrintCanvasInfo(TCanvas* canvas);
     
 public:
@@ -44,6 +65,13 @@ public:
                     FitUtils::FitType fitType, const std::string& customFunc,
                     const ColumnData& data);
     
+    // Offscreen export of the configured plots to image files, rendered
+    // in parallel worker processes; writes a manifest next to the files
+    void ExportPlots(const std::string& canvasTitle, Bool_t overlayMode,
+                     Bool_t dividedMode, Int_t nRows, Int_t nCols,
+                     FitUtils::FitType fitType, const std::string& customFunc,
+                     std::shared_ptr<const ColumnData> data);
+    
     // Getters
     const std::vector<PlotConfig>& GetPlotConfigs() const { return fPlotConfigs; }
     size_t GetNumPlots() const { return fPlotConfigs.size(); }
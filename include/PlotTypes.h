@@ -8,6 +8,8 @@
 #include <TH1.h>
 #include <TH2.h>
 #include <TH3.h>
+#include <TProfile.h>
+#include <TProfile2D.h>
 #include "DataReader.h"
 
 // ============================================================================
@@ -25,7 +27,10 @@ struct PlotConfig {
         kTH2I,
         kTH3D,   // comma was missing here in the original — now fixed
         kTH3F,
-        kTH3I
+        kTH3I,
+        kTProfile,      // mean of y in bins of x
+        kTProfile2D,    // mean of z in bins of x and y
+        kNumPlotTypes   // keep last; every type above needs a PlotTraits entry
     };
 
     PlotType    type      = kTH1D;
@@ -34,6 +39,7 @@ struct PlotConfig {
     int         zColumn   = 2;
     int         xErrColumn  = -1;   // x error column  (-1 = none)
     int         yErrColumn  = -1;   // y error column  (-1 = none)
+    int         weightColumn = -1;  // histogram/profile weights (-1 = none)
     int         bins      = 100;
     int         binsY     = 100;
     int         binsZ     = 100;
@@ -48,48 +54,61 @@ struct PlotConfig {
     std::string xTitle    = "";
     std::string yTitle    = "";
     std::string zTitle    = "";
+    std::string cut       = "";   // rows to use, e.g. "pt > 20 && abs(eta) < 2.4" ("" = all)
 
     // Human-readable label used in the plot list box
-    std::string GetDescription() const {
-        const char* typeNames[] = {
-            "TGraph", "TGraphErrors",
-            "TH1D", "TH1F", "TH1I",
-            "TH2D", "TH2F", "TH2I",
-            "TH3D", "TH3F", "TH3I"
-        };
-        std::string desc = typeNames[type];
-        desc += " col[" + std::to_string(xColumn) + "]";
-        if (type == kTGraph || type == kTGraphErrors ||
-            type == kTH2D   || type == kTH2F || type == kTH2I ||
-            type == kTH3D   || type == kTH3F || type == kTH3I) {
-            desc += " vs col[" + std::to_string(yColumn) + "]";
-        }
-        return desc;
-    }
+    std::string GetDescription() const;
+};
+
+// ============================================================================
+// PlotTypeInfo — what callers need to know about a PlotType without
+// switching on it. The table of them is generated at compile time from the
+// PlotTraits specializations in PlotTypes.cpp, one per type.
+// ============================================================================
+struct PlotTypeInfo {
+    enum Family { kGraph, kGraphErrors, kHist1D, kHist2D, kHist3D, kProfile1D, kProfile2D };
+
+    const char* name;           // "TH2F"
+    Family      family;
+    int         dimension;      // columns plotted: x, x/y or x/y/z
+    const char* drawOption;     // first object on a pad
+    const char* sameOption;     // over another object; nullptr: cannot overlay
+    const char* legendOption;   // nullptr: no legend entry
+    TObject*  (*create)(const ColumnData& data, const PlotConfig& cfg);
 };
 
 // ============================================================================
 // PlotCreator — factory functions that build ROOT objects from ColumnData.
-// Declarations only; implementations live in PlotTypes.cpp (or wherever your
-// repo currently defines them).
+// Create() builds any type through the table; the typed functions below are
+// thin wrappers over the same templated fill paths.
 // ============================================================================
 namespace PlotCreator {
 
-    // 1-D histograms
+    const PlotTypeInfo& GetTypeInfo(PlotConfig::PlotType type);   // type < kNumPlotTypes
+    bool                FindType(const std::string& name, PlotConfig::PlotType& type);   // any case
+    TObject*            Create(const ColumnData& data, const PlotConfig& cfg);
+
+    // 1-D histograms (CreateTH1 picks the storage type from cfg.type)
     TH1*          CreateTH1  (const ColumnData& data, const PlotConfig& cfg);
     TH1D*         CreateTH1D (const ColumnData& data, const PlotConfig& cfg);
     TH1F*         CreateTH1F (const ColumnData& data, const PlotConfig& cfg);
     TH1I*         CreateTH1I (const ColumnData& data, const PlotConfig& cfg);
 
-    // 2-D histograms
+    // 2-D histograms (CreateTH2 picks the storage type from cfg.type)
     TH2*          CreateTH2  (const ColumnData& data, const PlotConfig& cfg);
     TH2D*         CreateTH2D (const ColumnData& data, const PlotConfig& cfg);
     TH2F*         CreateTH2F (const ColumnData& data, const PlotConfig& cfg);
+    TH2I*         CreateTH2I (const ColumnData& data, const PlotConfig& cfg);
 
-    // 3-D histograms
+    // 3-D histograms (likewise)
     TH3*          CreateTH3  (const ColumnData& data, const PlotConfig& cfg);
     TH3D*         CreateTH3D (const ColumnData& data, const PlotConfig& cfg);
     TH3F*         CreateTH3F (const ColumnData& data, const PlotConfig& cfg);
+    TH3I*         CreateTH3I (const ColumnData& data, const PlotConfig& cfg);
+
+    // Profiles
+    TProfile*     CreateTProfile   (const ColumnData& data, const PlotConfig& cfg);
+    TProfile2D*   CreateTProfile2D (const ColumnData& data, const PlotConfig& cfg);
 
     // Graphs
     TGraph*       CreateTGraph       (const ColumnData& data, const PlotConfig& cfg);
@@ -0,0 +1,29 @@
+#ifndef RNTUPLECOMPAT_H
+#define RNTUPLECOMPAT_H
+
+// ============================================================================
+// RNTuple across ROOT versions. Defined only when the build found the
+// ROOTNTuple library (APG_HAVE_RNTUPLE, see CMakeLists.txt): the classes
+// lived in ROOT::Experimental until 6.36 and the reader/writer had their
+// own headers from 6.32. Code using them goes through RNTupleAPI::.
+// ============================================================================
+#ifdef APG_HAVE_RNTUPLE
+
+#include <RVersion.h>
+#include <ROOT/RNTupleModel.hxx>
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 32, 0)
+#include <ROOT/RNTupleReader.hxx>
+#include <ROOT/RNTupleWriter.hxx>
+#else
+#include <ROOT/RNTuple.hxx>
+#endif
+
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 36, 0)
+namespace RNTupleAPI = ROOT;
+#else
+namespace RNTupleAPI = ROOT::Experimental;
+#endif
+
+#endif // APG_HAVE_RNTUPLE
+
+#endif // RNTUPLECOMPAT_H
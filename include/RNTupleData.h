@@ -0,0 +1,44 @@
+#ifndef RNTUPLEDATA_H
+#define RNTUPLEDATA_H
+
+#include <Rtypes.h>
+
+#include <string>
+#include <vector>
+
+struct ColumnData;
+struct ReadProgress;
+
+// ============================================================================
+// RNTupleData — RNTuple datasets in ROOT files, read column by column.
+// Needs a build with RNTuple (APG_HAVE_RNTUPLE, ROOT 6.28+); without it
+// datasets are still recognised by their key's class name so callers can
+// tell the user why they cannot be opened.
+// ============================================================================
+class RNTupleData {
+public:
+    struct FieldInfo {
+        std::string name;
+        std::string type;      // as stored, e.g. "std::int32_t", "double"
+        bool        numeric;   // scalar of a basic type: becomes a column
+    };
+
+    static bool Available();
+
+    // Class name of an RNTuple's key (it is not a TObject: never ReadObj it)
+    static bool IsRNTupleClass(const std::string& className);
+
+    // Top-level fields and entry count, without reading any values
+    static bool Describe(const std::string& path, const std::string& ntuple,
+                         std::vector<FieldInfo>& fields, Long64_t& entries,
+                         std::string& error);
+
+    // One column per numeric top-level field. The fields are read in
+    // parallel, each through a typed view on its own reader. progress
+    // counts field values; a cancel keeps the entries all fields reached.
+    // NaN values are read as nulls.
+    static bool Read(const std::string& path, const std::string& ntuple,
+                     ColumnData& data, ReadProgress* progress, std::string& error);
+};
+
+#endif // RNTUPLEDATA_H
@@ -22,8 +22,8 @@ struct ROOTObjectInfo {
     std::string name;
     std::string title;
     std::string type;      // "TH1F", "TGraph", "TTree", etc.
-    std::string category;  // "Histogram", "Graph", "Tree"
-    TObject* object;       // Pointer to the actual object
+    std::string category;  // "Histogram", "Graph", "Tree", "RNTuple"
+    TObject* object;       // Pointer to the actual object (null for RNTuples)
     bool selected;
     
     ROOTObjectInfo() : object(nullptr), selected(false) {}
@@ -70,7 +70,7 @@ private:
     // Helper methods
     void BuildGUI();
     void ScanFile();
-    void AddObjectToTree(const ROOTObjectInfo& obj, TGListTreeItem* parent);
+    TGListTreeItem* AddObjectToTree(const ROOTObjectInfo& obj, TGListTreeItem* parent);
     std::string GetObjectCategory(const char* className);
     
     // NEW: Plotting methods
@@ -0,0 +1,82 @@
+#ifndef ROOFITBACKEND_H
+#define ROOFITBACKEND_H
+
+#include <TH1.h>
+
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+class RooWorkspace;
+
+// ============================================================================
+// RooFitGaussResult — outcome of a RooFit Gaussian fit
+// ============================================================================
+struct RooFitGaussResult {
+    double      mean       = 0.0;
+    double      meanError  = 0.0;
+    double      sigma      = 0.0;
+    double      sigmaError = 0.0;
+    double      minNll     = 0.0;     // -log L at the minimum
+    double      edm        = 0.0;
+    int         status     = -1;      // Minuit status, 0 = converged
+    int         covQual    = -1;      // 3 = full, accurate covariance
+    bool        valid      = false;
+    bool        cached     = false;   // restored from FitCache, not refitted
+    bool        seeded     = false;   // started from the previous fit of this shape
+    double      seconds    = 0.0;
+    std::string message;
+};
+
+// ============================================================================
+// RooFitBackend — owns the RooFit objects behind Gaussian histogram fits.
+// One RooWorkspace (x, mean, sigma, gauss) per histogram shape (bin count
+// and range) is built once and reused; a fit only wraps the histogram in a
+// RooDataHist. The previous fit of a shape seeds the next one when it is
+// close to the new histogram's moments. Likelihood evaluation uses RooFit's
+// vectorized CPU backend where the ROOT version has one, NumCPU otherwise.
+// Results go through FitCache. RooFit is not thread-safe: all calls are
+// serialised on the backend's mutex.
+// ============================================================================
+class RooFitBackend {
+private:
+    using Shape = std::tuple<int, double, double>;   // nbins, xmin, xmax
+
+    struct Workspace {
+        std::unique_ptr<RooWorkspace> ws;
+        bool                          fitted    = false;
+        double                        lastMean  = 0.0;
+        double                        lastSigma = 0.0;
+        unsigned long                 lastUse   = 0;
+    };
+
+    std::mutex                   fMutex;
+    std::map<Shape, Workspace>   fWorkspaces;
+    unsigned long                fTick = 0;
+
+    RooFitBackend() = default;
+    Workspace& GetLocked(const TH1* hist);
+
+public:
+    static const size_t kMaxWorkspaces = 64;
+
+    static RooFitBackend& Instance();
+
+    // Binned maximum-likelihood Gaussian fit of a 1-D histogram over its
+    // full axis range
+    RooFitGaussResult FitGaussian(const TH1* hist);
+
+    // Draws the histogram's data points and the fitted Gaussian onto the
+    // current pad ("same"); the pad owns the RooPlot
+    void DrawGaussian(const TH1* hist, const RooFitGaussResult& result, int color);
+
+    static void Print(const RooFitGaussResult& result, std::ostream& os);
+
+    void   Clear();
+    size_t GetNumWorkspaces();
+};
+
+#endif // ROOFITBACKEND_H
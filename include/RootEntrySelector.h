@@ -12,7 +12,10 @@
 #include <TTree.h>
 #include <TH1.h>
 #include <TCanvas.h>
+#include "DataReader.h"
 
+#include <map>
+#include <memory>
 #include <vector>
 #include <string>
 #include <cstdio>
@@ -75,6 +78,9 @@ private:
     TH1*                      fCurrentHist;
     std::vector<std::string>  fObjectList;
     std::vector<SelectionStep> fSelectionChain;
+    // RNTuples of the file, read into a table on first use; their
+    // selections go through CutCache instead of TTree::Draw
+    std::map<std::string, std::shared_ptr<ColumnData>> fNTuples;
     
     // GUI Components
     TGComboBox*      fObjectCombo;
@@ -114,6 +120,16 @@ private:
     TCanvas* PlotTree(const SelectionStep& step);
     TCanvas* PlotWithChain(const std::vector<SelectionStep>& chain);
     std::string BuildCumulativeCut() const;
+
+    // RNTuple helpers
+    bool IsNTuple(const std::string& name) const { return fNTuples.count(name) > 0; }
+    std::shared_ptr<ColumnData> GetNTupleTable(const std::string& name);
+    void UpdateNTupleInfo(const std::string& name);
+    SelectionStep StepFromGUI(const std::string& objName, const char* objType) const;
+    void AppendStep(const SelectionStep& step);
+    bool AddNTupleStep(const std::string& name);
+    TCanvas* PlotNTuple(const SelectionStep& step);
+    bool DrawNTuple(const SelectionStep& step, const std::string& cut);
     
 public:
     RootEntrySelector(const TGWindow* p, const char* filename);
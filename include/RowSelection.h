@@ -0,0 +1,122 @@
+#ifndef ROWSELECTION_H
+#define ROWSELECTION_H
+
+#include "DataReader.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// RowSelection — one bit per row of a table: the rows a cut accepts.
+// 8M rows take 1 MB; AND/OR/NOT work 64 rows per instruction and the set
+// rows are visited by skipping whole empty words.
+// ============================================================================
+class RowSelection {
+private:
+    std::vector<uint64_t> fWords;
+    size_t                fRows = 0;
+
+    void ClearTail();   // bits past fRows stay 0
+
+public:
+    RowSelection() = default;
+    explicit RowSelection(size_t rows, bool all = false);
+
+    size_t GetRows() const { return fRows; }
+    bool   Test(size_t row) const { return (fWords[row >> 6] >> (row & 63)) & 1; }
+    void   Set(size_t row)        { fWords[row >> 6] |= uint64_t(1) << (row & 63); }
+    size_t Count() const;
+
+    uint64_t*       Words()       { return fWords.data(); }
+    const uint64_t* Words() const { return fWords.data(); }
+    size_t          NumWords() const { return fWords.size(); }
+
+    // Rows past the shorter selection count as unselected
+    RowSelection& operator&=(const RowSelection& other);
+    RowSelection& operator|=(const RowSelection& other);
+    void          Invert();
+
+    // Drops the null rows of a column (same bit layout, rows past the
+    // bitmap's words are valid)
+    RowSelection& operator&=(const ValidityBitmap& valid);
+
+    // f(row) for every selected row below limit, ascending
+    template <class F>
+    void ForEach(size_t limit, F&& f) const {
+        size_t nWords = std::min(fWords.size(), (limit + 63) >> 6);
+        for (size_t w = 0; w < nWords; ++w) {
+            uint64_t bits = fWords[w];
+            while (bits) {
+                size_t row = (w << 6) + CountTrailingZeros(bits);
+                if (row >= limit) return;
+                f(row);
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    static int CountTrailingZeros(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(x);
+#else
+        int n = 0;
+        while (!(x & 1)) { x >>= 1; ++n; }
+        return n;
+#endif
+    }
+};
+
+// sel (nullptr = all rows) without the rows where one of columns is null:
+// sel itself when none of them has nulls, a new selection otherwise.
+// Negative column indices are ignored.
+std::shared_ptr<const RowSelection> DropNulls(std::shared_ptr<const RowSelection> sel,
+                                              const ColumnData& data,
+                                              std::initializer_list<int> columns);
+
+// ============================================================================
+// CutCache — the RowSelection of a cut on a table, e.g.
+// "pt > 20 && abs(eta) < 2.4 || flag == 1". The cut is split at its top-level
+// || and && into terms; each term is evaluated (ColumnExpression::Select)
+// and cached on its own, keyed on the table's uid and the term's text, and
+// the cut is their word-wise AND/OR. Editing one term of a cut therefore
+// re-evaluates only that term. Process-wide and thread-safe; a term being
+// evaluated by one thread is waited for, not evaluated twice.
+// ============================================================================
+class CutCache {
+private:
+    using Key   = std::pair<uint64_t, std::string>;
+    using Entry = std::shared_future<std::shared_ptr<const RowSelection>>;
+
+    std::mutex           fMutex;
+    std::map<Key, Entry> fEntries;
+    std::deque<Key>      fOrder;   // oldest first
+
+    CutCache() = default;
+
+    std::shared_ptr<const RowSelection> GetTerm(const ColumnData& data, const std::string& term,
+                                                std::string& error);
+
+public:
+    static const size_t kMaxEntries = 64;
+
+    static CutCache& Instance();
+
+    // nullptr with a message on a bad cut; an empty cut selects every row
+    std::shared_ptr<const RowSelection> Get(const ColumnData& data, const std::string& cut,
+                                            std::string& error);
+
+    // The cut's top-level || groups of && terms, trimmed
+    static std::vector<std::vector<std::string>> SplitTerms(const std::string& cut);
+
+    void Clear();
+};
+
+#endif // ROWSELECTION_H
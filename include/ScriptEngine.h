@@ -4,7 +4,18 @@
 #include <TGTextEdit.h>
 #include <TGTextView.h>
 #include <TGTextEntry.h>
+#include <TTimer.h>
+#include <TString.h>
+#include "ConcurrentQueue.h"
+
+#include <atomic>
+#include <chrono>
 #include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/types.h>
 
 class AdvancedPlotGUI;
 
@@ -18,11 +29,47 @@ private:
     std::streambuf*     fOldCout;
     std::streambuf*     fOldCerr;
 
+    // Script execution in a child process; its output is streamed by a
+    // reader thread and drained on the GUI thread by fPollTimer
+    std::thread                  fReaderThread;
+    ConcurrentQueue<std::string> fOutputQueue;   // captured lines, in order
+    std::atomic<bool>            fRunning;
+    std::atomic<bool>            fReaderDone;
+    pid_t                        fChildPid;      // -1 once reaped
+    pid_t                        fChildGroup;    // its process group, for Interrupt
+    int                          fChildStatus;   // from waitpid(), once reaped
+    TTimer*                      fPollTimer;
+    std::chrono::steady_clock::time_point fStartTime;
+    Int_t                        fLanguage;
+    TString                      fProgram;       // what was started, for messages
+    std::vector<TString>         fTmpFiles;      // removed when the script ends
+    TString                      fCanvasFile;    // canvases the script left behind
+    Int_t                        fInterrupts;    // Interrupt presses this run
+
+    // Compiled (ACLiC) mode: the cached macro and hash of the run in progress
+    TString                      fCompileMacro;
+    std::string                  fCompileHash;
+
+    // Read ends of the child's stdout/stderr
+    int fOutPipe[2];
+    int fErrPipe[2];
+
     void RedirectStreams();
     void RestoreStreams();
     void FlushStreams();                    // legacy – forwards to widget version
     void FlushStreams(TGTextView* output);  // preferred
 
+    Bool_t StartChild(const std::vector<std::string>& args);
+    void   ReadCapturedOutput();            // reader thread body
+    void   FinishScript();
+    void   ShowScriptCanvases();
+
+    // Compiled (ACLiC) mode helpers
+    bool PrepareCompiledScript(const TString& code, TGTextView* output);
+    static std::string HashScript(const TString& code);
+    static bool DefinesFunction(const TString& code, const std::string& name);
+    void SetEntryFromFile(const char* path);
+
 public:
     ScriptEngine(AdvancedPlotGUI* mainGUI);
     virtual ~ScriptEngine();
@@ -34,6 +81,18 @@ public:
     void SaveScript();
     void ClearEditor();
     void ClearOutput();
+
+    // Directory holding compiled macros; $APG_ACLIC_CACHE overrides
+    static TString CompiledCacheDir();
+    // Programs that run scripts: ROOT's root, and $APG_PYTHON or python3
+    static TString RootExecutable();
+    static TString PythonExecutable();
+
+    // Execution control (GUI thread)
+    Bool_t IsRunning() const { return fRunning; }
+    void   Interrupt();
+    void   PollScript();
+    Bool_t HandleTimer(TTimer* timer);
 };
 
-#endif // SCRIPTENGINE_H
\ No newline at end of file
+#endif // SCRIPTENGINE_H
@@ -0,0 +1,81 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// ============================================================================
+// ThreadPool — fixed set of worker threads consuming a task queue.
+// Submit() returns a std::future for the task's result; the destructor
+// finishes the queued work and joins the workers.
+// Call ROOT::EnableThreadSafety() before creating a pool that touches ROOT.
+// ============================================================================
+class ThreadPool {
+private:
+    std::vector<std::thread>          fWorkers;
+    std::queue<std::function<void()>> fTasks;
+    std::mutex                        fMutex;
+    std::condition_variable           fCondition;
+    bool                              fStopping = false;
+
+public:
+    explicit ThreadPool(unsigned nThreads = 0) {
+        if (nThreads == 0) nThreads = DefaultSize();
+        for (unsigned i = 0; i < nThreads; ++i) {
+            fWorkers.emplace_back([this]() {
+                for (;;) {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> lock(fMutex);
+                        fCondition.wait(lock, [this]() { return fStopping || !fTasks.empty(); });
+                        if (fStopping && fTasks.empty()) return;
+                        task = std::move(fTasks.front());
+                        fTasks.pop();
+                    }
+                    task();
+                }
+            });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            fStopping = true;
+        }
+        fCondition.notify_all();
+        for (auto& w : fWorkers) w.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template <typename F>
+    auto Submit(F&& f) -> std::future<typename std::result_of<F()>::type> {
+        using R = typename std::result_of<F()>::type;
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+        std::future<R> result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            fTasks.emplace([task]() { (*task)(); });
+        }
+        fCondition.notify_one();
+        return result;
+    }
+
+    size_t Size() const { return fWorkers.size(); }
+
+    static unsigned DefaultSize() {
+        unsigned n = std::thread::hardware_concurrency();
+        return n > 0 ? n : 2;
+    }
+};
+
+#endif // THREADPOOL_H
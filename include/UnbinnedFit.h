@@ -0,0 +1,74 @@
+#ifndef UNBINNEDFIT_H
+#define UNBINNEDFIT_H
+
+#include "DataReader.h"
+#include "FitUtils.h"
+
+#include <TF1.h>
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// UnbinnedSpec — model and range of an unbinned maximum-likelihood fit
+// ============================================================================
+struct UnbinnedSpec {
+    FitUtils::FitType type = FitUtils::kGaus;
+    std::string       formula;            // kCustom only
+    std::string       model;              // registry name; overrides type
+    double            xMin = 0.0;         // fit range; xMin >= xMax = data range
+    double            xMax = 0.0;
+    unsigned          nThreads = 0;       // 0 = one per core
+
+    std::string ModelName() const {
+        if (!model.empty()) return model;
+        return type == FitUtils::kCustom ? "" : FitUtils::GetFitFunctions().at(type).first;
+    }
+};
+
+// ============================================================================
+// UnbinnedResult
+// ============================================================================
+struct UnbinnedResult {
+    std::string              model;
+    std::vector<std::string> parNames;
+    std::vector<double>      params;
+    std::vector<double>      errors;
+    std::vector<bool>        fixed;         // flat directions of -log L (normalisation)
+    double                   xMin    = 0.0;
+    double                   xMax    = 0.0;
+    double                   nll     = 0.0; // -log L at the minimum
+    long long                nEvents = 0;   // values inside [xMin, xMax]
+    int                      status  = -1;
+    bool                     valid   = false;
+    unsigned                 nThreads = 1;
+    double                   seconds = 0.0;
+    std::string              message;
+};
+
+// ============================================================================
+// UnbinnedFit — fits a model as a probability density directly to the raw
+// values of a column, no histogram in between. The model (Gaussian, any
+// FitModelRegistry model or a custom formula) is normalised over the fit
+// range: analytically for the Gaussian, numerically otherwise. Parameters
+// the normalised density does not depend on (an amplitude, or an overall
+// scale shared by several parameters) are fixed. -log L is summed over
+// chunks of the column on a ThreadPool, reading the values in place, and
+// minimised with Minuit2; starting values come from a quick binned fit.
+// ============================================================================
+class UnbinnedFit {
+public:
+    static UnbinnedResult Fit(const ColumnData::Column& values, const UnbinnedSpec& spec);
+    // The column's non-null values
+    static UnbinnedResult Fit(const ColumnData& data, int column, const UnbinnedSpec& spec);
+
+    // The fitted density scaled to a histogram of the same values with bins
+    // of binWidth (nEvents * binWidth * pdf), for drawing; caller owns
+    static TF1* MakeCurve(const UnbinnedResult& result, const UnbinnedSpec& spec,
+                          double binWidth, const char* name);
+
+    static void Print(const UnbinnedResult& result, std::ostream& os);
+};
+
+#endif // UNBINNEDFIT_H
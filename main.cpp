@@ -1,5 +1,6 @@
 #include <TRint.h>
 #include "AdvancedPlotGUI.h"
+#include "BatchEngine.h"
 #include "DataReader.h"
 #include "PlotTypes.h"
 #include "FitUtils.h"
@@ -14,28 +15,10 @@
 int main(int argc, char** argv)
 {
     // -----------------------
-    // Batch mode
+    // Batch mode (headless; see BatchEngine.h for the job file format)
     // -----------------------
-    if (argc >= 3 && std::string(argv[1]) == "--batch") {
-        ColumnData data;
-        if (!DataReader::ReadFile(argv[2], data)) {
-            std::cerr << "Failed to read file\n";
-            return 1;
-        }
-
-        PlotConfig cfg;
-        cfg.type = PlotConfig::kTH1D;
-        cfg.xColumn = 0;
-        cfg.bins = 100;
-
-        TCanvas c("batch", "Batch Plot", 800, 600);
-        TH1* h = PlotCreator::CreateTH1D(data, cfg);
-        if (h) {
-            h->Draw();
-            c.SaveAs("batch_output.png");
-            c.SaveAs("batch_output.pdf");
-        }
-        return 0;
+    if (argc >= 2 && std::string(argv[1]) == "--batch") {
+        return BatchEngine::Main(argc, argv);
     }
 
     // -----------------------
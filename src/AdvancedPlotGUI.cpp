@@ -4,6 +4,7 @@
 #include "FitUtils.h"
 #include "ErrorHandling.h"
 #include "FileHandler.h"
+#include "DerivedColumns.h"
 
 #include <TGClient.h>
 #include <TGButton.h>
@@ -19,7 +20,10 @@
 #include <TGTextBuffer.h>
 #include <TGFrame.h>
 #include <TGDNDManager.h>
+#include <TGProgressBar.h>
+#include <TGInputDialog.h>
 #include <TVirtualX.h>
+#include <TTimer.h>
 
 #include <TApplication.h>
 #include <TSystem.h>
@@ -41,10 +45,25 @@ ClassImp(AdvancedPlotGUI);
 AdvancedPlotGUI::AdvancedPlotGUI(const TGWindow* p, UInt_t w, UInt_t h) 
     : TGMainFrame(p, w, h),
       fMainFrame(this),
+      fDefineColumnButton(nullptr),
+      fExportButton(nullptr),
+      fUnbinnedCheck(nullptr),
+      fConvertButton(nullptr),
+      fLoadProgressBar(nullptr),
+      fLoadStatusLabel(nullptr),
+      fCancelLoadButton(nullptr),
+      fCompiledScriptCheck(nullptr),
+      fScriptEntryPoint(nullptr),
+      fRunScriptButton(nullptr),
+      fInterruptButton(nullptr),
+      fScriptStatusLabel(nullptr),
       fFileHandler(nullptr),
       fPlotManager(nullptr),
       fScriptEngine(nullptr)
 {
+    // File loading runs on a worker thread; ROOT must know before it starts
+    ROOT::EnableThreadSafety();
+
     // CRITICAL: Enable DND for ROOT objects
     SetDNDTarget(kTRUE);
     
@@ -123,7 +142,31 @@ void AdvancedPlotGUI::BuildFileSection()
     fEntrySelectorButton->SetToolTipText("Open advanced entry/cut selector for ROOT files");
     fileFrame->AddFrame(fEntrySelectorButton,new TGLayoutHints(kLHintsLeft, 5, 5, 2, 2));
 
+    fConvertButton = new TGTextButton(fileFrame, "Convert to ROOT...", kConvertButton);
+    fConvertButton->Associate(this);
+    fConvertButton->SetToolTipText("Write a CSV/text file to a compressed ROOT file (TTree or RNTuple) for faster reloading");
+    fileFrame->AddFrame(fConvertButton, new TGLayoutHints(kLHintsLeft, 5, 5, 2, 2));
+
     fileGroup->AddFrame(fileFrame, new TGLayoutHints(kLHintsExpandX, 5,5,5,5));
+
+    // Background load progress + cancel
+    TGHorizontalFrame* loadFrame = new TGHorizontalFrame(fileGroup);
+    fLoadProgressBar = new TGHProgressBar(loadFrame, TGProgressBar::kFancy, 200);
+    fLoadProgressBar->SetBarColor("green");
+    fLoadProgressBar->ShowPosition(kTRUE, kFALSE, "%.0f%%");
+    loadFrame->AddFrame(fLoadProgressBar, new TGLayoutHints(kLHintsLeft | kLHintsExpandX | kLHintsCenterY, 5,5,2,2));
+
+    fLoadStatusLabel = new TGLabel(loadFrame, "Idle");
+    fLoadStatusLabel->SetTextJustify(kTextLeft);
+    loadFrame->AddFrame(fLoadStatusLabel, new TGLayoutHints(kLHintsLeft | kLHintsCenterY, 5,5,2,2));
+
+    fCancelLoadButton = new TGTextButton(loadFrame, "Cancel", kCancelLoadButton);
+    fCancelLoadButton->Associate(this);
+    fCancelLoadButton->SetToolTipText("Stop loading; rows read so far are kept");
+    fCancelLoadButton->SetEnabled(kFALSE);
+    loadFrame->AddFrame(fCancelLoadButton, new TGLayoutHints(kLHintsLeft, 5,5,2,2));
+
+    fileGroup->AddFrame(loadFrame, new TGLayoutHints(kLHintsExpandX, 5,5,0,2));
     
     // Add drag-and-drop instruction label
     TGLabel* dndLabel = new TGLabel(fileGroup, 
@@ -142,10 +185,19 @@ void AdvancedPlotGUI::BuildPlotConfigSection()
 {
     TGGroupFrame* plotGroup = new TGGroupFrame(this, "Plot Configuration");
     
-    fAddPlotButton = new TGTextButton(plotGroup, "Add Plot...", kAddPlotButton);
+    TGHorizontalFrame* addFrame = new TGHorizontalFrame(plotGroup);
+    fAddPlotButton = new TGTextButton(addFrame, "Add Plot...", kAddPlotButton);
     fAddPlotButton->Associate(this);
-    plotGroup->AddFrame(fAddPlotButton, new TGLayoutHints(kLHintsCenterX, 5,5,5,5));
+    addFrame->AddFrame(fAddPlotButton, new TGLayoutHints(kLHintsCenterX, 5,5,2,2));
     fAddPlotButton->SetEnabled(false);
+
+    // New columns computed from the loaded ones, e.g. pt = sqrt(px^2 + py^2)
+    fDefineColumnButton = new TGTextButton(addFrame, "Define Column...", kDefineColumnButton);
+    fDefineColumnButton->Associate(this);
+    fDefineColumnButton->SetToolTipText("Add a column computed from the others: name = expression");
+    addFrame->AddFrame(fDefineColumnButton, new TGLayoutHints(kLHintsCenterX, 5,5,2,2));
+    fDefineColumnButton->SetEnabled(false);
+    plotGroup->AddFrame(addFrame, new TGLayoutHints(kLHintsCenterX, 5,5,5,5));
     
     fPlotListBox = new TGListBox(plotGroup);
     fPlotListBox->Resize(100, 100);
@@ -225,6 +277,12 @@ void AdvancedPlotGUI::BuildFitSection()
     fFitFunctionCombo->Resize(150, 20);
     fitFrame->AddFrame(fFitFunctionCombo, new TGLayoutHints(kLHintsLeft, 5,5,2,2));
 
+    // Gaussian/custom fits of 1-D histograms use the raw column values
+    fUnbinnedCheck = new TGCheckButton(fitFrame, "Unbinned");
+    fUnbinnedCheck->SetToolTipText("Maximum-likelihood fit to the raw column values "
+                                   "(Gaussian and custom fits of unweighted 1-D histograms)");
+    fitFrame->AddFrame(fUnbinnedCheck, new TGLayoutHints(kLHintsLeft | kLHintsCenterY, 5,5,2,2));
+
     fitFrame->AddFrame(new TGLabel(fitFrame, "Custom Fit:"), 
         new TGLayoutHints(kLHintsLeft | kLHintsCenterY, 5,5,2,2));
     fCustomFuncEntry = new TGTextEntry(fitFrame);
@@ -234,10 +292,19 @@ void AdvancedPlotGUI::BuildFitSection()
 
     AddFrame(fitFrame, new TGLayoutHints(kLHintsExpandX, 5,5,5,5));
 
-    fPlotButton = new TGTextButton(this, "Create Plots", kPlotButton);
+    TGHorizontalFrame* plotButtonFrame = new TGHorizontalFrame(this);
+    fPlotButton = new TGTextButton(plotButtonFrame, "Create Plots", kPlotButton);
     fPlotButton->Associate(this);
-    AddFrame(fPlotButton, new TGLayoutHints(kLHintsCenterX, 5,5,10,10));
+    plotButtonFrame->AddFrame(fPlotButton, new TGLayoutHints(kLHintsLeft, 5,5,2,2));
     fPlotButton->SetEnabled(false);
+
+    // Renders the same plots straight to files, without opening canvases
+    fExportButton = new TGTextButton(plotButtonFrame, "Export...", kExportButton);
+    fExportButton->Associate(this);
+    plotButtonFrame->AddFrame(fExportButton, new TGLayoutHints(kLHintsLeft, 5,5,2,2));
+    fExportButton->SetEnabled(false);
+
+    AddFrame(plotButtonFrame, new TGLayoutHints(kLHintsCenterX, 5,5,10,10));
 }
 
 // ============================================================================
@@ -260,9 +327,28 @@ void AdvancedPlotGUI::BuildScriptPanel()
     fScriptLangCombo->Resize(120, 20);
     scriptControlFrame->AddFrame(fScriptLangCombo, new TGLayoutHints(kLHintsLeft, 5,5,2,2));
 
-    TGTextButton* runScriptButton = new TGTextButton(scriptControlFrame, "Run Script", kRunScriptButton);
-    runScriptButton->Associate(this);
-    scriptControlFrame->AddFrame(runScriptButton, new TGLayoutHints(kLHintsLeft, 5,5,2,2));
+    fCompiledScriptCheck = new TGCheckButton(scriptControlFrame, "Compiled");
+    fCompiledScriptCheck->SetToolTipText("C++ only: build the macro with ACLiC and cache the library by content hash");
+    scriptControlFrame->AddFrame(fCompiledScriptCheck, new TGLayoutHints(kLHintsLeft | kLHintsCenterY, 5,5,2,2));
+
+    TGLabel* entryLabel = new TGLabel(scriptControlFrame, "Entry:");
+    scriptControlFrame->AddFrame(entryLabel, new TGLayoutHints(kLHintsLeft | kLHintsCenterY, 5,2,2,2));
+    fScriptEntryPoint = new TGTextEntry(scriptControlFrame);
+    fScriptEntryPoint->SetToolTipText("C++: the function to call. Like ROOT, the one named after the "
+                                      "macro file (set on Load/Save); required in Compiled mode");
+    fScriptEntryPoint->Resize(100, 20);
+    scriptControlFrame->AddFrame(fScriptEntryPoint, new TGLayoutHints(kLHintsLeft | kLHintsCenterY, 2,5,2,2));
+
+    fRunScriptButton = new TGTextButton(scriptControlFrame, "Run Script", kRunScriptButton);
+    fRunScriptButton->Associate(this);
+    scriptControlFrame->AddFrame(fRunScriptButton, new TGLayoutHints(kLHintsLeft, 5,5,2,2));
+
+    fInterruptButton = new TGTextButton(scriptControlFrame, "Interrupt", kInterruptScriptButton);
+    fInterruptButton->Associate(this);
+    fInterruptButton->SetToolTipText("Stop the running script (it runs in its own process): "
+                                     "the first press sends it Ctrl-C, a second kills it");
+    fInterruptButton->SetEnabled(kFALSE);
+    scriptControlFrame->AddFrame(fInterruptButton, new TGLayoutHints(kLHintsLeft, 5,5,2,2));
 
     TGTextButton* loadScriptButton = new TGTextButton(scriptControlFrame, "Load...", kLoadScriptButton);
     loadScriptButton->Associate(this);
@@ -276,6 +362,10 @@ void AdvancedPlotGUI::BuildScriptPanel()
     clearEditorButton->Associate(this);
     scriptControlFrame->AddFrame(clearEditorButton, new TGLayoutHints(kLHintsLeft, 5,5,2,2));
 
+    fScriptStatusLabel = new TGLabel(scriptControlFrame, "Idle");
+    fScriptStatusLabel->SetTextJustify(kTextLeft);
+    scriptControlFrame->AddFrame(fScriptStatusLabel, new TGLayoutHints(kLHintsLeft | kLHintsCenterY | kLHintsExpandX, 10,5,2,2));
+
     scriptGroup->AddFrame(scriptControlFrame, new TGLayoutHints(kLHintsExpandX, 5,5,5,2));
 
     fScriptEditor = new TGTextEdit(scriptGroup, 400, 150);
@@ -416,6 +506,37 @@ void AdvancedPlotGUI::OnCommandEnter()
     fScriptEngine->RunCommand(language);
 }
 
+// ============================================================================
+// Derived columns
+// ============================================================================
+void AdvancedPlotGUI::DefineColumn()
+{
+    std::string prompt = "New column as  name = expression  (empty expression removes it)";
+    for (const auto& def : DerivedColumns::Instance().GetDefinitions())
+        prompt += "\n    " + def.name + " = " + def.expression;
+
+    char answer[256] = "";   // TGInputDialog's return buffer size
+    new TGInputDialog(gClient->GetRoot(), this, prompt.c_str(), "", answer);
+    if (answer[0] == '\0') return;   // cancelled
+
+    DerivedColumnDef def;
+    std::string error;
+    if (!DerivedColumns::ParseDefinition(answer, def, error)) {
+        ShowWarning(this, "Define Column", error.c_str());
+        return;
+    }
+    if (def.expression.empty()) {
+        DerivedColumns::Instance().Remove(def.name);
+    } else if (!DerivedColumns::Instance().Define(def.name, def.expression, error)) {
+        ShowWarning(this, "Define Column", (def.name + ": " + error).c_str());
+        return;
+    }
+
+    // Computed now for the loaded data; a file loaded later gets it on first use
+    std::string messages = fFileHandler->UpdateDerivedColumns();
+    if (!messages.empty()) ShowWarning(this, "Define Column", messages.c_str());
+}
+
 // ============================================================================
 // Enable/disable plot controls
 // ============================================================================
@@ -428,13 +549,80 @@ void AdvancedPlotGUI::EnablePlotControls(Bool_t enable)
     if (fPlotButton) {
         fPlotButton->SetEnabled(enable);
     }
+
+    if (fExportButton) {
+        fExportButton->SetEnabled(enable);
+    }
+
+    if (fDefineColumnButton) {
+        fDefineColumnButton->SetEnabled(enable);
+    }
     
     // Force GUI update
     gClient->NeedRedraw(fAddPlotButton);
     gClient->NeedRedraw(fPlotButton);
+    gClient->NeedRedraw(fExportButton);
     gSystem->ProcessEvents();
 }
 
+// ============================================================================
+// Background load status
+// ============================================================================
+void AdvancedPlotGUI::SetLoadBusy(Bool_t busy, const char* what)
+{
+    fLoadProgressBar->Reset();
+    fCancelLoadButton->SetEnabled(busy);
+    fBrowseButton->SetEnabled(!busy);
+    fConvertButton->SetEnabled(!busy);
+    fLoadStatusLabel->SetText(busy ? Form("Loading %s ...", what) : "Idle");
+    fLoadStatusLabel->GetParent()->Layout();
+}
+
+void AdvancedPlotGUI::SetLoadProgress(Float_t percent, const char* status)
+{
+    fLoadProgressBar->SetPosition(percent);
+    fLoadStatusLabel->SetText(status);
+    fLoadStatusLabel->GetParent()->Layout();
+}
+
+// ============================================================================
+// Script execution status
+// ============================================================================
+void AdvancedPlotGUI::SetScriptRunning(Bool_t running)
+{
+    fRunScriptButton->SetEnabled(!running);
+    fInterruptButton->SetEnabled(running);
+    if (!running) SetScriptStatus("Idle");
+}
+
+TString AdvancedPlotGUI::GetScriptEntryPoint() const
+{
+    TString name = fScriptEntryPoint ? fScriptEntryPoint->GetText() : "";
+    return name.Strip(TString::kBoth);
+}
+
+void AdvancedPlotGUI::SetScriptEntryPoint(const char* name)
+{
+    if (fScriptEntryPoint) fScriptEntryPoint->SetText(name);
+}
+
+void AdvancedPlotGUI::SetScriptStatus(const char* status)
+{
+    fScriptStatusLabel->SetText(status);
+    fScriptStatusLabel->GetParent()->Layout();
+}
+
+// ============================================================================
+// Timers: the managers create TTimers with this frame as receiver so the
+// callback is a plain virtual call (no interpreter involved).
+// ============================================================================
+Bool_t AdvancedPlotGUI::HandleTimer(TTimer* timer)
+{
+    if (fFileHandler && fFileHandler->HandleTimer(timer)) return kTRUE;
+    if (fScriptEngine && fScriptEngine->HandleTimer(timer)) return kTRUE;
+    return TGMainFrame::HandleTimer(timer);
+}
+
 // ============================================================================
 // Add entry to plot list box
 // ============================================================================
@@ -484,8 +672,12 @@ Bool_t AdvancedPlotGUI::ProcessMessage(Long_t msg, Long_t parm1, Long_t parm2)
                         }
                     }
                     else if (parm1 == kAddPlotButton) {
+                        fFileHandler->UpdateDerivedColumns();
                         fPlotManager->AddPlot(fFileHandler->GetCurrentData());
                     }
+                    else if (parm1 == kDefineColumnButton) {
+                        DefineColumn();
+                    }
                     else if (parm1 == kRemovePlotButton) {
                         fPlotManager->RemovePlot(fPlotListBox->GetSelected());
                     }
@@ -500,13 +692,35 @@ Bool_t AdvancedPlotGUI::ProcessMessage(Long_t msg, Long_t parm1, Long_t parm2)
                             fFitFunctionCombo->GetSelected());
                         std::string customFunc = fCustomFuncEntry->GetText();
                         
+                        fFileHandler->UpdateDerivedColumns();
                         fPlotManager->CreatePlots(canvasTitle, overlayMode, dividedMode,
                                                  GetNRows(), GetNCols(), fitType, customFunc,
                                                  fFileHandler->GetCurrentData());
                     }
+                    else if (parm1 == kExportButton) {
+                        // Export forks worker processes; not while other
+                        // threads may hold ROOT locks
+                        if (fFileHandler->IsLoading() || fScriptEngine->IsRunning()) {
+                            ShowWarning(this, "Export",
+                                "Wait for the current load or script to finish.");
+                        } else {
+                            FitUtils::FitType fitType = static_cast<FitUtils::FitType>(
+                                fFitFunctionCombo->GetSelected());
+                            fFileHandler->UpdateDerivedColumns();
+                            fPlotManager->ExportPlots(fCanvasTitleEntry->GetText(),
+                                                      fSameCanvasCheck->IsOn(),
+                                                      fDividedCanvasCheck->IsOn(),
+                                                      GetNRows(), GetNCols(), fitType,
+                                                      fCustomFuncEntry->GetText(),
+                                                      fFileHandler->GetCurrentDataPtr());
+                        }
+                    }
                     else if (parm1 == kRunScriptButton) {
                         fScriptEngine->RunScript(fScriptLangCombo->GetSelected());
                     }
+                    else if (parm1 == kInterruptScriptButton) {
+                        fScriptEngine->Interrupt();
+                    }
                     else if (parm1 == kRunCommandButton) {
                         fScriptEngine->RunCommand(fScriptLangCombo->GetSelected());
                     }
@@ -522,6 +736,12 @@ Bool_t AdvancedPlotGUI::ProcessMessage(Long_t msg, Long_t parm1, Long_t parm2)
                     else if (parm1 == kClearOutputButton) {
                         fScriptEngine->ClearOutput();
                     }
+                    else if (parm1 == kCancelLoadButton) {
+                        fFileHandler->CancelLoad();
+                    }
+                    else if (parm1 == kConvertButton) {
+                        fFileHandler->ConvertToROOT();
+                    }
                     else if (parm1 == kEntrySelector) {  
                         std::string path = fFileHandler->Browse();
                         if (!path.empty()) {
@@ -0,0 +1,614 @@
+#include "BatchEngine.h"
+#include "BatchFitter.h"
+#include "CSVConverter.h"
+#include "ColumnExpression.h"
+#include "DataReader.h"
+#include "PlotExporter.h"
+#include "ThreadPool.h"
+
+#include <TCanvas.h>
+#include <TGraph.h>
+#include <TGraphErrors.h>
+#include <TH1.h>
+#include <TH2.h>
+#include <TH3.h>
+#include <TLegend.h>
+#include <TProfile.h>
+#include <TROOT.h>
+#include <TSystem.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace {
+
+std::atomic<int> gCanvasCount{0};
+
+std::mutex gRenderMutex;
+
+// ----------------------------------------------------------------------------
+// DatasetCache — every input is read once, however many jobs use it.
+// The first job asking for a file reads it; the others wait on its future.
+// ----------------------------------------------------------------------------
+class DatasetCache {
+private:
+    using Entry = std::shared_future<std::shared_ptr<const ColumnData>>;
+    std::mutex                   fMutex;
+    std::map<std::string, Entry> fEntries;
+
+public:
+    std::shared_ptr<const ColumnData> Get(const std::string& path) {
+        std::promise<std::shared_ptr<const ColumnData>> promise;
+        Entry entry;
+        bool reader = false;
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            auto it = fEntries.find(path);
+            if (it == fEntries.end()) {
+                entry = promise.get_future().share();
+                fEntries[path] = entry;
+                reader = true;
+            } else {
+                entry = it->second;
+            }
+        }
+        if (reader) {
+            auto data = std::make_shared<ColumnData>();
+            if (!DataReader::ReadFile(path, *data) || data->data.empty())
+                data.reset();
+            promise.set_value(data);
+        }
+        return entry.get();
+    }
+};
+
+std::string Trim(const std::string& s) {
+    size_t b = s.find_first_not_of(" \t\r\n");
+    if (b == std::string::npos) return "";
+    size_t e = s.find_last_not_of(" \t\r\n");
+    return s.substr(b, e - b + 1);
+}
+
+std::string Lower(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    return s;
+}
+
+// Split "key=value key2=\"quoted value\"" into tokens, honouring quotes
+std::vector<std::string> SplitSpec(const std::string& spec) {
+    std::vector<std::string> tokens;
+    std::string cur;
+    bool inQuotes = false, have = false;
+    for (char c : spec) {
+        if (c == '"') { inQuotes = !inQuotes; have = true; continue; }
+        if (!inQuotes && (c == ' ' || c == '\t')) {
+            if (have) { tokens.push_back(cur); cur.clear(); have = false; }
+            continue;
+        }
+        cur += c;
+        have = true;
+    }
+    if (have) tokens.push_back(cur);
+    return tokens;
+}
+
+bool ParsePlotType(const std::string& name, PlotConfig::PlotType& type) {
+    return PlotCreator::FindType(name, type);
+}
+
+bool ParseFitType(const std::string& name, FitUtils::FitType& fit) {
+    static const std::map<std::string, FitUtils::FitType> fits = {
+        {"none", FitUtils::kNoFit}, {"gaus", FitUtils::kGaus}, {"linear", FitUtils::kLinear},
+        {"pol0", FitUtils::kPol0}, {"pol1", FitUtils::kPol1}, {"pol2", FitUtils::kPol2},
+        {"pol3", FitUtils::kPol3}, {"pol4", FitUtils::kPol4}, {"expo", FitUtils::kExpo},
+        {"sine", FitUtils::kSine}, {"sineoffset", FitUtils::kSineOffset},
+        {"dampedsine", FitUtils::kDampedSine}, {"custom", FitUtils::kCustom}
+    };
+    auto it = fits.find(Lower(name));
+    if (it == fits.end()) return false;
+    fit = it->second;
+    return true;
+}
+
+bool ParseInt(const std::string& s, int& out) {
+    char* end = nullptr;
+    long v = std::strtol(s.c_str(), &end, 10);
+    if (end == s.c_str() || *end != '\0') return false;
+    out = (int)v;
+    return true;
+}
+
+bool ParseDouble(const std::string& s, double& out) {
+    char* end = nullptr;
+    double v = std::strtod(s.c_str(), &end);
+    if (end == s.c_str() || *end != '\0') return false;
+    out = v;
+    return true;
+}
+
+// "<a>x<b>" with both positive, as in Size=800x600
+bool ParseDims(const std::string& s, int& a, int& b) {
+    size_t x = Lower(s).find('x');
+    return x != std::string::npos &&
+           ParseInt(s.substr(0, x), a) && ParseInt(s.substr(x + 1), b) &&
+           a > 0 && b > 0;
+}
+
+int* ColumnField(PlotConfig& cfg, const std::string& key) {
+    if (key == "x")    return &cfg.xColumn;
+    if (key == "y")    return &cfg.yColumn;
+    if (key == "z")    return &cfg.zColumn;
+    if (key == "xerr") return &cfg.xErrColumn;
+    if (key == "yerr") return &cfg.yErrColumn;
+    if (key == "w")    return &cfg.weightColumn;
+    return nullptr;
+}
+
+bool ResolveColumns(BatchPlot& plot, const ColumnData& data, std::string& error) {
+    for (const auto& named : plot.namedColumns) {
+        auto it = std::find(data.headers.begin(), data.headers.end(), named.second);
+        if (it == data.headers.end()) {
+            error = "no column named '" + named.second + "'";
+            return false;
+        }
+        *ColumnField(plot.config, named.first) = (int)(it - data.headers.begin());
+    }
+    return true;
+}
+
+void ApplyBatchFit(TObject* obj, const BatchPlot& plot) {
+    if (plot.fit == FitUtils::kNoFit) return;
+    if (plot.fit == FitUtils::kGaus && obj->InheritsFrom(TH1::Class()) &&
+        !obj->InheritsFrom(TProfile::Class())) {
+        // RooFitBackend serialises RooFit itself
+        FitUtils::ApplyFit(obj, plot.fit, plot.config.color, plot.fitFormula);
+        return;
+    }
+
+    // TF1 fits go through BatchFitter: private TF1, Minuit2, FitCache
+    FitSpec spec;
+    spec.type    = plot.fit;
+    spec.formula = plot.fitFormula;
+    spec.starts  = plot.fitStarts;
+    std::vector<TF1*> fitted;
+    std::vector<FitRow> rows = BatchFitter::FitAll({ obj }, spec, 1, &fitted);
+    if (!fitted[0]) {
+        std::cerr << "[Batch] fit of " << obj->GetName() << " failed: "
+                  << rows[0].message << std::endl;
+        return;
+    }
+    TF1* fit = fitted[0];
+    fit->SetLineColor(plot.config.color);
+    fit->SetLineWidth(2);
+    fit->SetLineStyle(2);
+    TList* functions = obj->InheritsFrom(TGraph::Class())
+        ? static_cast<TGraph*>(obj)->GetListOfFunctions()
+        : static_cast<TH1*>(obj)->GetListOfFunctions();
+    functions->Add(fit);
+}
+
+// Builds and draws one plot into the current pad; returns the object drawn
+TObject* DrawPlot(const ColumnData& data, const PlotConfig& cfg, bool same) {
+    TObject* obj = PlotCreator::Create(data, cfg);
+    if (obj) {
+        const PlotTypeInfo& info = PlotCreator::GetTypeInfo(cfg.type);
+        obj->Draw(same && info.sameOption ? info.sameOption : info.drawOption);
+    }
+    return obj;
+}
+
+} // namespace
+
+// ============================================================================
+// Job file parsing
+// ============================================================================
+bool BatchEngine::ParsePlot(const std::string& spec, BatchPlot& plot, std::string& error)
+{
+    std::vector<std::string> tokens = SplitSpec(spec);
+    if (tokens.empty()) { error = "empty Plot="; return false; }
+    if (!ParsePlotType(tokens[0], plot.config.type)) {
+        error = "unknown plot type '" + tokens[0] + "'";
+        return false;
+    }
+    plot.config.color = 0;   // 0 = pick from the palette at run time
+
+    for (size_t t = 1; t < tokens.size(); ++t) {
+        size_t eq = tokens[t].find('=');
+        if (eq == std::string::npos) { error = "expected key=value, got '" + tokens[t] + "'"; return false; }
+        std::string key = Lower(tokens[t].substr(0, eq));
+        std::string val = tokens[t].substr(eq + 1);
+        PlotConfig& cfg = plot.config;
+        bool ok = true;
+
+        if (int* col = ColumnField(cfg, key)) {
+            if (!ParseInt(val, *col)) plot.namedColumns.emplace_back(key, val);
+        }
+        else if (key == "bins")    ok = ParseInt(val, cfg.bins);
+        else if (key == "binsy")   ok = ParseInt(val, cfg.binsY);
+        else if (key == "binsz")   ok = ParseInt(val, cfg.binsZ);
+        else if (key == "color")   ok = ParseInt(val, cfg.color);
+        else if (key == "xmin")    ok = ParseDouble(val, cfg.xMin);
+        else if (key == "xmax")    ok = ParseDouble(val, cfg.xMax);
+        else if (key == "ymin")    ok = ParseDouble(val, cfg.yMin);
+        else if (key == "ymax")    ok = ParseDouble(val, cfg.yMax);
+        else if (key == "zmin")    ok = ParseDouble(val, cfg.zMin);
+        else if (key == "zmax")    ok = ParseDouble(val, cfg.zMax);
+        else if (key == "title")   cfg.title  = val;
+        else if (key == "xtitle")  cfg.xTitle = val;
+        else if (key == "ytitle")  cfg.yTitle = val;
+        else if (key == "ztitle")  cfg.zTitle = val;
+        else if (key == "cut")     cfg.cut    = val;
+        else if (key == "fit")     ok = ParseFitType(val, plot.fit);
+        else if (key == "formula") plot.fitFormula = val;
+        else if (key == "starts") {
+            int n = 0;
+            ok = ParseInt(val, n) && n >= 1;
+            if (ok) plot.fitStarts = n;
+        }
+        else { error = "unknown plot key '" + key + "'"; return false; }
+
+        if (!ok) { error = "bad value for " + key + ": '" + val + "'"; return false; }
+    }
+
+    if (plot.fit == FitUtils::kCustom && plot.fitFormula.empty()) {
+        error = "fit=custom needs formula=...";
+        return false;
+    }
+    return true;
+}
+
+bool BatchEngine::ParseJobFile(const std::string& path, std::vector<BatchJob>& jobs,
+                               std::string& error)
+{
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        error = "cannot open job file " + path;
+        return false;
+    }
+
+    // Relative Input=/Output= paths are taken relative to the job file
+    TString baseDir = gSystem->GetDirName(path.c_str());
+    auto resolve = [&](const std::string& p) -> std::string {
+        if (p.empty() || gSystem->IsAbsoluteFileName(p.c_str()) || baseDir == ".")
+            return p;
+        return std::string(baseDir.Data()) + "/" + p;
+    };
+
+    std::string line;
+    int lineNo = 0;
+    BatchJob* job = nullptr;
+    auto fail = [&](const std::string& msg) {
+        error = path + ":" + std::to_string(lineNo) + ": " + msg;
+        return false;
+    };
+
+    while (std::getline(in, line)) {
+        ++lineNo;
+        line = Trim(line);
+        if (line.empty() || line[0] == '#' || line[0] == ';') continue;
+
+        if (line.front() == '[') {
+            if (line.back() != ']') return fail("unterminated section header");
+            std::string header = Trim(line.substr(1, line.size() - 2));
+            if (Lower(header.substr(0, 3)) != "job") return fail("expected [Job <name>]");
+            jobs.emplace_back();
+            job = &jobs.back();
+            job->name = Trim(header.substr(3));
+            if (job->name.empty()) job->name = "job" + std::to_string(jobs.size());
+            job->line = lineNo;
+            continue;
+        }
+
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) return fail("expected Key=Value");
+        if (!job) return fail("Key=Value outside a [Job] section");
+
+        std::string key = Lower(Trim(line.substr(0, eq)));
+        std::string val = Trim(line.substr(eq + 1));
+
+        if (key == "input") {
+            job->input = resolve(val);
+        } else if (key == "output") {
+            job->outputs.push_back(resolve(val));
+        } else if (key == "define") {
+            DerivedColumnDef def;
+            std::string derr;
+            if (!DerivedColumns::ParseDefinition(val, def, derr)) return fail(derr);
+            if (def.expression.empty()) return fail("Define needs an expression");
+            if (!ColumnExpression::CheckSyntax(def.expression, derr))
+                return fail(def.name + ": " + derr);
+            job->defines.push_back(def);
+        } else if (key == "plot") {
+            BatchPlot plot;
+            std::string perr;
+            if (!ParsePlot(val, plot, perr)) return fail(perr);
+            job->plots.push_back(plot);
+        } else if (key == "layout") {
+            std::string layout = Lower(val);
+            if (layout != "divided" && layout != "overlay")
+                return fail("Layout must be 'divided' or 'overlay'");
+            job->overlay = (layout == "overlay");
+        } else if (key == "size") {
+            if (!ParseDims(val, job->width, job->height))
+                return fail("Size must be <width>x<height>");
+        } else if (key == "grid") {
+            if (!ParseDims(val, job->nCols, job->nRows))
+                return fail("Grid must be <columns>x<rows>");
+        } else {
+            return fail("unknown key '" + key + "'");
+        }
+    }
+
+    if (jobs.empty()) {
+        error = path + ": no [Job] sections";
+        return false;
+    }
+    for (const auto& j : jobs) {
+        std::string where = path + ":" + std::to_string(j.line) + ": job '" + j.name + "' ";
+        if (j.input.empty())   { error = where + "has no Input=";  return false; }
+        if (j.plots.empty())   { error = where + "has no Plot=";   return false; }
+        if (j.outputs.empty()) { error = where + "has no Output="; return false; }
+    }
+    return true;
+}
+
+BatchJob BatchEngine::DefaultJob(const std::string& input)
+{
+    BatchJob job;
+    job.name  = "batch";
+    job.input = input;
+
+    BatchPlot plot;
+    plot.config.type    = PlotConfig::kTH1D;
+    plot.config.xColumn = 0;
+    plot.config.bins    = 100;
+    job.plots.push_back(plot);
+
+    job.outputs = { "batch_output.png", "batch_output.pdf" };
+    return job;
+}
+
+// ============================================================================
+// Execution
+// ============================================================================
+BatchResult BatchEngine::RenderJob(const BatchJob& job, const ColumnData& data)
+{
+    BatchResult result;
+    result.name = job.name;
+    auto start = std::chrono::steady_clock::now();
+    auto finish = [&](bool ok, const std::string& message) {
+        result.ok = ok;
+        result.message = message;
+        result.seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        return result;
+    };
+
+    // Derived columns go on a copy: the input table is shared by all jobs
+    // reading it, and a copy stays out of caches keyed on the original
+    std::shared_ptr<ColumnData> derived;
+    if (!job.defines.empty()) {
+        derived = std::make_shared<ColumnData>(data);
+        derived->Touch();
+        std::string messages;
+        DerivedColumns::Apply(job.defines, derived, messages);
+        if (!messages.empty()) return finish(false, Trim(messages));
+    }
+    const ColumnData& table = derived ? *derived : data;
+
+    std::vector<BatchPlot> plots = job.plots;
+    for (auto& plot : plots) {
+        std::string error;
+        if (!ResolveColumns(plot, table, error)) return finish(false, error);
+    }
+
+    std::string cname = "batch_" + std::to_string(++gCanvasCount);
+    std::unique_ptr<TCanvas> canvas(
+        new TCanvas(cname.c_str(), job.name.c_str(), job.width, job.height));
+
+    std::vector<std::unique_ptr<TObject>> owned;
+    TLegend* legend = nullptr;
+    if (!job.overlay && plots.size() > 1) {
+        int nCols = job.nCols, nRows = job.nRows;
+        if (nCols <= 0 || nRows <= 0 || nCols * nRows < (int)plots.size()) {
+            nCols = (int)std::ceil(std::sqrt((double)plots.size()));
+            nRows = ((int)plots.size() + nCols - 1) / nCols;
+        }
+        canvas->Divide(nCols, nRows);
+    } else if (job.overlay && plots.size() > 1) {
+        legend = new TLegend(0.7, 0.7, 0.9, 0.9);
+        owned.emplace_back(legend);
+    }
+
+    int drawn = 0;
+    for (size_t i = 0; i < plots.size(); ++i) {
+        BatchPlot& plot = plots[i];
+        if (plot.config.color <= 0) plot.config.color = (i % 9) + 1;
+        canvas->cd(job.overlay || plots.size() == 1 ? 0 : (int)i + 1);
+
+        TObject* obj = DrawPlot(table, plot.config, job.overlay && drawn > 0);
+        if (!obj) {
+            std::cerr << "[Batch] " << job.name << ": plot " << i + 1
+                      << " (" << plot.config.GetDescription() << ") could not be built\n";
+            continue;
+        }
+        owned.emplace_back(obj);
+        ++drawn;
+        const char* legendOption = PlotCreator::GetTypeInfo(plot.config.type).legendOption;
+        if (legend && legendOption)
+            legend->AddEntry(obj, plot.config.GetDescription().c_str(), legendOption);
+        ApplyBatchFit(obj, plot);
+    }
+    if (drawn == 0) return finish(false, "no plot could be built");
+    if (legend) { canvas->cd(0); legend->Draw(); }
+    canvas->Update();
+
+    for (const auto& out : job.outputs) {
+        TString dir = gSystem->GetDirName(out.c_str());
+        if (dir.Length() > 0 && gSystem->AccessPathName(dir))
+            gSystem->mkdir(dir, kTRUE);
+        // A file left by an earlier run must not pass for this one's output
+        gSystem->Unlink(out.c_str());
+        {
+            // Painting goes through process-wide globals (gVirtualPS, the
+            // TImageDump used for bitmaps), so only one SaveAs at a time
+            // per process; parallel rendering uses worker processes.
+            std::lock_guard<std::mutex> lock(gRenderMutex);
+            canvas->SaveAs(out.c_str());
+        }
+        if (!gSystem->AccessPathName(out.c_str()))
+            result.written.push_back(out);
+    }
+
+    // Canvas first: it still references the drawn objects
+    canvas.reset();
+    owned.clear();
+
+    if (result.written.size() != job.outputs.size())
+        return finish(false, "wrote " + std::to_string(result.written.size()) + " of " +
+                             std::to_string(job.outputs.size()) + " outputs");
+    return finish(true, "");
+}
+
+int BatchEngine::Run(const std::vector<BatchJob>& jobs, unsigned nThreads,
+                     unsigned nWorkers, const std::string& manifest)
+{
+    if (jobs.empty()) return kBatchBadJobFile;
+
+    // Headless: no GUI, no TRint; histograms stay out of gDirectory so
+    // concurrent jobs never share a directory list.
+    gROOT->SetBatch(kTRUE);
+    ROOT::EnableThreadSafety();
+    TH1::AddDirectory(kFALSE);
+
+    if (nThreads == 0) nThreads = ThreadPool::DefaultSize();
+
+    // Read every distinct input once, in parallel, before the workers fork
+    // so they all share the parsed tables copy-on-write.
+    DatasetCache cache;
+    {
+        ThreadPool pool(nThreads);
+        std::vector<std::future<std::shared_ptr<const ColumnData>>> reads;
+        for (const auto& job : jobs)
+            reads.push_back(pool.Submit([&cache, &job]() { return cache.Get(job.input); }));
+        for (auto& r : reads) r.get();
+    }
+
+    // Inside each worker process one thread is enough when the processes
+    // already cover the cores; --threads still applies with --workers 0.
+    unsigned renderThreads = nWorkers > 0 ? 1 : nThreads;
+    std::vector<BatchResult> results = PlotExporter::Render(
+        jobs, [&cache](const std::string& input) { return cache.Get(input); },
+        nWorkers, renderThreads);
+
+    int nOK = 0;
+    for (const auto& r : results) {
+        if (r.ok) ++nOK;
+        std::cout << "[Batch] job=" << r.name
+                  << " status=" << (r.ok ? "ok" : "failed")
+                  << " time=" << r.seconds << "s"
+                  << " outputs=" << r.written.size();
+        if (!r.message.empty()) std::cout << " message=\"" << r.message << "\"";
+        std::cout << std::endl;
+    }
+
+    if (!manifest.empty()) {
+        if (PlotExporter::WriteManifest(manifest, jobs, results))
+            std::cout << "[Batch] manifest=" << manifest << std::endl;
+        else
+            std::cerr << "[Batch] cannot write manifest " << manifest << std::endl;
+    }
+
+    std::cout << "[Batch] summary jobs=" << jobs.size() << " ok=" << nOK
+              << " failed=" << (int)jobs.size() - nOK << std::endl;
+
+    if (nOK == (int)jobs.size()) return kBatchOK;
+    if (nOK == 0)                return kBatchAllFailed;
+    return kBatchJobsFailed;
+}
+
+int BatchEngine::Main(int argc, char** argv)
+{
+    auto usage = [&]() {
+        std::cerr << "Usage: " << argv[0] << " --batch <jobfile.apgjob> [--workers N] [--threads N]"
+                     " [--manifest FILE]\n"
+                  << "       " << argv[0] << " --batch <datafile>   (TH1D of column 0)\n"
+                  << "       " << argv[0] << " --batch --convert <in.csv> <out.root> [--rntuple]"
+                     " [--tree NAME] [--delim C] [--threads N]\n";
+        return kBatchUsage;
+    };
+
+    std::string target, manifest, convertOut;
+    unsigned nThreads = 0;
+    unsigned nWorkers = PlotExporter::DefaultWorkers();
+    CSVConverter::Options convert;
+    bool delimGiven = false;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        int n = 0;
+        if (arg == "--convert" && i + 2 < argc && target.empty()) {
+            target     = argv[++i];
+            convertOut = argv[++i];
+        } else if (arg == "--rntuple") {
+            convert.format = CSVConverter::kRNTuple;
+        } else if (arg == "--tree" && i + 1 < argc) {
+            convert.treeName = argv[++i];
+        } else if (arg == "--delim" && i + 1 < argc) {
+            std::string d = argv[++i];
+            if (d == "tab" || d == "\\t") d = "\t";
+            if (d.size() != 1) return usage();
+            convert.delim = d[0];
+            delimGiven = true;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            if (!ParseInt(argv[++i], n) || n < 0) return usage();
+            nThreads = (unsigned)n;
+        } else if (arg == "--workers" && i + 1 < argc) {
+            if (!ParseInt(argv[++i], n) || n < 0) return usage();
+            nWorkers = (unsigned)n;
+        } else if (arg == "--manifest" && i + 1 < argc) {
+            manifest = argv[++i];
+        } else if (target.empty() && arg.rfind("--", 0) != 0) {
+            target = arg;
+        } else {
+            return usage();
+        }
+    }
+    if (target.empty()) return usage();
+
+    if (!convertOut.empty()) {
+        if (!delimGiven && DataReader::GetFileType(target) != DataReader::kCSV)
+            convert.delim = ' ';   // .txt/.dat: whitespace, as DataReader::ReadTextFile
+        convert.nThreads = nThreads;
+        std::string message;
+        bool ok = CSVConverter::Convert(target, convertOut, convert, message);
+        std::cout << "[Batch] convert " << target << " -> " << convertOut
+                  << (ok ? " ok" : " FAILED") << "\n" << message << std::endl;
+        return ok ? kBatchOK : kBatchAllFailed;
+    }
+
+    std::vector<BatchJob> jobs;
+    size_t dot = target.find_last_of('.');
+    std::string ext = dot == std::string::npos ? "" : Lower(target.substr(dot + 1));
+    if (ext == "apgjob" || ext == "job") {
+        std::string error;
+        if (!ParseJobFile(target, jobs, error)) {
+            std::cerr << "[Batch] " << error << std::endl;
+            return kBatchBadJobFile;
+        }
+        if (manifest.empty()) manifest = target.substr(0, dot) + ".manifest.tsv";
+    } else {
+        jobs.push_back(DefaultJob(target));
+    }
+    return Run(jobs, nThreads, nWorkers, manifest);
+}
@@ -0,0 +1,343 @@
+#include "BatchFitter.h"
+#include "FitCache.h"
+#include "ThreadPool.h"
+
+#include <TGraph.h>
+#include <TH1.h>
+#include <TROOT.h>
+
+#include <Fit/BinData.h>
+#include <Fit/Fitter.h>
+#include <Fit/FitResult.h>
+#include <HFitInterface.h>
+#include <Math/WrappedMultiTF1.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+
+namespace {
+
+std::atomic<int> gPrototypeCount{0};
+
+} // namespace
+
+// ============================================================================
+// Prototype: a copy of the registry's compiled model or formula
+// ============================================================================
+TF1* BatchFitter::MakePrototype(const FitSpec& spec, std::string& error)
+{
+    std::string name = "batchfit_" + std::to_string(++gPrototypeCount);
+    std::string modelName = spec.ModelName();
+    FitModelRegistry& registry = FitModelRegistry::Instance();
+
+    TF1* f = nullptr;
+    if (!modelName.empty()) {
+        f = registry.MakeFunction(modelName, name.c_str(), 0, 1);
+        if (!f) error = "unknown fit model '" + modelName + "'";
+    } else if (spec.formula.empty()) {
+        error = "no fit function";
+    } else {
+        f = registry.MakeFormulaFunction(spec.formula, name.c_str(), 0, 1);
+        if (!f) error = "cannot use formula '" + spec.formula + "'";
+    }
+    return f;
+}
+
+// ============================================================================
+// Per-object steps; each runs on a worker thread and touches only f, row
+// and the const object
+// ============================================================================
+bool BatchFitter::SetRange(TF1& f, const TObject* obj, FitRow& row)
+{
+    if (obj->InheritsFrom(TGraph::Class())) {
+        const TGraph* graph = static_cast<const TGraph*>(obj);
+        if (graph->GetN() > 0) {
+            f.SetRange(*std::min_element(graph->GetX(), graph->GetX() + graph->GetN()),
+                       *std::max_element(graph->GetX(), graph->GetX() + graph->GetN()));
+        }
+        return true;
+    }
+    if (obj->InheritsFrom(TH1::Class()) && static_cast<const TH1*>(obj)->GetDimension() == 1) {
+        const TH1* hist = static_cast<const TH1*>(obj);
+        f.SetRange(hist->GetXaxis()->GetXmin(), hist->GetXaxis()->GetXmax());
+        return true;
+    }
+    row.message = std::string("cannot fit ") + obj->ClassName();
+    return false;
+}
+
+// Same data, same spec: restore instead of refitting
+bool BatchFitter::Restore(TF1& f, const std::string& key, FitRow& row)
+{
+    CachedFit cached;
+    if (!FitCache::Instance().Lookup(key, cached) ||
+        cached.params.size() != (size_t)f.GetNpar())
+        return false;
+
+    f.SetParameters(cached.params.data());
+    f.SetParErrors(cached.errors.data());
+    f.SetChisquare(cached.chi2);
+    f.SetNDF(cached.ndf);
+    row.status   = cached.status;
+    row.valid    = cached.valid;
+    row.chi2     = cached.chi2;
+    row.ndf      = cached.ndf;
+    row.parNames = cached.parNames;
+    row.params   = cached.params;
+    row.errors   = cached.errors;
+    row.cached   = true;
+    if (!row.valid) row.message = "fit did not converge";
+    return true;
+}
+
+void BatchFitter::Store(const std::string& key, const FitRow& row)
+{
+    if (key.empty() || row.status < 0) return;
+    CachedFit entry;
+    entry.parNames = row.parNames;
+    entry.params   = row.params;
+    entry.errors   = row.errors;
+    entry.chi2     = row.chi2;
+    entry.ndf      = row.ndf;
+    entry.status   = row.status;
+    entry.valid    = row.valid;
+    FitCache::Instance().Store(key, entry);
+}
+
+void BatchFitter::FitOne(TF1& f, const FitSpec& spec, const TObject* obj, FitRow& row,
+                         const std::vector<double>* start)
+{
+    auto t0 = std::chrono::steady_clock::now();
+
+    ROOT::Fit::DataOptions opt;
+    ROOT::Fit::DataRange   range;
+    ROOT::Fit::BinData     data(opt, range);
+    if (obj->InheritsFrom(TGraph::Class())) ROOT::Fit::FillData(data, static_cast<const TGraph*>(obj));
+    else                                    ROOT::Fit::FillData(data, static_cast<const TH1*>(obj));
+
+    if (data.Size() <= (unsigned)f.GetNpar()) {
+        row.message = "too few points (" + std::to_string(data.Size()) + ")";
+        return;
+    }
+
+    // Starting values; ROOT's automatic guesses only run inside TH1::Fit
+    auto model = FitModelRegistry::Instance().Find(spec.ModelName());
+    if (start)      f.SetParameters(start->data());
+    else if (model) FitModelRegistry::Guess(*model, f, obj);
+
+    ROOT::Fit::Fitter fitter;
+    fitter.Config().SetMinimizer(spec.minimizer.c_str(), "Migrad");
+    // Analytic gradient when the model has one, else SIMD when f is
+    // vectorized; every wrapper takes the guesses and names from f
+    if (model && model->parGrad) {
+        FitModelFunction mf(model, f.GetParameters());
+        fitter.SetFunction(mf, true);
+    }
+#ifdef R__HAS_VECCORE
+    else if (f.IsVectorized()) {
+        ROOT::Math::WrappedMultiTF1Templ<ROOT::Double_v> wf(f, 1);
+        fitter.SetFunction(wf, false);
+    }
+#endif
+    else {
+        ROOT::Math::WrappedMultiTF1 wf(f, 1);
+        fitter.SetFunction(wf, false);
+    }
+
+    fitter.Fit(data);
+    const ROOT::Fit::FitResult& result = fitter.Result();
+    f.SetFitResult(result);
+
+    row.status = result.Status();
+    row.valid  = result.IsValid();
+    row.chi2   = result.Chi2();
+    row.ndf    = (int)result.Ndf();
+    row.parNames.clear();
+    row.params.clear();
+    row.errors.clear();
+    for (int i = 0; i < f.GetNpar(); ++i) {
+        row.parNames.push_back(f.GetParName(i));
+        row.params.push_back(result.Parameter(i));
+        row.errors.push_back(result.ParError(i));
+    }
+    if (!row.valid) row.message = "fit did not converge";
+    row.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// ============================================================================
+// Fit every object
+// ============================================================================
+std::vector<FitRow> BatchFitter::FitAll(const std::vector<TObject*>& objects,
+                                        const FitSpec& spec, unsigned nThreads,
+                                        std::vector<TF1*>* fitted)
+{
+    std::vector<FitRow> rows(objects.size());
+    if (fitted) fitted->assign(objects.size(), nullptr);
+    if (objects.empty() || !spec.IsSet()) return rows;
+
+    ROOT::EnableThreadSafety();
+
+    auto modelDef = FitModelRegistry::Instance().Find(spec.ModelName());
+    std::string model = modelDef ? modelDef->title : spec.formula;
+
+    std::string error;
+    std::unique_ptr<TF1> proto(MakePrototype(spec, error));
+
+    // Per-object copies made here, so workers never compile or register anything
+    std::vector<std::unique_ptr<TF1>> funcs(objects.size());
+    for (size_t i = 0; i < objects.size(); ++i) {
+        rows[i].model  = model;
+        rows[i].object = objects[i] ? objects[i]->GetName() : "";
+        if (!proto)       { rows[i].message = error;         continue; }
+        if (!objects[i])  { rows[i].message = "null object"; continue; }
+        funcs[i].reset(new TF1(*proto));
+        funcs[i]->SetName((std::string(proto->GetName()) + "_" + std::to_string(i)).c_str());
+    }
+    if (!proto) return rows;
+
+    // Multi-start needs a registry model to propose the starting points
+    const unsigned nStarts = modelDef ? std::max(1u, spec.starts) : 1u;
+
+    if (nThreads == 0) nThreads = ThreadPool::DefaultSize();
+    ThreadPool pool(std::min<unsigned>(nThreads, (unsigned)(objects.size() * nStarts)));
+    std::vector<std::future<void>> done;
+    auto submit = [&](FitRow& row, std::function<void()> task) {
+        done.push_back(pool.Submit([&row, task]() {
+            try {
+                task();
+            } catch (const std::exception& e) {
+                row.message = e.what();
+            }
+        }));
+    };
+    auto wait = [&]() {
+        for (auto& d : done) d.get();
+        done.clear();
+    };
+
+    // Range, then cache; single-start fits run right away
+    std::vector<std::string>                      keys(objects.size());
+    std::vector<std::vector<std::vector<double>>> starts(objects.size());
+    std::vector<char>                             pending(objects.size(), 0);   // not vector<bool>: written concurrently
+    for (size_t i = 0; i < objects.size(); ++i) {
+        if (!funcs[i]) continue;
+        submit(rows[i], [&, i]() {
+            auto t0 = std::chrono::steady_clock::now();
+            if (!SetRange(*funcs[i], objects[i], rows[i])) return;
+            if (spec.useCache) keys[i] = FitCache::MakeKey(objects[i], spec.CacheKey());
+            bool restored = Restore(*funcs[i], keys[i], rows[i]);
+            rows[i].seconds = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - t0).count();
+            if (restored) return;
+
+            if (nStarts == 1) {
+                FitOne(*funcs[i], spec, objects[i], rows[i]);
+                Store(keys[i], rows[i]);
+            } else {
+                starts[i]  = FitModelRegistry::Starts(*modelDef, *funcs[i], objects[i], nStarts);
+                pending[i] = 1;
+            }
+        });
+    }
+    wait();
+
+    // Multi-start: every (object, start) pair is its own task
+    if (nStarts > 1) {
+        std::vector<std::vector<std::unique_ptr<TF1>>> trials(objects.size());
+        std::vector<std::vector<FitRow>>               trialRows(objects.size());
+        for (size_t i = 0; i < objects.size(); ++i) {
+            if (!pending[i]) continue;
+            for (size_t k = 0; k < starts[i].size(); ++k) {
+                trials[i].emplace_back(new TF1(*funcs[i]));
+                trialRows[i].push_back(rows[i]);
+            }
+        }
+        for (size_t i = 0; i < objects.size(); ++i) {
+            for (size_t k = 0; k < trials[i].size(); ++k) {
+                submit(trialRows[i][k], [&, i, k]() {
+                    FitOne(*trials[i][k], spec, objects[i], trialRows[i][k], &starts[i][k]);
+                });
+            }
+        }
+        wait();
+
+        // Keep the best: converged before failed, then lowest chi2
+        for (size_t i = 0; i < objects.size(); ++i) {
+            if (trials[i].empty()) continue;
+            size_t best    = 0;
+            double seconds = rows[i].seconds;   // range, cache and starts
+            for (size_t k = 0; k < trials[i].size(); ++k) {
+                const FitRow& r = trialRows[i][k];
+                const FitRow& b = trialRows[i][best];
+                seconds += r.seconds - rows[i].seconds;
+                if (r.status < 0) continue;
+                if (b.status < 0 || (r.valid && !b.valid) ||
+                    (r.valid == b.valid && r.chi2 < b.chi2))
+                    best = k;
+            }
+            rows[i]         = trialRows[i][best];
+            rows[i].seconds = seconds;
+            if (rows[i].message.empty())
+                rows[i].message = "best of " + std::to_string(trials[i].size()) + " starts";
+            funcs[i] = std::move(trials[i][best]);
+            Store(keys[i], rows[i]);
+        }
+    }
+
+    if (fitted) {
+        for (size_t i = 0; i < objects.size(); ++i)
+            if (funcs[i] && rows[i].status >= 0) (*fitted)[i] = funcs[i].release();
+    }
+    return rows;
+}
+
+// ============================================================================
+// Result table
+// ============================================================================
+void BatchFitter::PrintTable(const std::vector<FitRow>& rows, std::ostream& os)
+{
+    os << "\n=== Batch Fit Results (" << rows.size() << " objects) ===\n";
+    os << std::left << std::setw(20) << "Object" << std::setw(16) << "Model"
+       << std::right << std::setw(8) << "Status" << std::setw(14) << "Chi2/NDF"
+       << "  Parameters\n";
+    for (const auto& r : rows) {
+        os << std::left << std::setw(20) << r.object << std::setw(16) << r.model
+           << std::right << std::setw(8) << r.status;
+        if (r.status < 0) {
+            os << std::setw(14) << "-" << "  " << r.message << "\n";
+            continue;
+        }
+        os << std::setw(14) << std::setprecision(4) << r.Chi2NDF() << " ";
+        for (size_t i = 0; i < r.params.size(); ++i)
+            os << " " << r.parNames[i] << "=" << std::setprecision(5) << r.params[i]
+               << "+-" << std::setprecision(2) << r.errors[i];
+        if (r.cached) os << "  [cached]";
+        if (!r.message.empty()) os << "  (" << r.message << ")";
+        os << "\n";
+    }
+    os << "===================================\n" << std::endl;
+}
+
+bool BatchFitter::WriteTable(const std::string& path, const std::vector<FitRow>& rows)
+{
+    std::ofstream out(path);
+    if (!out.is_open()) return false;
+
+    out << "# object\tmodel\tstatus\tvalid\tchi2\tndf\tseconds\tparameters (name=value+-error;...)\n";
+    out << std::setprecision(10);
+    for (const auto& r : rows) {
+        out << r.object << '\t' << r.model << '\t' << r.status << '\t' << (r.valid ? 1 : 0)
+            << '\t' << r.chi2 << '\t' << r.ndf << '\t' << r.seconds << '\t';
+        for (size_t i = 0; i < r.params.size(); ++i)
+            out << (i ? ";" : "") << r.parNames[i] << "=" << r.params[i] << "+-" << r.errors[i];
+        out << '\n';
+    }
+    return out.good();
+}
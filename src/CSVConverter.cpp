@@ -0,0 +1,527 @@
+#include "CSVConverter.h"
+#include "RNTupleCompat.h"
+#include "ThreadPool.h"
+
+#include <TFile.h>
+#include <TTree.h>
+#include <TSystem.h>
+
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <future>
+#include <limits>
+#include <set>
+#include <utility>
+
+namespace {
+
+using ColumnType = CSVConverter::ColumnType;
+using Lines      = std::vector<std::string>;
+
+// ============================================================================
+// Input: the file positioned after its header, read in chunks of data lines
+// ============================================================================
+struct Input {
+    std::ifstream            file;
+    std::vector<std::string> headers;
+    Lines                    pending;   // first data line, read while looking for a header
+    Long64_t                 bytes = 0;
+};
+
+// Same header rules as DataReader::ReadDelimitedFile
+bool OpenInput(const std::string& path, const CSVConverter::Options& opt, Input& in,
+               std::string& error)
+{
+    in.file.open(path);
+    if (!in.file.is_open()) {
+        error = "Cannot open file: " + path;
+        return false;
+    }
+
+    std::string line;
+    std::vector<std::string> tokens;
+    int skip = opt.skipRows;
+    while (std::getline(in.file, line)) {
+        in.bytes += (Long64_t)line.size() + 1;
+        if (skip > 0) { --skip; continue; }
+        if (DataReader::IsBlank(line) || (opt.autoHeader && line[0] == '#')) continue;
+
+        DataReader::Tokenize(line, opt.delim, tokens);
+        if (tokens.empty()) continue;
+
+        bool isHeader = opt.useHeader;
+        if (opt.autoHeader) {
+            const char* first = tokens[0].c_str();
+            char* end = nullptr;
+            std::strtod(first, &end);
+            isHeader = end == first;
+        }
+        if (isHeader) {
+            in.headers = tokens;
+        } else {
+            for (size_t i = 0; i < tokens.size(); ++i) in.headers.push_back(Form("Col%zu", i));
+            in.pending.push_back(line);
+        }
+        return true;
+    }
+    error = "No data found in " + path;
+    return false;
+}
+
+bool ReadChunk(Input& in, const CSVConverter::Options& opt, Lines& lines)
+{
+    lines.clear();
+    lines.swap(in.pending);
+    std::string line;
+    while (lines.size() < opt.chunkLines && std::getline(in.file, line)) {
+        in.bytes += (Long64_t)line.size() + 1;
+        if (DataReader::IsBlank(line) || (opt.autoHeader && line[0] == '#')) continue;
+        lines.push_back(std::move(line));
+    }
+    return !lines.empty();
+}
+
+// ============================================================================
+// Token parsing
+// ============================================================================
+bool ParseInteger(const std::string& token, Long64_t& value)
+{
+    if (token.empty()) return false;
+    char* end = nullptr;
+    errno = 0;
+    long long v = std::strtoll(token.c_str(), &end, 10);
+    if (*end != '\0' || errno == ERANGE) return false;
+    value = v;
+    return true;
+}
+
+double ParseReal(const std::string& token)
+{
+    double v;
+    return DataReader::ParseValue(token, v) ? v : std::numeric_limits<double>::quiet_NaN();
+}
+
+ColumnType Classify(const std::string& token)
+{
+    Long64_t v = 0;
+    if (!ParseInteger(token, v)) return CSVConverter::kDouble;   // also missing values (NaN)
+    if (v < std::numeric_limits<Int_t>::min() || v > std::numeric_limits<Int_t>::max())
+        return CSVConverter::kLong;
+    return CSVConverter::kInt;
+}
+
+// Pass 1: the widest type seen per column
+struct Scan {
+    std::vector<ColumnType> types;
+    size_t                  rows = 0;
+};
+
+Scan ScanChunk(const Lines& lines, char delim, size_t nCols)
+{
+    Scan scan;
+    scan.types.assign(nCols, CSVConverter::kInt);
+    scan.rows = lines.size();
+    std::vector<std::string> tokens;
+    for (const auto& line : lines) {
+        DataReader::Tokenize(line, delim, tokens);
+        for (size_t c = 0; c < nCols; ++c) {
+            if (scan.types[c] == CSVConverter::kDouble) continue;
+            ColumnType t = c < tokens.size() ? Classify(tokens[c]) : CSVConverter::kDouble;
+            if (t > scan.types[c]) scan.types[c] = t;
+        }
+    }
+    return scan;
+}
+
+// Pass 2: typed columns of one chunk
+struct Chunk {
+    size_t                             rows = 0;
+    std::vector<std::vector<Long64_t>> ints;    // kInt / kLong columns
+    std::vector<std::vector<double>>   reals;   // kDouble columns
+};
+
+Chunk ParseChunk(const Lines& lines, char delim, const std::vector<ColumnType>& types)
+{
+    const size_t nCols = types.size();
+    Chunk chunk;
+    chunk.rows = lines.size();
+    chunk.ints.resize(nCols);
+    chunk.reals.resize(nCols);
+    for (size_t c = 0; c < nCols; ++c) {
+        if (types[c] == CSVConverter::kDouble) chunk.reals[c].reserve(lines.size());
+        else                                   chunk.ints[c].reserve(lines.size());
+    }
+
+    static const std::string kMissing;
+    std::vector<std::string> tokens;
+    for (const auto& line : lines) {
+        DataReader::Tokenize(line, delim, tokens);
+        for (size_t c = 0; c < nCols; ++c) {
+            const std::string& token = c < tokens.size() ? tokens[c] : kMissing;
+            if (types[c] == CSVConverter::kDouble) {
+                chunk.reals[c].push_back(ParseReal(token));
+            } else {
+                Long64_t v = 0;
+                ParseInteger(token, v);   // pass 1 saw an integer here
+                chunk.ints[c].push_back(v);
+            }
+        }
+    }
+    return chunk;
+}
+
+// ============================================================================
+// Runs work(lines) for each chunk of in on the pool, with at most two chunks
+// per thread in flight, and hands the results to consume() in file order.
+// Returns false if progress asked to cancel.
+// ============================================================================
+template <class Work, class Consume>
+bool RunChunks(Input& in, const CSVConverter::Options& opt, ThreadPool& pool,
+               ReadProgress* progress, Long64_t offset, Work work, Consume consume)
+{
+    using Result = decltype(work(std::declval<const Lines&>()));
+    const size_t maxInFlight = 2 * pool.Size();
+
+    std::deque<std::future<Result>> inFlight;
+    Lines lines;
+    bool eof = false;
+    for (;;) {
+        while (!eof && inFlight.size() < maxInFlight) {
+            if (!ReadChunk(in, opt, lines)) { eof = true; break; }
+            inFlight.push_back(pool.Submit([work, chunk = std::move(lines)]() {
+                return work(chunk);
+            }));
+            lines = Lines();
+        }
+        if (inFlight.empty()) return true;
+
+        consume(inFlight.front().get());
+        inFlight.pop_front();
+        if (progress) {
+            progress->processed = offset + in.bytes;
+            if (progress->Cancelled()) return false;   // queued chunks finish unused
+        }
+    }
+}
+
+// ============================================================================
+// Output sinks: one row at a time, on the calling thread
+// ============================================================================
+class TreeSink {
+private:
+    std::string             fPath;
+    TFile*                  fFile = nullptr;
+    TTree*                  fTree = nullptr;   // owned by fFile
+    std::vector<ColumnType> fTypes;
+    std::vector<Int_t>      fI;                // branch buffers, one slot per column
+    std::vector<Long64_t>   fL;
+    std::vector<Double_t>   fD;
+
+public:
+    ~TreeSink() { if (fFile) Abort(); }
+
+    bool Open(const std::string& path, const CSVConverter::Options& opt,
+              const std::vector<std::string>& names, const std::vector<ColumnType>& types,
+              std::string& error)
+    {
+        fPath  = path;
+        fFile  = TFile::Open(path.c_str(), "RECREATE", "", opt.compression);
+        if (!fFile || fFile->IsZombie()) {
+            delete fFile;
+            fFile = nullptr;
+            error = "Cannot create ROOT file: " + path;
+            return false;
+        }
+        fTree  = new TTree(opt.treeName.c_str(), "converted from text");
+        fTree->SetDirectory(fFile);
+        fTypes = types;
+        fI.assign(types.size(), 0);
+        fL.assign(types.size(), 0);
+        fD.assign(types.size(), 0.0);
+        for (size_t c = 0; c < types.size(); ++c) {
+            const std::string& name = names[c];
+            switch (types[c]) {
+                case CSVConverter::kInt:
+                    fTree->Branch(name.c_str(), &fI[c], (name + "/I").c_str());
+                    break;
+                case CSVConverter::kLong:
+                    fTree->Branch(name.c_str(), &fL[c], (name + "/L").c_str());
+                    break;
+                case CSVConverter::kDouble:
+                    fTree->Branch(name.c_str(), &fD[c], (name + "/D").c_str());
+                    break;
+            }
+        }
+        return true;
+    }
+
+    void Fill(const Chunk& chunk)
+    {
+        for (size_t r = 0; r < chunk.rows; ++r) {
+            for (size_t c = 0; c < fTypes.size(); ++c) {
+                switch (fTypes[c]) {
+                    case CSVConverter::kInt:    fI[c] = (Int_t)chunk.ints[c][r]; break;
+                    case CSVConverter::kLong:   fL[c] = chunk.ints[c][r];        break;
+                    case CSVConverter::kDouble: fD[c] = chunk.reals[c][r];       break;
+                }
+            }
+            fTree->Fill();
+        }
+    }
+
+    bool Close(std::string& error)
+    {
+        fTree->Write("", TObject::kOverwrite);
+        bool failed = fFile->TestBit(TFile::kWriteError);
+        fFile->Close();   // deletes fTree
+        delete fFile;
+        fFile = nullptr;
+        if (failed) error = "Write error on " + fPath;
+        return !failed;
+    }
+
+    void Abort()
+    {
+        fFile->Close();
+        delete fFile;
+        fFile = nullptr;
+        gSystem->Unlink(fPath.c_str());
+    }
+};
+
+#ifdef APG_HAVE_RNTUPLE
+// RNTuple reports errors by throwing (ROOT::RException)
+class NTupleSink {
+private:
+    std::string                                fPath;
+    std::unique_ptr<RNTupleAPI::RNTupleWriter> fWriter;
+    std::vector<ColumnType>                    fTypes;
+    std::vector<std::shared_ptr<std::int32_t>> fI;   // field values, one per column
+    std::vector<std::shared_ptr<std::int64_t>> fL;
+    std::vector<std::shared_ptr<double>>       fD;
+    std::string                                fError;   // first failed Fill
+
+public:
+    ~NTupleSink() { if (fWriter) Abort(); }
+
+    bool Open(const std::string& path, const CSVConverter::Options& opt,
+              const std::vector<std::string>& names, const std::vector<ColumnType>& types,
+              std::string& error)
+    {
+        fPath  = path;
+        fTypes = types;
+        fI.resize(types.size());
+        fL.resize(types.size());
+        fD.resize(types.size());
+        try {
+            auto model = RNTupleAPI::RNTupleModel::Create();
+            for (size_t c = 0; c < types.size(); ++c) {
+                switch (types[c]) {
+                    case CSVConverter::kInt:    fI[c] = model->MakeField<std::int32_t>(names[c].c_str()); break;
+                    case CSVConverter::kLong:   fL[c] = model->MakeField<std::int64_t>(names[c].c_str()); break;
+                    case CSVConverter::kDouble: fD[c] = model->MakeField<double>(names[c].c_str());       break;
+                }
+            }
+            RNTupleAPI::RNTupleWriteOptions options;
+            options.SetCompression(opt.compression);
+            fWriter = RNTupleAPI::RNTupleWriter::Recreate(std::move(model), opt.treeName, path, options);
+        } catch (const std::exception& e) {
+            error = "Cannot create RNTuple in " + path + ": " + e.what();
+            return false;
+        }
+        return true;
+    }
+
+    void Fill(const Chunk& chunk)
+    {
+        if (!fError.empty()) return;
+        try {
+            FillRows(chunk);
+        } catch (const std::exception& e) {
+            fError = "Write error on " + fPath + ": " + e.what();
+        }
+    }
+
+    void FillRows(const Chunk& chunk)
+    {
+        for (size_t r = 0; r < chunk.rows; ++r) {
+            for (size_t c = 0; c < fTypes.size(); ++c) {
+                switch (fTypes[c]) {
+                    case CSVConverter::kInt:    *fI[c] = (std::int32_t)chunk.ints[c][r]; break;
+                    case CSVConverter::kLong:   *fL[c] = chunk.ints[c][r];               break;
+                    case CSVConverter::kDouble: *fD[c] = chunk.reals[c][r];              break;
+                }
+            }
+            fWriter->Fill();
+        }
+    }
+
+    bool Close(std::string& error)
+    {
+        if (!fError.empty()) {
+            error = fError;
+            Abort();
+            return false;
+        }
+        try {
+            fWriter.reset();   // commits the last cluster and the footer
+        } catch (const std::exception& e) {
+            error = "Write error on " + fPath + ": " + e.what();
+            return false;
+        }
+        return true;
+    }
+
+    void Abort()
+    {
+        try { fWriter.reset(); } catch (const std::exception&) {}
+        gSystem->Unlink(fPath.c_str());
+    }
+};
+#endif
+
+// Pass 2 into one sink
+template <class Sink>
+bool WriteRows(Sink& sink, const std::string& rootPath, Input& in,
+               const CSVConverter::Options& opt, const std::vector<std::string>& names,
+               const std::vector<ColumnType>& types, ThreadPool& pool,
+               ReadProgress* progress, Long64_t offset, Long64_t& rows, std::string& error)
+{
+    if (!sink.Open(rootPath, opt, names, types, error)) return false;
+
+    const char delim = opt.delim;
+    rows = 0;
+    bool complete = RunChunks(in, opt, pool, progress, offset,
+        [delim, types](const Lines& lines) { return ParseChunk(lines, delim, types); },
+        [&](Chunk chunk) {
+            sink.Fill(chunk);
+            rows += (Long64_t)chunk.rows;
+            if (progress) progress->rows = rows;
+        });
+    if (!complete) {
+        sink.Abort();
+        error = "Conversion cancelled; " + rootPath + " was not written";
+        return false;
+    }
+    return sink.Close(error);
+}
+
+} // namespace
+
+// ============================================================================
+// Names and types
+// ============================================================================
+bool CSVConverter::HaveRNTuple()
+{
+#ifdef APG_HAVE_RNTUPLE
+    return true;
+#else
+    return false;
+#endif
+}
+
+const char* CSVConverter::TypeName(ColumnType type)
+{
+    switch (type) {
+        case kInt:    return "Int_t";
+        case kLong:   return "Long64_t";
+        case kDouble: return "Double_t";
+    }
+    return "?";
+}
+
+std::string CSVConverter::BranchName(const std::string& header)
+{
+    std::string name;
+    for (char c : header)
+        name += (std::isalnum((unsigned char)c) || c == '_') ? c : '_';
+    if (name.empty() || std::isdigit((unsigned char)name[0])) name = "_" + name;
+    return name;
+}
+
+// ============================================================================
+// Convert
+// ============================================================================
+bool CSVConverter::Convert(const std::string& inputPath, const std::string& rootPath,
+                           const Options& options, std::string& message,
+                           ReadProgress* progress)
+{
+    if (options.format == kRNTuple && !HaveRNTuple()) {
+        message = "This build has no RNTuple support (needs ROOT 6.28+ with ROOTNTuple)";
+        return false;
+    }
+
+    Input scanInput;
+    if (!OpenInput(inputPath, options, scanInput, message)) return false;
+    const size_t   nCols = scanInput.headers.size();
+    const Long64_t size  = DataReader::FileSize(inputPath);
+    if (progress) progress->total = 2 * size;   // both passes read the whole file
+
+    ThreadPool pool(options.nThreads);
+
+    // Pass 1: column types
+    std::vector<ColumnType> types(nCols, kInt);
+    size_t nRows = 0;
+    const char delim = options.delim;
+    bool complete = RunChunks(scanInput, options, pool, progress, 0,
+        [delim, nCols](const Lines& lines) { return ScanChunk(lines, delim, nCols); },
+        [&](Scan scan) {
+            for (size_t c = 0; c < nCols; ++c)
+                if (scan.types[c] > types[c]) types[c] = scan.types[c];
+            nRows += scan.rows;
+        });
+    if (!complete) {
+        message = "Conversion cancelled";
+        return false;
+    }
+    if (nRows == 0) {
+        message = "No data rows in " + inputPath;
+        return false;
+    }
+
+    // Branch names, unique
+    std::vector<std::string> names;
+    std::set<std::string>    used;
+    std::string              renamed;
+    for (const auto& header : scanInput.headers) {
+        std::string base = BranchName(header), name = base;
+        for (int n = 2; !used.insert(name).second; ++n) name = base + "_" + std::to_string(n);
+        if (name != header) renamed += "  " + header + " -> " + name + "\n";
+        names.push_back(name);
+    }
+
+    // Pass 2: typed values into the output
+    Input writeInput;
+    if (!OpenInput(inputPath, options, writeInput, message)) return false;
+    Long64_t written = 0;
+    bool ok;
+    if (options.format == kRNTuple) {
+#ifdef APG_HAVE_RNTUPLE
+        NTupleSink sink;
+        ok = WriteRows(sink, rootPath, writeInput, options, names, types, pool,
+                       progress, size, written, message);
+#else
+        ok = false;
+#endif
+    } else {
+        TreeSink sink;
+        ok = WriteRows(sink, rootPath, writeInput, options, names, types, pool,
+                       progress, size, written, message);
+    }
+    if (!ok) return false;
+    if (progress) progress->processed = 2 * size;
+
+    int count[3] = { 0, 0, 0 };
+    for (ColumnType t : types) ++count[t];
+    message = Form("Wrote %lld rows x %zu columns to %s\n"
+                   "as %s '%s' (%d %s, %d %s, %d %s)",
+                   written, nCols, rootPath.c_str(),
+                   options.format == kRNTuple ? "RNTuple" : "TTree", options.treeName.c_str(),
+                   count[kInt], TypeName(kInt), count[kLong], TypeName(kLong),
+                   count[kDouble], TypeName(kDouble));
+    if (!renamed.empty()) message += "\nRenamed columns:\n" + renamed;
+    return true;
+}
@@ -0,0 +1,508 @@
+#include "ColumnExpression.h"
+#include "RowSelection.h"
+#include "ThreadPool.h"
+
+#include <TMath.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <future>
+#include <limits>
+
+// ============================================================================
+// Functions callable from expressions
+// ============================================================================
+namespace {
+
+struct Function1 { const char* name; double (*fn)(double); };
+struct Function2 { const char* name; double (*fn)(double, double); };
+
+double Abs(double x)   { return std::fabs(x); }
+double Min(double a, double b) { return std::fmin(a, b); }
+double Max(double a, double b) { return std::fmax(a, b); }
+
+const Function1 kFunctions1[] = {
+    { "sqrt",  [](double x) { return std::sqrt(x);  } },
+    { "abs",   Abs },
+    { "exp",   [](double x) { return std::exp(x);   } },
+    { "log",   [](double x) { return std::log(x);   } },
+    { "log10", [](double x) { return std::log10(x); } },
+    { "sin",   [](double x) { return std::sin(x);   } },
+    { "cos",   [](double x) { return std::cos(x);   } },
+    { "tan",   [](double x) { return std::tan(x);   } },
+    { "asin",  [](double x) { return std::asin(x);  } },
+    { "acos",  [](double x) { return std::acos(x);  } },
+    { "atan",  [](double x) { return std::atan(x);  } },
+    { "sinh",  [](double x) { return std::sinh(x);  } },
+    { "cosh",  [](double x) { return std::cosh(x);  } },
+    { "tanh",  [](double x) { return std::tanh(x);  } },
+    { "floor", [](double x) { return std::floor(x); } },
+    { "ceil",  [](double x) { return std::ceil(x);  } },
+};
+
+const Function2 kFunctions2[] = {
+    { "pow",   [](double a, double b) { return std::pow(a, b);   } },
+    { "atan2", [](double a, double b) { return std::atan2(a, b); } },
+    { "hypot", [](double a, double b) { return std::hypot(a, b); } },
+    { "min",   Min },
+    { "max",   Max },
+};
+
+template <class T, size_t N>
+int FindFunction(const T (&table)[N], const std::string& name)
+{
+    for (size_t i = 0; i < N; ++i)
+        if (name == table[i].name) return (int)i;
+    return -1;
+}
+
+} // namespace
+
+// ============================================================================
+// Parser — recursive descent straight to postfix code
+//   expr  := and ('||' and)*
+//   and   := cmp ('&&' cmp)*
+//   cmp   := sum (('<' | '<=' | '>' | '>=' | '==' | '!=') sum)?
+//   sum   := term (('+' | '-') term)*
+//   term  := unary (('*' | '/') unary)*
+//   unary := ('-' | '+' | '!') unary | power
+//   power := primary (('^' | '**') unary)?
+// ============================================================================
+class ColumnExpression::Parser {
+public:
+    Parser(const std::string& text, const std::vector<std::string>& headers,
+           ColumnExpression& target, bool anyColumn = false)
+        : fText(text), fHeaders(headers), fTarget(target), fAnyColumn(anyColumn) {}
+
+    bool Run(std::string& error) {
+        bool ok = Expr() && (Skip(), fPos == fText.size() || Fail("unexpected '" + fText.substr(fPos, 1) + "'"));
+        if (!ok) error = fError + " at position " + std::to_string(fErrorPos + 1);
+        return ok;
+    }
+
+private:
+    const std::string&              fText;
+    const std::vector<std::string>& fHeaders;
+    ColumnExpression&               fTarget;
+    bool                            fAnyColumn;
+    size_t                          fPos   = 0;
+    int                             fDepth = 0;
+    std::string                     fError;
+    size_t                          fErrorPos = 0;
+
+    bool Fail(const std::string& message) {
+        if (fError.empty()) { fError = message; fErrorPos = fPos; }
+        return false;
+    }
+    void Skip() {
+        while (fPos < fText.size() && std::isspace((unsigned char)fText[fPos])) ++fPos;
+    }
+    bool Accept(const char* token) {
+        Skip();
+        size_t n = std::char_traits<char>::length(token);
+        if (fText.compare(fPos, n, token) != 0) return false;
+        fPos += n;
+        return true;
+    }
+
+    void Emit(Instr instr, int depthChange) {
+        auto& code = fTarget.fCode;
+        // Constant folding: an operator whose operands are all constants
+        size_t operands = instr.op == kNeg || instr.op == kNot || instr.op == kCall1 ? 1
+                        : instr.op == kConst || instr.op == kColumn ? 0 : 2;
+        if (operands > 0 && code.size() >= operands &&
+            std::all_of(code.end() - operands, code.end(),
+                        [](const Instr& i) { return i.op == kConst; })) {
+            double a = code[code.size() - operands].value;
+            double b = operands == 2 ? code.back().value : 0.0;
+            code.resize(code.size() - operands);
+            Instr folded{ kConst };
+            folded.value = Apply(instr, a, b);
+            code.push_back(folded);
+            fDepth -= (int)operands - 1;
+            return;
+        }
+        code.push_back(instr);
+        fDepth += depthChange;
+        fTarget.fMaxDepth = std::max(fTarget.fMaxDepth, fDepth);
+    }
+
+    static double Apply(const Instr& instr, double a, double b) {
+        switch (instr.op) {
+            case kAdd:   return a + b;
+            case kSub:   return a - b;
+            case kMul:   return a * b;
+            case kDiv:   return a / b;
+            case kPow:   return std::pow(a, b);
+            case kNeg:   return -a;
+            case kLt:    return a <  b;
+            case kLe:    return a <= b;
+            case kGt:    return a >  b;
+            case kGe:    return a >= b;
+            case kEq:    return a == b;
+            case kNe:    return a != b;
+            case kAnd:   return a != 0 && b != 0;
+            case kOr:    return a != 0 || b != 0;
+            case kNot:   return a == 0;
+            case kCall1: return kFunctions1[instr.arg].fn(a);
+            case kCall2: return kFunctions2[instr.arg].fn(a, b);
+            default:     return 0.0;
+        }
+    }
+
+    bool Expr() {
+        if (!And()) return false;
+        while (Accept("||")) {
+            if (!And()) return false;
+            Emit({ kOr }, -1);
+        }
+        return true;
+    }
+
+    bool And() {
+        if (!Compare()) return false;
+        while (Accept("&&")) {
+            if (!Compare()) return false;
+            Emit({ kAnd }, -1);
+        }
+        return true;
+    }
+
+    bool Compare() {
+        if (!Sum()) return false;
+        static const std::pair<const char*, Op> kComparisons[] = {   // two-character first
+            { "<=", kLe }, { ">=", kGe }, { "==", kEq }, { "!=", kNe }, { "<", kLt }, { ">", kGt },
+        };
+        for (const auto& c : kComparisons) {
+            if (!Accept(c.first)) continue;
+            if (!Sum()) return false;
+            Emit({ c.second }, -1);
+            return true;
+        }
+        return true;
+    }
+
+    bool Sum() {
+        if (!Term()) return false;
+        for (;;) {
+            if (Accept("+"))      { if (!Term()) return false; Emit({ kAdd }, -1); }
+            else if (Accept("-")) { if (!Term()) return false; Emit({ kSub }, -1); }
+            else return true;
+        }
+    }
+
+    bool Term() {
+        if (!Unary()) return false;
+        for (;;) {
+            Skip();
+            if (fText.compare(fPos, 2, "**") == 0) return true;   // power, not product
+            if (Accept("*"))      { if (!Unary()) return false; Emit({ kMul }, -1); }
+            else if (Accept("/")) { if (!Unary()) return false; Emit({ kDiv }, -1); }
+            else return true;
+        }
+    }
+
+    bool Unary() {
+        if (Accept("-")) { if (!Unary()) return false; Emit({ kNeg }, 0); return true; }
+        if (Accept("+")) return Unary();
+        if (Skip(), fText.compare(fPos, 2, "!=") != 0 && Accept("!")) {
+            if (!Unary()) return false;
+            Emit({ kNot }, 0);
+            return true;
+        }
+        return Power();
+    }
+
+    bool Power() {
+        if (!Primary()) return false;
+        if (Accept("^") || Accept("**")) {   // right-associative: 2^3^2 = 2^9
+            if (!Unary()) return false;
+            Emit({ kPow }, -1);
+        }
+        return true;
+    }
+
+    bool Primary() {
+        Skip();
+        if (fPos >= fText.size()) return Fail("unexpected end of expression");
+        char c = fText[fPos];
+
+        if (Accept("(")) {
+            if (!Expr()) return false;
+            return Accept(")") || Fail("missing ')'");
+        }
+        if (std::isdigit((unsigned char)c) || c == '.') {
+            const char* begin = fText.c_str() + fPos;
+            char* end = nullptr;
+            double value = std::strtod(begin, &end);
+            if (end == begin) return Fail("bad number");
+            fPos += end - begin;
+            Instr instr{ kConst };
+            instr.value = value;
+            Emit(instr, +1);
+            return true;
+        }
+        if (c == '`') {
+            size_t close = fText.find('`', fPos + 1);
+            if (close == std::string::npos) return Fail("missing closing '`'");
+            std::string name = fText.substr(fPos + 1, close - fPos - 1);
+            fPos = close + 1;
+            return Column(name) || Fail("no column named '" + name + "'");
+        }
+        if (std::isalpha((unsigned char)c) || c == '_') {
+            size_t start = fPos;
+            while (fPos < fText.size() &&
+                   (std::isalnum((unsigned char)fText[fPos]) || fText[fPos] == '_' || fText[fPos] == '.'))
+                ++fPos;
+            std::string name = fText.substr(start, fPos - start);
+            Skip();
+            if (fPos < fText.size() && fText[fPos] == '(') return Call(name, start);
+            if (Column(name)) return true;
+            if (name == "pi" || name == "e") {
+                Instr instr{ kConst };
+                instr.value = name == "pi" ? TMath::Pi() : TMath::E();
+                Emit(instr, +1);
+                return true;
+            }
+            fPos = start;
+            return Fail("no column named '" + name + "'");
+        }
+        return Fail(std::string("unexpected '") + c + "'");
+    }
+
+    bool Column(const std::string& name) {
+        auto it = std::find(fHeaders.begin(), fHeaders.end(), name);
+        if (it == fHeaders.end() && !fAnyColumn) return false;
+        Instr instr{ kColumn };
+        instr.arg = (int)(it - fHeaders.begin());
+        Emit(instr, +1);
+        if (fAnyColumn) return true;
+        auto& inputs = fTarget.fInputs;
+        if (std::find(inputs.begin(), inputs.end(), instr.arg) == inputs.end())
+            inputs.push_back(instr.arg);
+        return true;
+    }
+
+    bool Call(const std::string& name, size_t start) {
+        int f1 = FindFunction(kFunctions1, name);
+        int f2 = FindFunction(kFunctions2, name);
+        if (f1 < 0 && f2 < 0) { fPos = start; return Fail("unknown function '" + name + "'"); }
+
+        Accept("(");
+        int args = 0;
+        if (!Accept(")")) {
+            do {
+                if (!Expr()) return false;
+                ++args;
+            } while (Accept(","));
+            if (!Accept(")")) return Fail("missing ')'");
+        }
+        int wanted = f1 >= 0 ? 1 : 2;
+        if (args != wanted) {
+            fPos = start;
+            return Fail(name + "() takes " + std::to_string(wanted) + " argument" +
+                        (wanted > 1 ? "s" : ""));
+        }
+        Instr instr{ f1 >= 0 ? kCall1 : kCall2 };
+        instr.arg = f1 >= 0 ? f1 : f2;
+        Emit(instr, f1 >= 0 ? 0 : -1);
+        return true;
+    }
+};
+
+// ============================================================================
+// Compilation
+// ============================================================================
+bool ColumnExpression::Compile(const std::string& text, const std::vector<std::string>& headers,
+                               std::string& error)
+{
+    fText = text;
+    fCode.clear();
+    fInputs.clear();
+    fMaxDepth = 0;
+
+    Parser parser(text, headers, *this);
+    if (!parser.Run(error)) {
+        fCode.clear();
+        fInputs.clear();
+        return false;
+    }
+    fMaxDepth = std::max(fMaxDepth, 1);
+    return true;
+}
+
+bool ColumnExpression::CheckSyntax(const std::string& text, std::string& error)
+{
+    const std::vector<std::string> noHeaders;
+    ColumnExpression scratch;
+    Parser parser(text, noHeaders, scratch, true);
+    return parser.Run(error);
+}
+
+// ============================================================================
+// Evaluation
+// ============================================================================
+size_t ColumnExpression::NumRows(const ColumnData& data) const
+{
+    size_t n = fInputs.empty() ? (size_t)data.GetNumRows() : SIZE_MAX;
+    for (int c : fInputs) {
+        if (c >= (int)data.data.size()) return 0;   // compiled against another table
+        n = std::min(n, data.data[c].size());
+    }
+    return n;
+}
+
+void ColumnExpression::Evaluate(const ColumnData& data, ColumnData::Column& out) const
+{
+    out.clear();
+    if (fCode.empty()) return;
+    size_t n = NumRows(data);
+    out.resize(n);
+    double* o = out.data();
+    ForEachBlock(data, n, [o](size_t row, size_t count, const double* values) {
+        std::copy(values, values + count, o + row);
+    });
+
+    // A null input makes the value NaN, whatever the expression does with it
+    for (int c : fInputs) {
+        const ValidityBitmap* valid = data.Validity(c);
+        if (!valid) continue;
+        size_t nWords = std::min(valid->NumWords(), (n + 63) / 64);
+        for (size_t w = 0; w < nWords; ++w) {
+            for (uint64_t nulls = ~valid->Words()[w]; nulls; nulls &= nulls - 1) {
+                size_t row = w * 64 + RowSelection::CountTrailingZeros(nulls);
+                if (row < n) o[row] = std::numeric_limits<double>::quiet_NaN();
+            }
+        }
+    }
+}
+
+void ColumnExpression::Select(const ColumnData& data, RowSelection& out) const
+{
+    size_t n = fCode.empty() ? 0 : NumRows(data);
+    out = RowSelection(n);
+    if (n == 0) return;
+    // kBlock is a multiple of 64, so blocks (and threads) own whole words
+    uint64_t* words = out.Words();
+    ForEachBlock(data, n, [words](size_t row, size_t count, const double* values) {
+        uint64_t* w = words + row / 64;
+        for (size_t i = 0; i < count; i += 64) {
+            uint64_t bits = 0;
+            size_t   m    = std::min<size_t>(64, count - i);
+            for (size_t b = 0; b < m; ++b) {
+                double v = values[i + b];
+                bits |= uint64_t((v != 0) & (v == v)) << b;   // NaN != 0 too
+            }
+            w[i / 64] = bits;
+        }
+    });
+
+    // Rows where an input is null are never selected
+    for (int c : fInputs) {
+        if (const ValidityBitmap* valid = data.Validity(c)) {
+            size_t nWords = std::min(valid->NumWords(), out.NumWords());
+            for (size_t w = 0; w < nWords; ++w) words[w] &= valid->Words()[w];
+        }
+    }
+}
+
+// sink(row, count, values) for every block of rows [0, n), on several
+// threads for large n (whole blocks per thread, each with its own stack)
+template <class Sink>
+void ColumnExpression::ForEachBlock(const ColumnData& data, size_t n, Sink sink) const
+{
+    auto range = [this, &data, &sink](size_t begin, size_t end) {
+        std::vector<double>        scratch((size_t)fMaxDepth * kBlock);
+        std::vector<const double*> slot(fMaxDepth);
+        for (size_t row = begin; row < end; row += kBlock) {
+            size_t count = std::min<size_t>(kBlock, end - row);
+            sink(row, count, RunBlock(data, row, count, scratch.data(), slot.data()));
+        }
+    };
+
+    if (n < (size_t)kParallelRows) {
+        range(0, n);
+        return;
+    }
+    unsigned nThreads = ThreadPool::DefaultSize();
+    size_t   chunk    = ((n + nThreads - 1) / nThreads + kBlock - 1) / kBlock * kBlock;
+    ThreadPool pool(nThreads);
+    std::vector<std::future<void>> done;
+    for (size_t begin = 0; begin < n; begin += chunk) {
+        size_t end = std::min(n, begin + chunk);
+        done.push_back(pool.Submit([&range, begin, end]() { range(begin, end); }));
+    }
+    for (auto& f : done) f.get();
+}
+
+// Runs the program over rows [row, row + n), n <= kBlock. Each stack slot
+// points either into a column (no copy) or at its own scratch block; the
+// result is one of them.
+const double* ColumnExpression::RunBlock(const ColumnData& data, size_t row, size_t n,
+                                         double* scratch, const double** slot) const
+{
+    int sp = 0;
+    for (const Instr& instr : fCode) {
+        switch (instr.op) {
+            case kColumn:
+                slot[sp++] = data.data[instr.arg].data() + row;
+                break;
+            case kConst: {
+                double* b = scratch + (size_t)sp * kBlock;
+                std::fill(b, b + n, instr.value);
+                slot[sp++] = b;
+                break;
+            }
+            case kNeg: {
+                const double* a = slot[sp - 1];
+                double* buffer = scratch + (size_t)(sp - 1) * kBlock;
+                for (size_t i = 0; i < n; ++i) buffer[i] = -a[i];
+                slot[sp - 1] = buffer;
+                break;
+            }
+            case kNot: {
+                const double* a = slot[sp - 1];
+                double* buffer = scratch + (size_t)(sp - 1) * kBlock;
+                for (size_t i = 0; i < n; ++i) buffer[i] = a[i] == 0;
+                slot[sp - 1] = buffer;
+                break;
+            }
+            case kCall1: {
+                const double* a = slot[sp - 1];
+                double* buffer = scratch + (size_t)(sp - 1) * kBlock;
+                double (*fn)(double) = kFunctions1[instr.arg].fn;
+                for (size_t i = 0; i < n; ++i) buffer[i] = fn(a[i]);
+                slot[sp - 1] = buffer;
+                break;
+            }
+            default: {   // binary: result in the lower slot's scratch
+                const double* a = slot[sp - 2];
+                const double* b = slot[sp - 1];
+                double* r = scratch + (size_t)(sp - 2) * kBlock;
+                switch (instr.op) {
+                    case kAdd: for (size_t i = 0; i < n; ++i) r[i] = a[i] + b[i]; break;
+                    case kSub: for (size_t i = 0; i < n; ++i) r[i] = a[i] - b[i]; break;
+                    case kMul: for (size_t i = 0; i < n; ++i) r[i] = a[i] * b[i]; break;
+                    case kDiv: for (size_t i = 0; i < n; ++i) r[i] = a[i] / b[i]; break;
+                    case kPow: for (size_t i = 0; i < n; ++i) r[i] = std::pow(a[i], b[i]); break;
+                    case kLt:  for (size_t i = 0; i < n; ++i) r[i] = a[i] <  b[i]; break;
+                    case kLe:  for (size_t i = 0; i < n; ++i) r[i] = a[i] <= b[i]; break;
+                    case kGt:  for (size_t i = 0; i < n; ++i) r[i] = a[i] >  b[i]; break;
+                    case kGe:  for (size_t i = 0; i < n; ++i) r[i] = a[i] >= b[i]; break;
+                    case kEq:  for (size_t i = 0; i < n; ++i) r[i] = a[i] == b[i]; break;
+                    case kNe:  for (size_t i = 0; i < n; ++i) r[i] = a[i] != b[i]; break;
+                    case kAnd: for (size_t i = 0; i < n; ++i) r[i] = (a[i] != 0) & (b[i] != 0); break;
+                    case kOr:  for (size_t i = 0; i < n; ++i) r[i] = (a[i] != 0) | (b[i] != 0); break;
+                    default: {
+                        double (*fn)(double, double) = kFunctions2[instr.arg].fn;
+                        for (size_t i = 0; i < n; ++i) r[i] = fn(a[i], b[i]);
+                    }
+                }
+                slot[--sp - 1] = r;
+            }
+        }
+    }
+    return slot[0];
+}
@@ -0,0 +1,152 @@
+#include "ColumnGraphErrors.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+
+// ============================================================================
+// Shared zeros
+// ============================================================================
+std::shared_ptr<const double> ColumnGraphErrors::ZeroBuffer(size_t n)
+{
+    static std::mutex                  mutex;
+    static std::weak_ptr<const double> cached;
+    static size_t                      cachedSize = 0;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (auto zeros = cached.lock())
+        if (cachedSize >= n) return zeros;
+
+    // Larger than any before: a new block; graphs on the old one keep it
+    void* raw = std::calloc(std::max<size_t>(n, 1), sizeof(double));
+    if (!raw) return nullptr;
+    std::shared_ptr<const double> zeros(static_cast<const double*>(raw),
+                                        [](const double* p) { std::free(const_cast<double*>(p)); });
+    cached     = zeros;
+    cachedSize = n;
+    return zeros;
+}
+
+// ============================================================================
+// Construction
+// ============================================================================
+ColumnGraphErrors::ColumnGraphErrors(std::shared_ptr<const ColumnData> data,
+                                     int xColumn, int yColumn,
+                                     int xErrColumn, int yErrColumn, Int_t n)
+    : TGraphErrors(), fData(std::move(data))
+{
+    std::shared_ptr<const ColumnData> table = fData;   // outlives a Materialize() below
+    auto column = [&table](int c) {   // never written while borrowed
+        return const_cast<Double_t*>(table->data[c].data());
+    };
+
+    SetEditable(kFALSE);   // dragging a point would move it in the table
+    fNpoints = n;
+    fMaxSize = n;
+    fX = column(xColumn);
+    fY = column(yColumn);
+    if (xErrColumn < 0 || yErrColumn < 0) {
+        fZeros = ZeroBuffer(n);
+        if (!fZeros) {   // no zeros to point at: own arrays after all
+            fEX = xErrColumn >= 0 ? column(xErrColumn) : nullptr;
+            fEY = yErrColumn >= 0 ? column(yErrColumn) : nullptr;
+            Materialize();
+            return;
+        }
+    }
+    Double_t* zeros = const_cast<Double_t*>(fZeros.get());
+    fEX = xErrColumn >= 0 ? column(xErrColumn) : zeros;
+    fEY = yErrColumn >= 0 ? column(yErrColumn) : zeros;
+}
+
+ColumnGraphErrors::~ColumnGraphErrors()
+{
+    if (fData) fX = fY = fEX = fEY = nullptr;   // not ours for the base to delete
+}
+
+void ColumnGraphErrors::Materialize()
+{
+    if (!fData) return;
+    auto copy = [this](const Double_t* from) {
+        Double_t* to = new Double_t[fMaxSize];
+        if (from) std::copy(from, from + fNpoints, to);
+        else      std::fill(to, to + fMaxSize, 0.0);
+        return to;
+    };
+    fX  = copy(fX);
+    fY  = copy(fY);
+    fEX = copy(fEX);
+    fEY = copy(fEY);
+    fData.reset();
+    fZeros.reset();
+}
+
+// ============================================================================
+// Point changes
+// ============================================================================
+void ColumnGraphErrors::SetPoint(Int_t i, Double_t x, Double_t y)
+{
+    Materialize();
+    TGraphErrors::SetPoint(i, x, y);
+}
+
+void ColumnGraphErrors::Set(Int_t n)
+{
+    Materialize();
+    TGraphErrors::Set(n);
+}
+
+Int_t ColumnGraphErrors::InsertPoint()
+{
+    Materialize();
+    return TGraphErrors::InsertPoint();
+}
+
+Int_t ColumnGraphErrors::RemovePoint(Int_t ipoint)
+{
+    Materialize();
+    return TGraphErrors::RemovePoint(ipoint);
+}
+
+void ColumnGraphErrors::SetPointX(Int_t i, Double_t x)
+{
+    Materialize();
+    TGraphErrors::SetPointX(i, x);
+}
+
+void ColumnGraphErrors::SetPointY(Int_t i, Double_t y)
+{
+    Materialize();
+    TGraphErrors::SetPointY(i, y);
+}
+
+void ColumnGraphErrors::Apply(TF1* f)
+{
+    Materialize();
+    TGraphErrors::Apply(f);
+}
+
+void ColumnGraphErrors::Scale(Double_t c1, Option_t* option)
+{
+    Materialize();
+    TGraphErrors::Scale(c1, option);
+}
+
+void ColumnGraphErrors::Sort(Bool_t (*greater)(const TGraph*, Int_t, Int_t),
+                             Bool_t ascending, Int_t low, Int_t high)
+{
+    Materialize();
+    TGraphErrors::Sort(greater, ascending, low, high);
+}
+
+void ColumnGraphErrors::SetPointError(Double_t ex, Double_t ey)
+{
+    Materialize();
+    TGraphErrors::SetPointError(ex, ey);
+}
+
+void ColumnGraphErrors::SetPointError(Int_t i, Double_t ex, Double_t ey)
+{
+    Materialize();
+    TGraphErrors::SetPointError(i, ex, ey);
+}
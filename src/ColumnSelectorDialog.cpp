@@ -1,4 +1,6 @@
 #include "ColumnSelectorDialog.h"
+#include "RowSelection.h"
+#include "ErrorHandling.h"
 
 // ROOT dictionary macro
 ClassImp(ColumnSelectorDialog)
@@ -66,6 +68,14 @@ ColumnSelectorDialog::ColumnSelectorDialog(const TGWindow* parent,
     h3Group->AddFrame(radioTH3I, new TGLayoutHints(kLHintsLeft,5,5,2,2));
     typeGroup->AddFrame(h3Group, new TGLayoutHints(kLHintsExpandX,5,5,2,2));
 
+    // Profile types
+    TGGroupFrame* profGroup = new TGGroupFrame(typeGroup, "Profiles");
+    radioTProfile = new TGCheckButton(profGroup, "TProfile (mean of y in bins of x)", 12);
+    radioTProfile2D = new TGCheckButton(profGroup, "TProfile2D (mean of z in bins of x, y)", 13);
+    profGroup->AddFrame(radioTProfile, new TGLayoutHints(kLHintsLeft,5,5,2,2));
+    profGroup->AddFrame(radioTProfile2D, new TGLayoutHints(kLHintsLeft,5,5,2,2));
+    typeGroup->AddFrame(profGroup, new TGLayoutHints(kLHintsExpandX,5,5,2,2));
+
     // Default selection
     radioTGraph->SetOn();
 
@@ -81,6 +91,8 @@ ColumnSelectorDialog::ColumnSelectorDialog(const TGWindow* parent,
     radioTH3D->Connect("Clicked()", "ColumnSelectorDialog", this, "UpdateColumnVisibility()");
     radioTH3F->Connect("Clicked()", "ColumnSelectorDialog", this, "UpdateColumnVisibility()");
     radioTH3I->Connect("Clicked()", "ColumnSelectorDialog", this, "UpdateColumnVisibility()");
+    radioTProfile->Connect("Clicked()", "ColumnSelectorDialog", this, "UpdateColumnVisibility()");
+    radioTProfile2D->Connect("Clicked()", "ColumnSelectorDialog", this, "UpdateColumnVisibility()");
 
     mainFrame->AddFrame(typeGroup, new TGLayoutHints(kLHintsExpandX,5,5,5,5));
 
@@ -152,6 +164,31 @@ ColumnSelectorDialog::ColumnSelectorDialog(const TGWindow* parent,
     yErrFrame->AddFrame(yErrCombo, new TGLayoutHints(kLHintsLeft,5,5,2,2));
     colFrame->AddFrame(yErrFrame, new TGLayoutHints(kLHintsExpandX,5,5,2,2));
 
+    // Weight column (histograms and profiles)
+    TGHorizontalFrame* weightFrame = new TGHorizontalFrame(colFrame);
+    TGLabel* weightLabel = new TGLabel(weightFrame, "Weight:");
+    weightLabel->SetWidth(100);
+    weightFrame->AddFrame(weightLabel, new TGLayoutHints(kLHintsLeft|kLHintsCenterY,5,5,2,2));
+    weightCombo = new TGComboBox(weightFrame);
+    weightCombo->AddEntry("None", -1);
+    for(int i=0;i<data->GetNumColumns();++i) weightCombo->AddEntry(data->headers[i].c_str(), i);
+    weightCombo->Select(-1);
+    weightCombo->Resize(200,20);
+    weightFrame->AddFrame(weightCombo, new TGLayoutHints(kLHintsLeft,5,5,2,2));
+    colFrame->AddFrame(weightFrame, new TGLayoutHints(kLHintsExpandX,5,5,2,2));
+
+    // Cut: only the rows it accepts are plotted
+    TGHorizontalFrame* cutFrame = new TGHorizontalFrame(colFrame);
+    TGLabel* cutLabel = new TGLabel(cutFrame, "Cut:");
+    cutLabel->SetWidth(100);
+    cutFrame->AddFrame(cutLabel, new TGLayoutHints(kLHintsLeft|kLHintsCenterY,5,5,2,2));
+    cutEntry = new TGTextEntry(cutFrame);
+    cutEntry->SetText(config->cut.c_str());
+    cutEntry->SetToolTipText("Rows to plot, e.g.  pt > 20 && abs(eta) < 2.4  (empty = all rows)");
+    cutEntry->Resize(200,20);
+    cutFrame->AddFrame(cutEntry, new TGLayoutHints(kLHintsLeft|kLHintsExpandX,5,5,2,2));
+    colFrame->AddFrame(cutFrame, new TGLayoutHints(kLHintsExpandX,5,5,2,2));
+
     colGroup->AddFrame(colFrame, new TGLayoutHints(kLHintsExpandX,5,5,5,5));
     mainFrame->AddFrame(colGroup, new TGLayoutHints(kLHintsExpandX,5,5,5,5));
 
@@ -189,11 +226,23 @@ void ColumnSelectorDialog::PopulateComboBox(TGComboBox* combo, int startIdx) {
 }
 
 void ColumnSelectorDialog::DoOK() {
+    // A bad cut keeps the dialog open; a good one is evaluated (and cached) now
+    std::string cut = cutEntry->GetText();
+    if (!cut.empty()) {
+        std::string error;
+        if (!CutCache::Instance().Get(*data, cut, error)) {
+            ShowWarning(this, "Cut", error.c_str());
+            return;
+        }
+    }
+    config->cut = cut;
+
     config->xColumn = xColumnCombo->GetSelected();
     config->yColumn = yColumnCombo->GetSelected();
     config->zColumn = zColumnCombo->GetSelected();
     config->xErrColumn = xErrCombo->GetSelected();
     config->yErrColumn = yErrCombo->GetSelected();
+    config->weightColumn = weightCombo->IsEnabled() ? weightCombo->GetSelected() : -1;
 
     // Determine plot type
     if (radioTGraph->IsOn()) config->type = PlotConfig::kTGraph;
@@ -207,6 +256,8 @@ void ColumnSelectorDialog::DoOK() {
     else if (radioTH3D->IsOn()) config->type = PlotConfig::kTH3D;
     else if (radioTH3F->IsOn()) config->type = PlotConfig::kTH3F;
     else if (radioTH3I->IsOn()) config->type = PlotConfig::kTH3I;
+    else if (radioTProfile->IsOn()) config->type = PlotConfig::kTProfile;
+    else if (radioTProfile2D->IsOn()) config->type = PlotConfig::kTProfile2D;
 
     if (config->xColumn >= 0 && config->xColumn < (int)data->headers.size())
         config->xTitle = data->headers[config->xColumn];
@@ -243,10 +294,13 @@ void ColumnSelectorDialog::UpdateColumnVisibility()
     bool h3d     = radioTH3D->IsOn();
     bool h3f     = radioTH3F->IsOn();
     bool h3i     = radioTH3I->IsOn();
+    bool p1      = radioTProfile->IsOn();
+    bool p2      = radioTProfile2D->IsOn();
 
     bool h1 = (h1d || h1f || h1i);
     bool h2 = (h2d || h2f || h2i);
     bool h3 = (h3d || h3f || h3i);
+    bool prof = (p1 || p2);
 
     // ---- Enforce single selection ----
     if(graph) {
@@ -254,17 +308,20 @@ void ColumnSelectorDialog::UpdateColumnVisibility()
         radioTH1D->SetOn(false); radioTH1F->SetOn(false); radioTH1I->SetOn(false);
         radioTH2D->SetOn(false); radioTH2F->SetOn(false); radioTH2I->SetOn(false);
         radioTH3D->SetOn(false); radioTH3F->SetOn(false); radioTH3I->SetOn(false);
+        radioTProfile->SetOn(false); radioTProfile2D->SetOn(false);
     }
     else if(graphE) {
         radioTGraph->SetOn(false);
         radioTH1D->SetOn(false); radioTH1F->SetOn(false); radioTH1I->SetOn(false);
         radioTH2D->SetOn(false); radioTH2F->SetOn(false); radioTH2I->SetOn(false);
         radioTH3D->SetOn(false); radioTH3F->SetOn(false); radioTH3I->SetOn(false);
+        radioTProfile->SetOn(false); radioTProfile2D->SetOn(false);
     }
     else if(h1) {
         radioTGraph->SetOn(false); radioTGraphErrors->SetOn(false);
         radioTH2D->SetOn(false); radioTH2F->SetOn(false); radioTH2I->SetOn(false);
         radioTH3D->SetOn(false); radioTH3F->SetOn(false); radioTH3I->SetOn(false);
+        radioTProfile->SetOn(false); radioTProfile2D->SetOn(false);
         // Allow only one TH1 type
         if(h1d) { radioTH1F->SetOn(false); radioTH1I->SetOn(false); }
         else if(h1f) { radioTH1D->SetOn(false); radioTH1I->SetOn(false); }
@@ -274,6 +331,7 @@ void ColumnSelectorDialog::UpdateColumnVisibility()
         radioTGraph->SetOn(false); radioTGraphErrors->SetOn(false);
         radioTH1D->SetOn(false); radioTH1F->SetOn(false); radioTH1I->SetOn(false);
         radioTH3D->SetOn(false); radioTH3F->SetOn(false); radioTH3I->SetOn(false);
+        radioTProfile->SetOn(false); radioTProfile2D->SetOn(false);
         // Allow only one TH2 type
         if(h2d) { radioTH2F->SetOn(false); radioTH2I->SetOn(false); }
         else if(h2f) { radioTH2D->SetOn(false); radioTH2I->SetOn(false); }
@@ -283,19 +341,29 @@ void ColumnSelectorDialog::UpdateColumnVisibility()
         radioTGraph->SetOn(false); radioTGraphErrors->SetOn(false);
         radioTH1D->SetOn(false); radioTH1F->SetOn(false); radioTH1I->SetOn(false);
         radioTH2D->SetOn(false); radioTH2F->SetOn(false); radioTH2I->SetOn(false);
+        radioTProfile->SetOn(false); radioTProfile2D->SetOn(false);
         // Allow only one TH3 type
         if(h3d) { radioTH3F->SetOn(false); radioTH3I->SetOn(false); }
         else if(h3f) { radioTH3D->SetOn(false); radioTH3I->SetOn(false); }
         else if(h3i) { radioTH3D->SetOn(false); radioTH3F->SetOn(false); }
     }
+    else if(prof) {
+        radioTGraph->SetOn(false); radioTGraphErrors->SetOn(false);
+        radioTH1D->SetOn(false); radioTH1F->SetOn(false); radioTH1I->SetOn(false);
+        radioTH2D->SetOn(false); radioTH2F->SetOn(false); radioTH2I->SetOn(false);
+        radioTH3D->SetOn(false); radioTH3F->SetOn(false); radioTH3I->SetOn(false);
+        // Allow only one profile type
+        if(p1) radioTProfile2D->SetOn(false);
+    }
 
     // ---- Enable / Disable columns ----
-    xColumnCombo->SetEnabled((graph || graphE || h1 || h2 || h3));
-    yColumnCombo->SetEnabled((graph || graphE || h2 || h3));
-    zColumnCombo->SetEnabled(h3);
+    xColumnCombo->SetEnabled((graph || graphE || h1 || h2 || h3 || prof));
+    yColumnCombo->SetEnabled((graph || graphE || h2 || h3 || prof));
+    zColumnCombo->SetEnabled(h3 || p2);
 
     xErrCombo->SetEnabled(graphE);
     yErrCombo->SetEnabled(graphE);
+    weightCombo->SetEnabled(h1 || h2 || h3 || prof);
     
     gClient->NeedRedraw(this);
 
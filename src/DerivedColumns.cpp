@@ -0,0 +1,151 @@
+#include "DerivedColumns.h"
+#include "ColumnExpression.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+std::string Trim(const std::string& s)
+{
+    size_t b = s.find_first_not_of(" \t\r\n");
+    if (b == std::string::npos) return "";
+    size_t e = s.find_last_not_of(" \t\r\n");
+    return s.substr(b, e - b + 1);
+}
+
+} // namespace
+
+// ============================================================================
+// Definitions
+// ============================================================================
+DerivedColumns& DerivedColumns::Instance()
+{
+    static DerivedColumns columns;
+    return columns;
+}
+
+bool DerivedColumns::Define(const std::string& name, const std::string& expression,
+                            std::string& error)
+{
+    if (name.empty()) {
+        error = "empty column name";
+        return false;
+    }
+    if (!ColumnExpression::CheckSyntax(expression, error)) return false;
+
+    std::lock_guard<std::mutex> lock(fMutex);
+    auto it = std::find_if(fDefs.begin(), fDefs.end(),
+                           [&name](const DerivedColumnDef& d) { return d.name == name; });
+    if (it != fDefs.end()) it->expression = expression;
+    else                   fDefs.push_back({ name, expression });
+    return true;
+}
+
+bool DerivedColumns::Remove(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    auto it = std::find_if(fDefs.begin(), fDefs.end(),
+                           [&name](const DerivedColumnDef& d) { return d.name == name; });
+    if (it == fDefs.end()) return false;
+    fDefs.erase(it);
+    return true;
+}
+
+void DerivedColumns::Clear()
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    fDefs.clear();
+}
+
+std::vector<DerivedColumnDef> DerivedColumns::GetDefinitions()
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    return fDefs;
+}
+
+bool DerivedColumns::ParseDefinition(const std::string& text, DerivedColumnDef& def,
+                                     std::string& error)
+{
+    size_t eq = text.find('=');
+    if (eq == std::string::npos) {
+        error = "expected 'name = expression'";
+        return false;
+    }
+    def.name       = Trim(text.substr(0, eq));
+    def.expression = Trim(text.substr(eq + 1));
+    if (def.name.size() > 1 && def.name.front() == '`' && def.name.back() == '`')
+        def.name = def.name.substr(1, def.name.size() - 2);
+    if (def.name.empty()) {
+        error = "missing column name";
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Applying definitions to a table
+// ============================================================================
+bool DerivedColumns::Apply(const std::vector<DerivedColumnDef>& defs,
+                           std::shared_ptr<ColumnData>& data, std::string& messages)
+{
+    if (!data) return false;
+    const size_t nDerived = data->derived.size();
+    const size_t nRaw     = data->headers.size() - nDerived;
+
+    // Derived columns the table has: all still defined as they were?
+    bool rebuild = false;
+    for (size_t i = 0; i < nDerived && !rebuild; ++i) {
+        const std::string& name = data->headers[nRaw + i];
+        auto it = std::find_if(defs.begin(), defs.end(),
+                               [&name](const DerivedColumnDef& d) { return d.name == name; });
+        rebuild = it == defs.end() || it->expression != data->derived[i];
+    }
+
+    // Compile what is missing against the columns it will be appended to
+    std::vector<std::string> headers(data->headers.begin(),
+                                     data->headers.end() - (rebuild ? nDerived : 0));
+    std::vector<std::pair<const DerivedColumnDef*, ColumnExpression>> pending;
+    for (const auto& def : defs) {
+        size_t at = std::find(headers.begin(), headers.end(), def.name) - headers.begin();
+        if (at < nRaw) {
+            messages += "'" + def.name + "' is already a column of the data\n";
+            continue;
+        }
+        if (at < headers.size()) continue;   // up to date
+        ColumnExpression expr;
+        std::string error;
+        if (!expr.Compile(def.expression, headers, error)) {
+            messages += "'" + def.name + "': " + error + "\n";
+            continue;
+        }
+        headers.push_back(def.name);
+        pending.emplace_back(&def, std::move(expr));
+    }
+    if (!rebuild && pending.empty()) return false;
+
+    // Plots may be borrowing this table: change a copy of it
+    if (rebuild || data.use_count() > 1) {
+        auto copy = std::make_shared<ColumnData>(*data);
+        if (rebuild) {
+            copy->headers.resize(nRaw);
+            copy->ResizeColumns(nRaw);
+            copy->derived.clear();
+            copy->Touch();   // columns past the raw ones change meaning
+        }
+        data = copy;
+    }
+
+    // NaN results (null inputs, rows past a shorter input, sqrt(-1), ...)
+    // are nulls of the new column
+    for (const auto& p : pending) {
+        ColumnData::Column values;
+        p.second.Evaluate(*data, values);
+        values.resize(data->GetNumRows(), std::numeric_limits<double>::quiet_NaN());
+        data->headers.push_back(p.first->name);
+        data->data.push_back(std::move(values));
+        data->NullsFromNaN((int)data->data.size() - 1);
+        data->derived.push_back(p.first->expression);
+    }
+    return true;
+}
@@ -5,6 +5,9 @@
 #include "RootDataInspector.h"
 #include "DataReader.h"
 #include "RootEntrySelector.h"
+#include "DerivedColumns.h"
+#include "CSVConverter.h"
+#include "RNTupleData.h"
 
 #include <TGFileDialog.h>
 #include <TGMsgBox.h>
@@ -20,6 +23,8 @@
 #include <TTree.h>
 #include <TBranch.h>
 #include <TObjArray.h>
+#include <TROOT.h>
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 
@@ -28,8 +33,14 @@
 // ============================================================================
 FileHandler::FileHandler(AdvancedPlotGUI* mainGUI)
     : fMainGUI(mainGUI),
-      fCurrentRootFile(nullptr)
+      fCurrentRootFile(nullptr),
+      fCurrentData(std::make_shared<ColumnData>()),
+      fPollTimer(nullptr),
+      fLoading(kFALSE),
+      fObjectsLoaded(0)
 {
+    // The GUI receives HandleTimer() and forwards it to PollLoad()
+    fPollTimer = new TTimer(fMainGUI, 50);
 }
 
 // ============================================================================
@@ -37,6 +48,16 @@ FileHandler::FileHandler(AdvancedPlotGUI* mainGUI)
 // ============================================================================
 FileHandler::~FileHandler()
 {
+    // Stop a running load before tearing anything down
+    fProgress.cancel = true;
+    if (fLoadThread.joinable()) fLoadThread.join();
+    if (fPollTimer) {
+        fPollTimer->TurnOff();
+        delete fPollTimer;
+        fPollTimer = nullptr;
+    }
+    for (auto& r : fLoadQueue.Drain()) delete r.object;
+
     if (fCurrentRootFile) {
         fCurrentRootFile->Close();
         delete fCurrentRootFile;
@@ -91,6 +112,73 @@ void FileHandler::OpenEntrySelector(const char* filepath)
     new RootEntrySelector(gClient->GetRoot(), filepath);
 }
 
+// ============================================================================
+// Convert a text file to ROOT for faster repeated analysis
+// ============================================================================
+void FileHandler::ConvertToROOT()
+{
+    if (fLoading) {
+        new TGMsgBox(gClient->GetRoot(), fMainGUI,
+            "Busy", Form("Still loading:\n%s\n\nCancel it first.", fLoadingPath.c_str()),
+            kMBIconExclamation, kMBOk);
+        return;
+    }
+
+    const char* inputTypes[] = {
+        "CSV files", "*.csv",
+        "Text files", "*.txt",
+        "Data files", "*.dat",
+        "All files", "*",
+        nullptr, nullptr
+    };
+    TGFileInfo inputInfo;
+    inputInfo.fFileTypes = inputTypes;
+    new TGFileDialog(gClient->GetRoot(), fMainGUI, kFDOpen, &inputInfo);
+    if (!inputInfo.fFilename || strlen(inputInfo.fFilename) == 0) return;
+    std::string input(inputInfo.fFilename);
+
+    // Same delimiter / header choices as loading the file
+    CSVPreviewDialog* preview = new CSVPreviewDialog(gClient->GetRoot(), input.c_str());
+    Int_t ret = preview->DoModal();
+    CSVConverter::Options options;
+    options.delim      = preview->GetDelimiter();
+    options.skipRows   = preview->GetSkipRows();
+    options.useHeader  = preview->UseHeaderRow();
+    options.autoHeader = false;
+    gSystem->ProcessEvents();
+    gSystem->Sleep(100);
+    delete preview;
+    if (ret != 1) return;
+
+    // The chosen file type picks the format
+    const char* outputTypes[] = {
+        "ROOT file (TTree)", "*.root",
+        "ROOT file (RNTuple)", "*.root",
+        nullptr, nullptr
+    };
+    TGFileInfo outputInfo;
+    outputInfo.fFileTypes = outputTypes;
+    TString defaultName = gSystem->BaseName(input.c_str());
+    if (defaultName.Last('.') > 0) defaultName.Remove(defaultName.Last('.'));
+    defaultName += ".root";
+    outputInfo.SetFilename(defaultName.Data());
+    outputInfo.SetIniDir(gSystem->GetDirName(input.c_str()).Data());
+    new TGFileDialog(gClient->GetRoot(), fMainGUI, kFDSave, &outputInfo);
+    if (!outputInfo.fFilename || strlen(outputInfo.fFilename) == 0) return;
+    std::string output(outputInfo.fFilename);
+    if (!TString(output.c_str()).EndsWith(".root")) output += ".root";
+    options.format = outputInfo.fFileTypeIdx == 2 ? CSVConverter::kRNTuple : CSVConverter::kTTree;
+
+    StartLoad(input, [this, input, output, options]() {
+        LoadResult r;
+        r.kind    = LoadResult::kConverted;
+        r.name    = output;
+        r.ok      = CSVConverter::Convert(input, output, options, r.message, &fProgress);
+        r.partial = fProgress.Cancelled();
+        fLoadQueue.Push(std::move(r));
+    });
+}
+
 // ============================================================================
 // Load file based on type
 // ============================================================================
@@ -103,6 +191,13 @@ void FileHandler::Load(const std::string& filepath)
         return;
     }
 
+    if (fLoading) {
+        new TGMsgBox(gClient->GetRoot(), fMainGUI,
+            "Busy", Form("Still loading:\n%s\n\nCancel it first.", fLoadingPath.c_str()),
+            kMBIconExclamation, kMBOk);
+        return;
+    }
+
     // Check if ROOT file
     TString filename(filepath.c_str());
     if (filename.EndsWith(".root")) {
@@ -116,20 +211,16 @@ void FileHandler::Load(const std::string& filepath)
         return;
     }
 
-    // Load other text data using DataReader
-    if (!DataReader::ReadFile(filepath, fCurrentData)) {
-        new TGMsgBox(gClient->GetRoot(), fMainGUI,
-            "Error", "Failed to load data file. Check console for details.",
-            kMBIconStop, kMBOk);
-        return;
-    }
-
-    fMainGUI->EnablePlotControls(true);
-
-    new TGMsgBox(gClient->GetRoot(), fMainGUI,
-        "Success", Form("Data loaded successfully!\nRows: %d\nColumns: %d",
-            fCurrentData.GetNumRows(), fCurrentData.GetNumColumns()),
-        kMBIconAsterisk, kMBOk);
+    // Load other text data using DataReader on the worker thread
+    StartLoad(filepath, [this, filepath]() {
+        auto data = std::make_shared<ColumnData>();
+        LoadResult r;
+        r.kind    = LoadResult::kColumnData;
+        r.ok      = DataReader::ReadFile(filepath, *data, &fProgress);
+        r.partial = fProgress.Cancelled();
+        r.data    = data;
+        fLoadQueue.Push(std::move(r));
+    });
 }
 
 // ============================================================================
@@ -165,7 +256,8 @@ void FileHandler::LoadRootFile(const char* filepath)
     gSystem->Sleep(100);
     delete browser;
     
-    // Open the file for our use
+    // Open the file for our use (TBrowser, tree info); object payloads
+    // are read on the loader thread through its own TFile handle
     fCurrentRootFile = TFile::Open(filepath, "READ");
     if (!fCurrentRootFile || fCurrentRootFile->IsZombie()) {
         new TGMsgBox(gClient->GetRoot(), nullptr,
@@ -183,38 +275,67 @@ void FileHandler::LoadRootFile(const char* filepath)
     // Handle selected objects
     if (ret == 1 && !selectedObjects.empty()) {
         std::cout << "\n=== Loading " << selectedObjects.size() << " objects ===" << std::endl;
-        
-        for (const auto& objInfo : selectedObjects) {
-            std::cout << "Loading: " << objInfo.name << " (" << objInfo.type << ")" << std::endl;
-            
-            // Get the object from file
-            TObject* obj = fCurrentRootFile->Get(objInfo.name.c_str());
-            if (!obj) {
-                std::cout << "  WARNING: Could not retrieve object!" << std::endl;
-                continue;
-            }
-            
-            // Handle different object types
-            if (objInfo.category == "Histogram") {
-                PlotHistogram(obj, objInfo.name.c_str());
-            } else if (objInfo.category == "Graph") {
-                PlotGraph(obj, objInfo.name.c_str());
-            } else if (objInfo.category == "Tree") {
-                ShowTreeInfo(obj, objInfo.name.c_str());
-            }
-        }
-        
-        std::cout << "=== Loading complete ===" << std::endl;
+        std::string path(filepath);
+        StartLoad(path, [this, path, selectedObjects]() {
+            LoadRootObjects(path, selectedObjects);
+        });
     }
-    
-    // Show summary message
-    if (ret == 1) {
-        new TGMsgBox(gClient->GetRoot(), fMainGUI,
-            "ROOT File Loaded",
-            Form("Loaded %d objects from ROOT file.\n\n"
-                 "Objects have been plotted in separate canvases.",
-                 (int)selectedObjects.size()),
-            kMBIconAsterisk, kMBOk);
+}
+
+// ============================================================================
+// Loader thread: read the selected objects and hand them to the GUI one by
+// one, so each is plotted as soon as it arrives (partial results).
+// ============================================================================
+void FileHandler::LoadRootObjects(const std::string& path,
+                                  const std::vector<ROOTObjectInfo>& objects)
+{
+    fProgress.total = (Long64_t)objects.size();
+
+    std::unique_ptr<TFile> file(TFile::Open(path.c_str(), "READ"));
+    if (!file || file->IsZombie()) {
+        LoadResult r;
+        r.kind    = LoadResult::kRootObject;
+        r.ok      = false;
+        r.message = "Cannot open ROOT file: " + path;
+        fLoadQueue.Push(std::move(r));
+        return;
+    }
+
+    for (const auto& objInfo : objects) {
+        if (fProgress.Cancelled()) break;
+
+        // An RNTuple becomes the table to plot from
+        if (objInfo.category == "RNTuple") {
+            auto data = std::make_shared<ColumnData>();
+            LoadResult r;
+            r.kind    = LoadResult::kColumnData;
+            fEntryProgress.processed = 0;
+            fEntryProgress.total     = 0;
+            r.ok      = RNTupleData::Read(path, objInfo.name, *data, &fEntryProgress, r.message);
+            r.partial = fEntryProgress.Cancelled();
+            r.data    = data;
+            fLoadQueue.Push(std::move(r));
+            ++fProgress.processed;
+            continue;
+        }
+
+        LoadResult r;
+        r.kind     = LoadResult::kRootObject;
+        r.name     = objInfo.name;
+        r.category = objInfo.category;
+
+        // Trees stay attached to the GUI thread's file; only their header
+        // is needed for ShowTreeInfo()
+        if (objInfo.category != "Tree") {
+            TObject* obj = file->Get(objInfo.name.c_str());
+            if (TH1* h = dynamic_cast<TH1*>(obj)) h->SetDirectory(nullptr);
+            r.object = obj;
+            r.ok     = (obj != nullptr);
+        }
+
+        fLoadQueue.Push(std::move(r));
+        ++fProgress.processed;
+        fProgress.rows = fProgress.processed.load();
     }
 }
 
@@ -253,105 +374,256 @@ void FileHandler::LoadCSVFile(const char* filepath)
 void FileHandler::LoadCSVWithSettings(const char* filepath, char delim, 
                                       Int_t skipRows, Bool_t useHeader)
 {
-    // CRITICAL: Clear old data first
-    fCurrentData = ColumnData();
-    
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
-        printf("ERROR: Cannot open file!\n");
-        new TGMsgBox(gClient->GetRoot(), fMainGUI,
-            "Error", Form("Cannot open: %s", filepath),
-            kMBIconStop, kMBOk);
-        return;
-    }
-    
-    std::string line;
-    int lineNum = 0;
+    std::string path(filepath);
+    StartLoad(path, [this, path, delim, skipRows, useHeader]() {
+        auto data = std::make_shared<ColumnData>();
+        LoadResult r;
+        r.kind    = LoadResult::kColumnData;
+        r.ok      = DataReader::ReadDelimitedFile(path, delim, skipRows, useHeader,
+                                                  false, *data, &fProgress);
+        r.partial = fProgress.Cancelled();
+        r.data    = data;
+        fLoadQueue.Push(std::move(r));
+    });
+}
 
-    // Skip rows
-    while (lineNum < skipRows && std::getline(file, line)) {
-        lineNum++;
-    }
+// ============================================================================
+// Start a background load: job runs on the loader thread and reports
+// through fLoadQueue / fProgress. A kFinished message is always appended.
+// ============================================================================
+void FileHandler::StartLoad(const std::string& path, std::function<void()> job)
+{
+    if (fLoadThread.joinable()) fLoadThread.join();
 
-    // Header row
-    if (useHeader && std::getline(file, line)) {
-        lineNum++;
-        std::stringstream ss(line);
-        std::string token;
-        while (std::getline(ss, token, delim)) {
-            // Trim whitespace
-            token.erase(0, token.find_first_not_of(" \t\r\n"));
-            token.erase(token.find_last_not_of(" \t\r\n") + 1);
-            if (!token.empty() && token.back() == '\r') token.pop_back();
-            fCurrentData.headers.push_back(token);
+    fProgress.Reset();
+    fEntryProgress.Reset();
+    fLoadQueue.Clear();
+    fLoadingPath   = path;
+    fLoading       = kTRUE;
+    fObjectsLoaded = 0;
+
+    fMainGUI->EnablePlotControls(kFALSE);
+    fMainGUI->SetLoadBusy(kTRUE, gSystem->BaseName(path.c_str()));
+
+    fLoadThread = std::thread([this, job]() {
+        try {
+            job();
+        } catch (const std::exception& e) {
+            LoadResult r;
+            r.kind    = LoadResult::kColumnData;
+            r.ok      = false;
+            r.message = e.what();
+            fLoadQueue.Push(std::move(r));
         }
-        
-        if (!fCurrentData.headers.empty()) {
-            fCurrentData.data.resize(fCurrentData.headers.size());
+        LoadResult done;
+        done.kind    = LoadResult::kFinished;
+        done.partial = fProgress.Cancelled();
+        fLoadQueue.Push(std::move(done));
+    });
+
+    fPollTimer->TurnOn();
+}
+
+// ============================================================================
+// Cancel a running load (GUI thread). The parser checks the flag every
+// DataReader::kProgressStride lines and keeps what it has read so far.
+// ============================================================================
+void FileHandler::CancelLoad()
+{
+    if (!fLoading) return;
+    fProgress.cancel      = true;
+    fEntryProgress.cancel = true;
+    std::cout << "Cancelling load of " << fLoadingPath << " ..." << std::endl;
+}
+
+// ============================================================================
+// Timer callback routed from AdvancedPlotGUI::HandleTimer()
+// ============================================================================
+Bool_t FileHandler::HandleTimer(TTimer* timer)
+{
+    if (timer != fPollTimer) return kFALSE;
+    PollLoad();
+    return kTRUE;
+}
+
+// ============================================================================
+// Drain the loader queue and refresh the progress display (GUI thread)
+// ============================================================================
+void FileHandler::PollLoad()
+{
+    if (!fLoading) return;
+
+    Long64_t done  = fProgress.processed.load();
+    Long64_t total = fProgress.total.load();
+    Long64_t rows  = fProgress.rows.load();
+    double   fraction = fProgress.Fraction();
+    TString status;
+    if (DataReader::GetFileType(fLoadingPath) == DataReader::kROOT) {
+        status.Form("%lld / %lld objects", done, total);
+        // An RNTuple being read counts as its share of one object
+        Long64_t entryTotal = fEntryProgress.total.load();
+        if (entryTotal > 0 && fEntryProgress.processed.load() < entryTotal && total > 0) {
+            status += Form("  |  dataset %.0f%%", 100.0 * fEntryProgress.Fraction());
+            fraction += fEntryProgress.Fraction() / total;
         }
+    } else {
+        status.Form("%.1f / %.1f MB  |  %lld rows",
+                    done / 1048576.0, total / 1048576.0, rows);
     }
+    fMainGUI->SetLoadProgress(100.0 * std::min(1.0, fraction), status.Data());
 
-    // Data rows
-    int dataRowCount = 0;
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
-        
-        std::stringstream ss(line);
-        std::string token;
-        std::vector<std::string> tokens;
-        
-        while (std::getline(ss, token, delim)) {
-            token.erase(0, token.find_first_not_of(" \t\r\n"));
-            token.erase(token.find_last_not_of(" \t\r\n") + 1);
-            if (!token.empty() && token.back() == '\r') token.pop_back();
-            tokens.push_back(token);
+    // The message boxes in HandleLoadResult() run a nested event loop; with
+    // the timer on, it would poll again from inside them and could finish
+    // the load (or finish it twice) before the outer result is handled
+    fPollTimer->TurnOff();
+    for (auto& result : fLoadQueue.Drain()) {
+        HandleLoadResult(result);
+        if (result.kind == LoadResult::kFinished) {
+            FinishLoad();
+            return;
         }
-        
-        // First data row — create default headers if not using header row
-        if (fCurrentData.data.empty() && !tokens.empty()) {
-            fCurrentData.data.resize(tokens.size());
-            if (fCurrentData.headers.empty()) {
-                for (size_t i = 0; i < tokens.size(); ++i) {
-                    fCurrentData.headers.push_back(Form("Col%zu", i));
-                }
+    }
+    fPollTimer->TurnOn();
+}
+
+void FileHandler::HandleLoadResult(LoadResult& result)
+{
+    switch (result.kind) {
+        case LoadResult::kColumnData: {
+            if (!result.ok || !result.data || result.data->GetNumRows() == 0) {
+                const char* why = result.message.empty()
+                    ? "No numeric data found in file.\nCheck delimiter and format."
+                    : result.message.c_str();
+                new TGMsgBox(gClient->GetRoot(), fMainGUI,
+                    result.partial ? "Cancelled" : "Warning",
+                    result.partial ? "Loading cancelled before any data was read." : why,
+                    kMBIconExclamation, kMBOk);
+                return;
             }
+
+            // CRITICAL: replace old data only once the new table is complete
+            fCurrentData = result.data;
+            fMainGUI->EnablePlotControls(kTRUE);
+
+            size_t nulls = 0;
+            for (int c = 0; c < fCurrentData->GetNumColumns(); ++c)
+                nulls += fCurrentData->NullCount(c);
+            std::string missing = nulls
+                ? "\nMissing values: " + std::to_string(nulls) + " (left out of plots)" : "";
+            new TGMsgBox(gClient->GetRoot(), fMainGUI,
+                result.partial ? "Partial Load" : "Success",
+                Form("%s\n\nColumns: %d\nRows: %d%s",
+                     result.partial ? "Loading cancelled - partial data kept."
+                                    : "Data loaded successfully!",
+                     fCurrentData->GetNumColumns(), fCurrentData->GetNumRows(),
+                     missing.c_str()),
+                kMBIconAsterisk, kMBOk);
+            break;
         }
-        
-        // Parse numeric values
-        size_t numCols = std::min(tokens.size(), fCurrentData.data.size());
-        for (size_t i = 0; i < numCols; ++i) {
-            try {
-                if (!tokens[i].empty()) {
-                    double val = std::stod(tokens[i]);
-                    fCurrentData.data[i].push_back(val);
-                }
-            } catch (...) { 
-                // Non-numeric value, skip
+
+        case LoadResult::kRootObject: {
+            if (!result.ok) {
+                std::cout << "  WARNING: Could not retrieve object "
+                          << result.name << " " << result.message << std::endl;
+                return;
+            }
+            std::cout << "Loading: " << result.name << " (" << result.category << ")" << std::endl;
+            ++fObjectsLoaded;
+
+            if (result.category == "Histogram") {
+                PlotHistogram(result.object, result.name.c_str());
+            } else if (result.category == "Graph") {
+                PlotGraph(result.object, result.name.c_str());
+            } else if (result.category == "Tree" && fCurrentRootFile) {
+                ShowTreeInfo(fCurrentRootFile->Get(result.name.c_str()), result.name.c_str());
+            } else {
+                delete result.object;
             }
+            break;
         }
-        dataRowCount++;
+
+        case LoadResult::kConverted:
+            std::cout << result.message << std::endl;
+            if (!result.ok) {
+                new TGMsgBox(gClient->GetRoot(), fMainGUI,
+                    result.partial ? "Cancelled" : "Conversion Failed",
+                    result.message.c_str(), kMBIconExclamation, kMBOk);
+                return;
+            }
+            fMainGUI->SetFilePath(result.name.c_str());
+            {
+                // Decided before kFinished is handled: PollLoad() is paused
+                // while the box is open
+                Int_t answer = kMBNo;
+                new TGMsgBox(gClient->GetRoot(), fMainGUI, "Converted",
+                    Form("%s\n\nLoad it for plotting now?\n"
+                         "(ROOT Analysis... also opens it.)", result.message.c_str()),
+                    kMBIconQuestion, kMBYes | kMBNo, &answer);
+                if (answer == kMBYes) fLoadAfterFinish = result.name;   // see FinishLoad()
+            }
+            break;
+
+        case LoadResult::kFinished:
+            if (DataReader::GetFileType(fLoadingPath) == DataReader::kROOT && fObjectsLoaded >= 0) {
+                std::cout << "=== Loading complete ===" << std::endl;
+                new TGMsgBox(gClient->GetRoot(), fMainGUI,
+                    "ROOT File Loaded",
+                    Form("Loaded %d objects from ROOT file%s.\n\n"
+                         "Objects have been plotted in separate canvases.",
+                         fObjectsLoaded, result.partial ? " (cancelled)" : ""),
+                    kMBIconAsterisk, kMBOk);
+            }
+            break;
     }
-    file.close();
+}
 
-    // CRITICAL: Check data validity and enable controls
-    bool hasData = !fCurrentData.data.empty() && fCurrentData.GetNumRows() > 0;
-    
-    if (hasData) {
-        fMainGUI->EnablePlotControls(kTRUE);
-        
-        new TGMsgBox(gClient->GetRoot(), fMainGUI,
-            "Success", Form("CSV loaded successfully!\n\nColumns: %d\nRows: %d",
-                fCurrentData.GetNumColumns(),
-                fCurrentData.GetNumRows()),
-            kMBIconAsterisk, kMBOk);
-    } else {
-        new TGMsgBox(gClient->GetRoot(), fMainGUI,
-            "Warning", "No numeric data found in file.\n"
-                       "Check delimiter and format.",
-            kMBIconExclamation, kMBOk);
+void FileHandler::FinishLoad()
+{
+    fPollTimer->TurnOff();
+    if (fLoadThread.joinable()) fLoadThread.join();
+    fLoading = kFALSE;
+
+    fMainGUI->SetLoadBusy(kFALSE, "");
+    if (fCurrentData->GetNumRows() > 0) fMainGUI->EnablePlotControls(kTRUE);
+
+    if (!fLoadAfterFinish.empty()) {
+        std::string path;
+        path.swap(fLoadAfterFinish);
+        LoadConvertedFile(path);
     }
 }
 
+// ============================================================================
+// Read a converted file's table straight into the plot data (the ROOT
+// browser path only shows tree information)
+// ============================================================================
+void FileHandler::LoadConvertedFile(const std::string& path)
+{
+    StartLoad(path, [this, path]() {
+        auto data = std::make_shared<ColumnData>();
+        LoadResult r;
+        r.kind    = LoadResult::kColumnData;
+        r.ok      = DataReader::ReadROOTFile(path, *data, &fProgress);
+        r.partial = fProgress.Cancelled();
+        r.data    = data;
+        fLoadQueue.Push(std::move(r));
+    });
+    fObjectsLoaded = -1;   // no per-object summary for this load
+}
+
+// ============================================================================
+// Derived columns: computed when the table is next used, not when defined
+// ============================================================================
+std::string FileHandler::UpdateDerivedColumns()
+{
+    std::string messages;
+    if (fLoading || fCurrentData->GetNumRows() == 0) return messages;
+    DerivedColumns::Apply(DerivedColumns::Instance().GetDefinitions(), fCurrentData, messages);
+    if (!messages.empty())
+        std::cerr << "Derived columns:\n" << messages;
+    return messages;
+}
+
 // ============================================================================
 // Helper: Plot histogram
 // ============================================================================
@@ -0,0 +1,218 @@
+#include "FitCache.h"
+
+#include <TGraph.h>
+#include <TH1.h>
+#include <TSystem.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+struct Fnv1a {
+    unsigned long long h = 1469598103934665603ULL;   // FNV-1a 64
+    void Mix(const void* data, size_t n) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < n; ++i) {
+            h ^= p[i];
+            h *= 1099511628211ULL;
+        }
+    }
+    void Mix(double v)  { Mix(&v, sizeof(v)); }
+    void Mix(int v)     { Mix(&v, sizeof(v)); }
+    void Mix(const double* v, int n) { if (v && n > 0) Mix(v, sizeof(double) * n); }
+};
+
+// key \t status \t valid \t chi2 \t ndf \t name=value,error;...
+std::string Encode(const std::string& key, const CachedFit& fit) {
+    std::ostringstream os;
+    os.precision(17);
+    os << key << '\t' << fit.status << '\t' << (fit.valid ? 1 : 0) << '\t'
+       << fit.chi2 << '\t' << fit.ndf << '\t';
+    for (size_t i = 0; i < fit.params.size(); ++i)
+        os << (i ? ";" : "") << fit.parNames[i] << "=" << fit.params[i] << "," << fit.errors[i];
+    os << '\n';
+    return os.str();
+}
+
+bool Decode(const std::string& line, std::string& key, CachedFit& fit) {
+    std::istringstream is(line);
+    std::string status, valid, chi2, ndf, pars;
+    if (!std::getline(is, key, '\t') || !std::getline(is, status, '\t') ||
+        !std::getline(is, valid, '\t') || !std::getline(is, chi2, '\t') ||
+        !std::getline(is, ndf, '\t'))
+        return false;
+    std::getline(is, pars);
+
+    fit.status = std::atoi(status.c_str());
+    fit.valid  = (valid == "1");
+    fit.chi2   = std::strtod(chi2.c_str(), nullptr);
+    fit.ndf    = std::atoi(ndf.c_str());
+
+    std::istringstream ps(pars);
+    std::string item;
+    while (std::getline(ps, item, ';')) {
+        size_t eq = item.rfind('=');
+        size_t comma = item.rfind(',');
+        if (eq == std::string::npos || comma == std::string::npos || comma < eq) return false;
+        fit.parNames.push_back(item.substr(0, eq));
+        fit.params.push_back(std::strtod(item.substr(eq + 1, comma - eq - 1).c_str(), nullptr));
+        fit.errors.push_back(std::strtod(item.substr(comma + 1).c_str(), nullptr));
+    }
+    return !key.empty();
+}
+
+} // namespace
+
+FitCache::FitCache()
+{
+    const char* env = gSystem->Getenv("APG_FIT_CACHE");
+    TString setting = env ? env : "";
+    if (setting == "off" || setting == "0") {
+        fEnabled = false;
+    } else if (setting.Length() > 0) {
+        fPath = setting;
+    } else {
+        fPath = Form("%s/.cache/AdvancedPlotGUI/fitcache.txt", gSystem->HomeDirectory());
+    }
+}
+
+FitCache& FitCache::Instance()
+{
+    static FitCache cache;
+    return cache;
+}
+
+// ============================================================================
+// Keys
+// ============================================================================
+std::string FitCache::HashData(const TObject* obj)
+{
+    if (!obj) return "";
+    Fnv1a h;
+
+    if (obj->InheritsFrom(TGraph::Class())) {
+        const TGraph* g = static_cast<const TGraph*>(obj);
+        int n = g->GetN();
+        h.Mix(n);
+        h.Mix(g->GetX(), n);
+        h.Mix(g->GetY(), n);
+        h.Mix(g->GetEX(), n);
+        h.Mix(g->GetEY(), n);
+    } else if (obj->InheritsFrom(TH1::Class())) {
+        const TH1* hist = static_cast<const TH1*>(obj);
+        int n = hist->GetNbinsX();
+        h.Mix(hist->GetDimension());
+        h.Mix(n);
+        for (int i = 1; i <= n; ++i) {
+            h.Mix(hist->GetXaxis()->GetBinLowEdge(i));
+            h.Mix(hist->GetBinContent(i));
+            h.Mix(hist->GetBinError(i));
+        }
+        h.Mix(hist->GetXaxis()->GetBinUpEdge(n));
+    } else {
+        return "";
+    }
+
+    char buf[17];
+    snprintf(buf, sizeof(buf), "%016llx", h.h);
+    return buf;
+}
+
+std::string FitCache::MakeKey(const TObject* obj, const std::string& spec)
+{
+    std::string hash = HashData(obj);
+    return hash.empty() ? "" : hash + "|" + spec;
+}
+
+// ============================================================================
+// Lookup / store
+// ============================================================================
+bool FitCache::Lookup(const std::string& key, CachedFit& out)
+{
+    if (!fEnabled || key.empty()) return false;
+    std::lock_guard<std::mutex> lock(fMutex);
+    LoadLocked();
+    auto it = fEntries.find(key);
+    if (it == fEntries.end()) return false;
+    out = it->second;
+    return true;
+}
+
+void FitCache::Store(const std::string& key, const CachedFit& fit)
+{
+    if (!fEnabled || key.empty()) return;
+    std::lock_guard<std::mutex> lock(fMutex);
+    LoadLocked();
+    InsertLocked(key, fit);
+
+    // One write() per entry with O_APPEND, so batch worker processes
+    // sharing the file never interleave lines
+    std::string line = Encode(key, fit);
+    int fd = open(fPath.Data(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) return;
+    ssize_t n = write(fd, line.data(), line.size());
+    (void)n;
+    close(fd);
+}
+
+void FitCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    fEntries.clear();
+    fOrder.clear();
+    fLoaded = true;
+    if (fEnabled) gSystem->Unlink(fPath.Data());
+}
+
+void FitCache::InsertLocked(const std::string& key, const CachedFit& fit)
+{
+    if (fEntries.find(key) == fEntries.end()) fOrder.push_back(key);
+    fEntries[key] = fit;
+    while (fOrder.size() > kMaxEntries) {
+        fEntries.erase(fOrder.front());
+        fOrder.pop_front();
+    }
+}
+
+void FitCache::LoadLocked()
+{
+    if (fLoaded) return;
+    fLoaded = true;
+
+    TString dir = gSystem->GetDirName(fPath.Data());
+    if (gSystem->AccessPathName(dir.Data())) gSystem->mkdir(dir.Data(), kTRUE);
+
+    std::ifstream in(fPath.Data());
+    if (!in.is_open()) return;
+
+    std::string line;
+    size_t nLines = 0;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        ++nLines;
+        std::string key;
+        CachedFit fit;
+        if (Decode(line, key, fit)) InsertLocked(key, fit);
+    }
+
+    // Superseded and evicted lines pile up in an append-only file
+    if (nLines > 2 * fEntries.size() + 1000) RewriteLocked();
+}
+
+void FitCache::RewriteLocked()
+{
+    TString tmp = fPath + ".tmp";
+    {
+        std::ofstream out(tmp.Data());
+        if (!out.is_open()) return;
+        for (const auto& key : fOrder) out << Encode(key, fEntries[key]);
+        if (!out.good()) return;
+    }
+    gSystem->Rename(tmp.Data(), fPath.Data());
+}
@@ -0,0 +1,719 @@
+#include "FitModels.h"
+
+#include <TGraph.h>
+#include <TH1.h>
+#include <TMath.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+namespace {
+
+// ============================================================================
+// Kernels, written once for double and (with VecCore) ROOT::Double_v
+// ============================================================================
+#ifdef R__HAS_VECCORE
+template <class T> inline T Exp(const T& v) { return vecCore::math::Exp(v); }
+template <class T> inline T Sin(const T& v) { return vecCore::math::Sin(v); }
+#else
+inline double Exp(double v) { return std::exp(v); }
+inline double Sin(double v) { return std::sin(v); }
+#endif
+
+template <class T> T GausKernel(const T* x, const double* p)
+{
+    T t = (x[0] - p[1]) / p[2];
+    return p[0] * Exp(T(-0.5) * t * t);
+}
+
+template <class T> T PolKernel(const T* x, const double* p, int degree)
+{
+    T v = T(p[degree]);
+    for (int k = degree - 1; k >= 0; --k) v = v * x[0] + p[k];   // Horner
+    return v;
+}
+
+template <class T> T ExpoKernel(const T* x, const double* p)
+{
+    return Exp(p[0] + p[1] * x[0]);
+}
+
+template <class T> T SineKernel(const T* x, const double* p)
+{
+    return p[0] * Sin(p[1] * x[0] + p[2]);
+}
+
+template <class T> T SineOffsetKernel(const T* x, const double* p)
+{
+    return p[0] * Sin(p[1] * x[0] + p[2]) + p[3];
+}
+
+template <class T> T DampedSineKernel(const T* x, const double* p)
+{
+    return p[0] * Exp(-p[1] * x[0]) * Sin(p[2] * x[0] + p[3]) + p[4];
+}
+
+// ============================================================================
+// Parameter gradients
+// ============================================================================
+void GausGrad(const double* x, const double* p, double* g)
+{
+    double t = (x[0] - p[1]) / p[2];
+    double e = std::exp(-0.5 * t * t);
+    g[0] = e;
+    g[1] = p[0] * e * t / p[2];
+    g[2] = p[0] * e * t * t / p[2];
+}
+
+void PolGrad(const double* x, double* g, int degree)
+{
+    double xk = 1.0;
+    for (int k = 0; k <= degree; ++k, xk *= x[0]) g[k] = xk;
+}
+
+void ExpoGrad(const double* x, const double* p, double* g)
+{
+    double e = std::exp(p[0] + p[1] * x[0]);
+    g[0] = e;
+    g[1] = x[0] * e;
+}
+
+void SineGrad(const double* x, const double* p, double* g)
+{
+    double s = std::sin(p[1] * x[0] + p[2]);
+    double c = std::cos(p[1] * x[0] + p[2]);
+    g[0] = s;
+    g[1] = p[0] * x[0] * c;
+    g[2] = p[0] * c;
+}
+
+void SineOffsetGrad(const double* x, const double* p, double* g)
+{
+    SineGrad(x, p, g);
+    g[3] = 1.0;
+}
+
+void DampedSineGrad(const double* x, const double* p, double* g)
+{
+    double e = std::exp(-p[1] * x[0]);
+    double s = std::sin(p[2] * x[0] + p[3]);
+    double c = std::cos(p[2] * x[0] + p[3]);
+    g[0] = e * s;
+    g[1] = -x[0] * p[0] * e * s;
+    g[2] = p[0] * e * x[0] * c;
+    g[3] = p[0] * e * c;
+    g[4] = 1.0;
+}
+
+struct Range {
+    double xmin, xmax, ymin, ymax, meanY;
+    size_t iMax;   // index of the largest y
+};
+
+Range GetRange(const std::vector<double>& xs, const std::vector<double>& ys)
+{
+    Range r;
+    r.xmin  = *std::min_element(xs.begin(), xs.end());
+    r.xmax  = *std::max_element(xs.begin(), xs.end());
+    r.ymin  = *std::min_element(ys.begin(), ys.end());
+    r.iMax  = std::max_element(ys.begin(), ys.end()) - ys.begin();
+    r.ymax  = ys[r.iMax];
+    r.meanY = std::accumulate(ys.begin(), ys.end(), 0.0) / ys.size();
+    return r;
+}
+
+// ============================================================================
+// Guesses
+// ============================================================================
+void GuessGaus(TF1& f, const std::vector<double>& xs, const std::vector<double>& ys)
+{
+    Range r = GetRange(xs, ys);
+    double mean  = xs[r.iMax];
+    double sigma = (r.xmax - r.xmin) / 6.0;
+
+    // Non-negative y (histogram counts, peaks): use the weighted moments
+    if (r.ymin >= 0) {
+        double sw = 0, swx = 0;
+        for (size_t i = 0; i < xs.size(); ++i) { sw += ys[i]; swx += ys[i] * xs[i]; }
+        if (sw > 0) {
+            mean = swx / sw;
+            double swxx = 0;
+            for (size_t i = 0; i < xs.size(); ++i) swxx += ys[i] * (xs[i] - mean) * (xs[i] - mean);
+            if (swxx > 0) sigma = std::sqrt(swxx / sw);
+        }
+    }
+    f.SetParameters(r.ymax, mean, sigma > 0 ? sigma : 1.0);
+}
+
+void GuessExpo(TF1& f, const std::vector<double>& xs, const std::vector<double>& ys)
+{
+    // exp([0]+[1]*x): straight line through log(y) for y > 0
+    double n = 0, sx = 0, sl = 0, sxx = 0, sxl = 0;
+    for (size_t i = 0; i < xs.size(); ++i) {
+        if (ys[i] <= 0) continue;
+        double l = std::log(ys[i]);
+        n += 1; sx += xs[i]; sl += l; sxx += xs[i] * xs[i]; sxl += xs[i] * l;
+    }
+    double det = n * sxx - sx * sx;
+    if (n >= 2 && det != 0) {
+        double slope = (n * sxl - sx * sl) / det;
+        f.SetParameters((sl - slope * sx) / n, slope);
+    }
+}
+
+// Solves the n x n system a q = b (a row-major) by Gaussian elimination
+// with partial pivoting; false when it is singular
+bool SolveLinear(std::vector<double> a, std::vector<double> b, std::vector<double>& q)
+{
+    const int n = b.size();
+    for (int col = 0; col < n; ++col) {
+        int pivot = col;
+        for (int row = col + 1; row < n; ++row)
+            if (std::fabs(a[row * n + col]) > std::fabs(a[pivot * n + col])) pivot = row;
+        if (std::fabs(a[pivot * n + col]) < 1e-300) return false;
+        if (pivot != col) {
+            for (int k = 0; k < n; ++k) std::swap(a[col * n + k], a[pivot * n + k]);
+            std::swap(b[col], b[pivot]);
+        }
+        for (int row = col + 1; row < n; ++row) {
+            double m = a[row * n + col] / a[col * n + col];
+            for (int k = col; k < n; ++k) a[row * n + k] -= m * a[col * n + k];
+            b[row] -= m * b[col];
+        }
+    }
+    q.assign(n, 0.0);
+    for (int row = n - 1; row >= 0; --row) {
+        double sum = b[row];
+        for (int k = row + 1; k < n; ++k) sum -= a[row * n + k] * q[k];
+        q[row] = sum / a[row * n + row];
+    }
+    return true;
+}
+
+// Least-squares polynomial of the given degree, solved in t = (x - c) / s
+// for conditioning and expanded back to powers of x. Exact for the linear
+// model, so Migrad starts at the minimum.
+void GuessPol(TF1& f, const std::vector<double>& xs, const std::vector<double>& ys, int degree)
+{
+    Range r = GetRange(xs, ys);
+    f.SetParameter(0, r.meanY);
+    for (int k = 1; k <= degree; ++k) f.SetParameter(k, 0.0);
+    if ((int)xs.size() <= degree) return;
+
+    double c = 0.5 * (r.xmin + r.xmax);
+    double s = 0.5 * (r.xmax - r.xmin);
+    if (s <= 0) return;
+
+    const int n = degree + 1;
+    std::vector<double> a(n * n, 0.0), b(n, 0.0), tp(2 * n - 1);
+    for (size_t i = 0; i < xs.size(); ++i) {
+        double t = (xs[i] - c) / s;
+        tp[0] = 1.0;
+        for (int k = 1; k < 2 * n - 1; ++k) tp[k] = tp[k - 1] * t;
+        for (int row = 0; row < n; ++row) {
+            b[row] += tp[row] * ys[i];
+            for (int col = 0; col < n; ++col) a[row * n + col] += tp[row + col];
+        }
+    }
+
+    std::vector<double> q;
+    if (!SolveLinear(a, b, q)) return;
+
+    // sum_k q_k ((x - c) / s)^k  ->  sum_j p_j x^j
+    std::vector<double> p(n, 0.0);
+    for (int k = 0; k < n; ++k) {
+        double scale = q[k] / std::pow(s, k);
+        for (int j = 0; j <= k; ++j)
+            p[j] += scale * TMath::Binomial(k, j) * std::pow(-c, k - j);
+    }
+    for (int j = 0; j < n; ++j) {
+        if (!std::isfinite(p[j])) return;
+    }
+    f.SetParameters(p.data());
+}
+
+// y ~ a*sin(omega*x) + b*cos(omega*x) + c over the points with lo <= x <= hi,
+// as amplitude, phase and offset of A*sin(omega*x + phi) + c
+bool SineAt(const std::vector<double>& xs, const std::vector<double>& ys, double omega,
+            double lo, double hi, double& amplitude, double& phase, double& offset)
+{
+    std::vector<double> a(9, 0.0), b(3, 0.0), q;
+    size_t n = 0;
+    for (size_t i = 0; i < xs.size(); ++i) {
+        if (xs[i] < lo || xs[i] > hi) continue;
+        double v[3] = { std::sin(omega * xs[i]), std::cos(omega * xs[i]), 1.0 };
+        for (int r = 0; r < 3; ++r) {
+            b[r] += v[r] * ys[i];
+            for (int c = 0; c < 3; ++c) a[r * 3 + c] += v[r] * v[c];
+        }
+        ++n;
+    }
+    if (n < 3 || !SolveLinear(a, b, q)) return false;
+    amplitude = std::hypot(q[0], q[1]);
+    phase     = std::atan2(q[1], q[0]);
+    offset    = q[2];
+    return true;
+}
+
+// Full parameter set of the sine-type model with npar parameters at a
+// given angular frequency; the damping comes from the amplitude ratio of
+// the two halves of the range
+std::vector<double> PeriodicStart(int npar, const std::vector<double>& xs,
+                                  const std::vector<double>& ys, double omega)
+{
+    Range r = GetRange(xs, ys);
+    double amplitude = (r.ymax - r.ymin) / 2.0;
+    double offset    = (r.ymax + r.ymin) / 2.0;
+    double phase     = 0.0;
+    SineAt(xs, ys, omega, r.xmin, r.xmax, amplitude, phase, offset);
+
+    switch (npar) {
+        case 3:   // [0]*sin([1]*x+[2])
+            return { amplitude, omega, phase };
+        case 4:   // [0]*sin([1]*x+[2])+[3]
+            return { amplitude, omega, phase, offset };
+        case 5: { // [0]*exp(-[1]*x)*sin([2]*x+[3])+[4]
+            double mid = 0.5 * (r.xmin + r.xmax);
+            double a1, a2, p1, p2, c1, c2, damping = 0.0;
+            if (SineAt(xs, ys, omega, r.xmin, mid, a1, p1, c1) &&
+                SineAt(xs, ys, omega, mid, r.xmax, a2, p2, c2) && a1 > a2 && a2 > 0)
+                damping = std::log(a1 / a2) / (0.5 * (r.xmax - r.xmin));
+            // Amplitude at x = 0, from the one at the centre of the range
+            double a0 = amplitude * std::exp(damping * mid);
+            if (!std::isfinite(a0)) { a0 = amplitude; damping = 0.0; }
+            return { a0, damping, omega, phase, offset };
+        }
+        default:
+            return {};
+    }
+}
+
+// Fallback frequency: about three periods across the range
+double ThreePeriods(const std::vector<double>& xs, const std::vector<double>& ys)
+{
+    Range r = GetRange(xs, ys);
+    double period = (r.xmax - r.xmin) / 3.0;
+    return period > 0 ? 2.0 * TMath::Pi() / period : 1.0;
+}
+
+// Sine-type fits start at the dominant periodogram frequency
+void GuessPeriodic(TF1& f, const std::vector<double>& xs, const std::vector<double>& ys)
+{
+    std::vector<double> omega = FitModelRegistry::DominantFrequencies(xs, ys, 1);
+    std::vector<double> p = PeriodicStart(f.GetNpar(), xs, ys,
+                                          omega.empty() ? ThreePeriods(xs, ys) : omega[0]);
+    if ((int)p.size() == f.GetNpar()) f.SetParameters(p.data());
+}
+
+// One start per periodogram peak, then harmonics of the strongest one
+std::vector<std::vector<double>> PeriodicStarts(int npar, const std::vector<double>& xs,
+                                                const std::vector<double>& ys, unsigned n)
+{
+    std::vector<double> omegas = FitModelRegistry::DominantFrequencies(xs, ys, n);
+    double base = omegas.empty() ? ThreePeriods(xs, ys) : omegas[0];
+    if (omegas.empty()) omegas.push_back(base);
+    const double factors[] = { 2.0, 0.5, 3.0, 1.0 / 3.0 };
+    for (double factor : factors) {
+        if (omegas.size() >= n) break;
+        omegas.push_back(base * factor);
+    }
+
+    std::vector<std::vector<double>> starts;
+    for (double omega : omegas) starts.push_back(PeriodicStart(npar, xs, ys, omega));
+    return starts;
+}
+
+// ============================================================================
+// Built-in models
+// ============================================================================
+FitModel Polynomial(int degree, const std::string& name, const std::string& title)
+{
+    FitModel m;
+    m.name  = name;
+    m.title = title;
+    m.expression = "pol" + std::to_string(degree);
+    for (int k = 0; k <= degree; ++k) m.parNames.push_back("p" + std::to_string(k));
+    m.eval = [degree](const double* x, const double* p) { return PolKernel(x, p, degree); };
+#ifdef R__HAS_VECCORE
+    m.evalVec = [degree](const ROOT::Double_v* x, const double* p) { return PolKernel(x, p, degree); };
+#endif
+    m.parGrad = [degree](const double* x, const double*, double* g) { PolGrad(x, g, degree); };
+    m.guess = [degree](TF1& f, const std::vector<double>& xs, const std::vector<double>& ys) {
+        GuessPol(f, xs, ys, degree);
+    };
+    return m;
+}
+
+std::vector<FitModel> BuiltinModels()
+{
+    std::vector<FitModel> models;
+
+    FitModel gaus;
+    gaus.name       = "gaus";
+    gaus.title      = "Gaussian";
+    gaus.expression = "[0]*exp(-0.5*((x-[1])/[2])^2)";
+    gaus.parNames   = { "Constant", "Mean", "Sigma" };
+    gaus.eval = GausKernel<double>;
+#ifdef R__HAS_VECCORE
+    gaus.evalVec = GausKernel<ROOT::Double_v>;
+#endif
+    gaus.parGrad = GausGrad;
+    gaus.guess = GuessGaus;
+    models.push_back(gaus);
+
+    models.push_back(Polynomial(1, "linear", "Linear"));
+    models.push_back(Polynomial(0, "pol0", "Pol0 (Constant)"));
+    models.push_back(Polynomial(1, "pol1", "Pol1 (Linear)"));
+    models.push_back(Polynomial(2, "pol2", "Pol2 (Quadratic)"));
+    models.push_back(Polynomial(3, "pol3", "Pol3 (Cubic)"));
+    models.push_back(Polynomial(4, "pol4", "Pol4 (Quartic)"));
+
+    FitModel expo;
+    expo.name       = "expo";
+    expo.title      = "Exponential";
+    expo.expression = "exp([0]+[1]*x)";
+    expo.parNames   = { "Constant", "Slope" };
+    expo.eval = ExpoKernel<double>;
+#ifdef R__HAS_VECCORE
+    expo.evalVec = ExpoKernel<ROOT::Double_v>;
+#endif
+    expo.parGrad = ExpoGrad;
+    expo.guess = GuessExpo;
+    models.push_back(expo);
+
+    FitModel sine;
+    sine.name       = "sine";
+    sine.title      = "Sine Wave";
+    sine.expression = "[0]*sin([1]*x+[2])";
+    sine.parNames   = { "Amplitude", "Frequency", "Phase" };
+    sine.eval = SineKernel<double>;
+#ifdef R__HAS_VECCORE
+    sine.evalVec = SineKernel<ROOT::Double_v>;
+#endif
+    sine.parGrad = SineGrad;
+    sine.guess = GuessPeriodic;
+    sine.starts = [](const std::vector<double>& xs, const std::vector<double>& ys, unsigned n) {
+        return PeriodicStarts(3, xs, ys, n);
+    };
+    models.push_back(sine);
+
+    FitModel sineOffset;
+    sineOffset.name       = "sineoffset";
+    sineOffset.title      = "Sine + Offset";
+    sineOffset.expression = "[0]*sin([1]*x+[2])+[3]";
+    sineOffset.parNames   = { "Amplitude", "Frequency", "Phase", "Offset" };
+    sineOffset.eval = SineOffsetKernel<double>;
+#ifdef R__HAS_VECCORE
+    sineOffset.evalVec = SineOffsetKernel<ROOT::Double_v>;
+#endif
+    sineOffset.parGrad = SineOffsetGrad;
+    sineOffset.guess = GuessPeriodic;
+    sineOffset.starts = [](const std::vector<double>& xs, const std::vector<double>& ys, unsigned n) {
+        return PeriodicStarts(4, xs, ys, n);
+    };
+    models.push_back(sineOffset);
+
+    FitModel damped;
+    damped.name       = "dampedsine";
+    damped.title      = "Damped Sine";
+    damped.expression = "[0]*exp(-[1]*x)*sin([2]*x+[3])+[4]";
+    damped.parNames   = { "Amplitude", "Damping", "Frequency", "Phase", "Offset" };
+    damped.eval = DampedSineKernel<double>;
+#ifdef R__HAS_VECCORE
+    damped.evalVec = DampedSineKernel<ROOT::Double_v>;
+#endif
+    damped.parGrad = DampedSineGrad;
+    damped.guess = GuessPeriodic;
+    damped.starts = [](const std::vector<double>& xs, const std::vector<double>& ys, unsigned n) {
+        return PeriodicStarts(5, xs, ys, n);
+    };
+    models.push_back(damped);
+
+    return models;
+}
+
+} // namespace
+
+FitModelRegistry::FitModelRegistry()
+{
+    for (const auto& model : BuiltinModels()) Register(model);
+}
+
+FitModelRegistry& FitModelRegistry::Instance()
+{
+    static FitModelRegistry registry;
+    return registry;
+}
+
+// ============================================================================
+// Registration / lookup
+// ============================================================================
+bool FitModelRegistry::Register(const FitModel& model)
+{
+    if (model.name.empty() || !model.eval || model.parNames.empty()) return false;
+
+    auto shared = std::make_shared<const FitModel>(model);
+    const int npar = (int)model.parNames.size();
+    std::string name = "apgmodel_" + model.name;
+
+    // A TF1 built from a Double_v functor is vectorized: TH1/TGraph::Fit and
+    // BatchFitter then evaluate the chi2 SIMD-wide
+    std::unique_ptr<TF1> proto;
+#ifdef R__HAS_VECCORE
+    if (model.evalVec) {
+        FitModel::EvalVec evalVec = model.evalVec;
+        proto.reset(new TF1(name.c_str(),
+                            [evalVec](ROOT::Double_v* x, double* p) { return evalVec(x, p); },
+                            0, 1, npar, 1, TF1::EAddToList::kNo));
+    }
+#endif
+    if (!proto) {
+        FitModel::Eval eval = model.eval;
+        proto.reset(new TF1(name.c_str(),
+                            [eval](double* x, double* p) { return eval(x, p); },
+                            0, 1, npar, 1, TF1::EAddToList::kNo));
+    }
+    proto->SetTitle(model.title.c_str());
+    for (int i = 0; i < npar; ++i) proto->SetParName(i, model.parNames[i].c_str());
+
+    std::lock_guard<std::mutex> lock(fMutex);
+    Entry& entry = fModels[model.name];
+    entry.model     = shared;
+    entry.prototype = std::move(proto);
+    return true;
+}
+
+std::shared_ptr<const FitModel> FitModelRegistry::Find(const std::string& name) const
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    auto it = fModels.find(name);
+    return it == fModels.end() ? nullptr : it->second.model;
+}
+
+std::vector<std::string> FitModelRegistry::Names() const
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    std::vector<std::string> names;
+    for (const auto& kv : fModels) names.push_back(kv.first);
+    return names;
+}
+
+// ============================================================================
+// Functions
+// ============================================================================
+TF1* FitModelRegistry::MakeFunction(const std::string& name, const char* fname,
+                                    double xmin, double xmax) const
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    auto it = fModels.find(name);
+    if (it == fModels.end()) return nullptr;
+
+    TF1* f = new TF1(*it->second.prototype);
+    f->SetName(fname);
+    f->SetRange(xmin, xmax);
+    return f;
+}
+
+TF1* FitModelRegistry::MakeFormulaFunction(const std::string& formula, const char* fname,
+                                           double xmin, double xmax)
+{
+    if (formula.empty()) return nullptr;
+
+    std::lock_guard<std::mutex> lock(fMutex);
+    auto it = fFormulas.find(formula);
+    if (it == fFormulas.end()) {
+        std::string name = "apgformula_" + std::to_string(fFormulas.size());
+        std::unique_ptr<TF1> proto(new TF1(name.c_str(), formula.c_str(), 0, 1,
+                                           TF1::EAddToList::kNo));
+        // Remember failures too, so a bad formula is not recompiled every call
+        if (!proto->IsValid() || proto->GetNdim() != 1 || proto->GetNpar() == 0) proto.reset();
+        it = fFormulas.emplace(formula, std::move(proto)).first;
+    }
+    if (!it->second) return nullptr;
+
+    TF1* f = new TF1(*it->second);
+    f->SetName(fname);
+    f->SetRange(xmin, xmax);
+    return f;
+}
+
+// ============================================================================
+// Initial guesses
+// ============================================================================
+void FitModelRegistry::CollectPoints(const TObject* obj, std::vector<double>& xs,
+                                     std::vector<double>& ys)
+{
+    if (!obj) return;
+    if (obj->InheritsFrom(TGraph::Class())) {
+        const TGraph* g = static_cast<const TGraph*>(obj);
+        xs.assign(g->GetX(), g->GetX() + g->GetN());
+        ys.assign(g->GetY(), g->GetY() + g->GetN());
+    } else if (obj->InheritsFrom(TH1::Class())) {
+        const TH1* h = static_cast<const TH1*>(obj);
+        for (int i = 1; i <= h->GetNbinsX(); ++i) {
+            xs.push_back(h->GetXaxis()->GetBinCenter(i));
+            ys.push_back(h->GetBinContent(i));
+        }
+    }
+}
+
+void FitModelRegistry::Guess(const FitModel& model, TF1& f, const TObject* obj)
+{
+    if (!model.guess) return;
+    std::vector<double> xs, ys;
+    CollectPoints(obj, xs, ys);
+    if (xs.empty()) return;
+    model.guess(f, xs, ys);
+}
+
+std::vector<std::vector<double>> FitModelRegistry::Starts(const FitModel& model, TF1& f,
+                                                          const TObject* obj, unsigned n)
+{
+    std::vector<double> xs, ys;
+    CollectPoints(obj, xs, ys);
+    if (model.guess && !xs.empty()) model.guess(f, xs, ys);
+    std::vector<double> guess(f.GetParameters(), f.GetParameters() + f.GetNpar());
+
+    std::vector<std::vector<double>> starts;
+    if (model.starts && !xs.empty()) {
+        for (auto& p : model.starts(xs, ys, n))
+            if (p.size() == guess.size()) starts.push_back(p);
+    }
+    if (starts.empty()) starts.push_back(guess);
+
+    // Fixed seed: the same data gets the same starts, so cached results hold
+    std::mt19937 rng(20240611);
+    std::normal_distribution<double> gauss(0.0, 1.0);
+    while (starts.size() < n) {
+        std::vector<double> p = guess;
+        for (double& v : p) v = v != 0 ? v * (1.0 + 0.3 * gauss(rng)) : 0.1 * gauss(rng);
+        starts.push_back(p);
+    }
+    if (starts.size() > n) starts.resize(n);
+    return starts;
+}
+
+// ============================================================================
+// Lomb-Scargle periodogram
+// ============================================================================
+std::vector<double> FitModelRegistry::DominantFrequencies(const std::vector<double>& xs,
+                                                          const std::vector<double>& ys,
+                                                          unsigned n)
+{
+    // A strided subset is plenty to locate the peaks and bounds the cost
+    const size_t kMaxPoints = 1024;
+    const size_t kMaxFreqs  = 1500;
+
+    size_t stride = std::max<size_t>(1, xs.size() / kMaxPoints);
+    std::vector<double> t, y;
+    for (size_t i = 0; i < xs.size() && i < ys.size(); i += stride) {
+        t.push_back(xs[i]);
+        y.push_back(ys[i]);
+    }
+    if (n == 0 || t.size() < 4) return {};
+
+    double tmin = *std::min_element(t.begin(), t.end());
+    double span = *std::max_element(t.begin(), t.end()) - tmin;
+    if (span <= 0) return {};
+    double mean = std::accumulate(y.begin(), y.end(), 0.0) / y.size();
+    for (double& v : y) v -= mean;
+    for (double& v : t) v -= tmin;   // phases stay small
+
+    // From one period over the range up to the mean-spacing Nyquist
+    // frequency, oversampled five times
+    double fLo = 1.0 / span;
+    double fHi = 0.5 * t.size() / span;
+    size_t nf  = std::min<size_t>(kMaxFreqs, std::max<size_t>(2, (size_t)(5.0 * (fHi - fLo) * span) + 1));
+
+    std::vector<double> omega(nf), power(nf, 0.0);
+    for (size_t k = 0; k < nf; ++k) {
+        double w = 2.0 * TMath::Pi() * (fLo + (fHi - fLo) * k / (nf - 1));
+        omega[k] = w;
+
+        double s2 = 0, c2 = 0;
+        for (double ti : t) { s2 += std::sin(2 * w * ti); c2 += std::cos(2 * w * ti); }
+        double tau = std::atan2(s2, c2) / (2 * w);
+
+        double yc = 0, ysn = 0, cc = 0, ss = 0;
+        for (size_t i = 0; i < t.size(); ++i) {
+            double c = std::cos(w * (t[i] - tau));
+            double s = std::sin(w * (t[i] - tau));
+            yc += y[i] * c; ysn += y[i] * s;
+            cc += c * c;    ss += s * s;
+        }
+        power[k] = 0.5 * ((cc > 0 ? yc * yc / cc : 0) + (ss > 0 ? ysn * ysn / ss : 0));
+    }
+
+    std::vector<size_t> peaks;
+    for (size_t k = 0; k < nf; ++k) {
+        bool left  = k == 0      || power[k] >= power[k - 1];
+        bool right = k + 1 == nf || power[k] >  power[k + 1];
+        if (left && right && power[k] > 0) peaks.push_back(k);
+    }
+    std::sort(peaks.begin(), peaks.end(),
+              [&](size_t a, size_t b) { return power[a] > power[b]; });
+
+    std::vector<double> result;
+    for (size_t k = 0; k < peaks.size() && result.size() < n; ++k)
+        result.push_back(omega[peaks[k]]);
+    return result;
+}
+
+// ============================================================================
+// FitModelFunction
+// ============================================================================
+FitModelFunction::FitModelFunction(std::shared_ptr<const FitModel> model, const double* params)
+    : fModel(std::move(model))
+{
+    fParams.assign(params, params + fModel->parNames.size());
+    fGrad.resize(fParams.size());
+    fGradPar.resize(fParams.size());
+}
+
+ROOT::Math::IBaseFunctionMultiDim* FitModelFunction::Clone() const
+{
+    return new FitModelFunction(fModel, fParams.data());
+}
+
+void FitModelFunction::SetParameters(const double* p)
+{
+    std::copy(p, p + fParams.size(), fParams.begin());
+}
+
+std::string FitModelFunction::ParameterName(unsigned int i) const
+{
+    return i < fModel->parNames.size() ? fModel->parNames[i] : "p" + std::to_string(i);
+}
+
+void FitModelFunction::ParameterGradient(const double* x, const double* p, double* grad) const
+{
+    fModel->parGrad(x, p, grad);
+}
+
+double FitModelFunction::DoEvalPar(const double* x, const double* p) const
+{
+    return fModel->eval(x, p);
+}
+
+double FitModelFunction::DoParameterDerivative(const double* x, const double* p,
+                                               unsigned int ipar) const
+{
+    if (!fGradValid || fGradX != x[0] ||
+        !std::equal(fGradPar.begin(), fGradPar.end(), p)) {
+        fModel->parGrad(x, p, fGrad.data());
+        std::copy(p, p + fGradPar.size(), fGradPar.begin());
+        fGradX     = x[0];
+        fGradValid = true;
+    }
+    return fGrad[ipar];
+}
+
+double FitModelFunction::DoDerivative(const double* x, unsigned int) const
+{
+    // Not used by the fit; central difference for completeness
+    double h  = 1e-6 * std::max(1.0, std::fabs(x[0]));
+    double lo = x[0] - h, hi = x[0] + h;
+    return (fModel->eval(&hi, fParams.data()) - fModel->eval(&lo, fParams.data())) / (2 * h);
+}
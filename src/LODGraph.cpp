@@ -0,0 +1,337 @@
+#include "LODGraph.h"
+
+#include <TAxis.h>
+#include <TH1F.h>
+#include <TString.h>
+#include <TVirtualPad.h>
+
+#include <algorithm>
+#include <cmath>
+
+// ============================================================================
+// Construction / pyramid
+// ============================================================================
+LODGraph::LODGraph(Int_t n, const Double_t* x, const Double_t* y)
+    : TGraph(n, x, y)
+{
+    SetEditable(kFALSE);   // dragging a painted point would move the wrong one
+}
+
+LODGraph::LODGraph(std::shared_ptr<const ColumnData> data, int xColumn, int yColumn, Int_t n)
+    : TGraph(), fData(std::move(data))
+{
+    fNpoints = n;
+    fMaxSize = n;
+    fX = const_cast<Double_t*>(fData->data[xColumn].data());   // never written while borrowed
+    fY = const_cast<Double_t*>(fData->data[yColumn].data());
+    SetEditable(kFALSE);
+}
+
+LODGraph::~LODGraph()
+{
+    if (fData) fX = fY = nullptr;   // not ours for ~TGraph to delete
+}
+
+void LODGraph::Materialize()
+{
+    if (!fData) return;
+    Double_t* x = new Double_t[fMaxSize];
+    Double_t* y = new Double_t[fMaxSize];
+    std::copy(fX, fX + fNpoints, x);
+    std::copy(fY, fY + fNpoints, y);
+    fX = x;
+    fY = y;
+    fData.reset();
+}
+
+// ============================================================================
+// Point changes
+// ============================================================================
+void LODGraph::SetPoint(Int_t i, Double_t x, Double_t y)
+{
+    Materialize();
+    TGraph::SetPoint(i, x, y);
+    InvalidateLOD();
+}
+
+void LODGraph::Set(Int_t n)
+{
+    Materialize();
+    TGraph::Set(n);
+    InvalidateLOD();
+}
+
+Int_t LODGraph::InsertPoint()
+{
+    Materialize();
+    InvalidateLOD();
+    return TGraph::InsertPoint();
+}
+
+Int_t LODGraph::RemovePoint(Int_t ipoint)
+{
+    Materialize();
+    InvalidateLOD();
+    return TGraph::RemovePoint(ipoint);
+}
+
+void LODGraph::SetPointX(Int_t i, Double_t x)
+{
+    Materialize();
+    TGraph::SetPointX(i, x);
+    InvalidateLOD();
+}
+
+void LODGraph::SetPointY(Int_t i, Double_t y)
+{
+    Materialize();
+    TGraph::SetPointY(i, y);
+    InvalidateLOD();
+}
+
+void LODGraph::Apply(TF1* f)
+{
+    Materialize();
+    TGraph::Apply(f);
+    InvalidateLOD();
+}
+
+void LODGraph::Scale(Double_t c1, Option_t* option)
+{
+    Materialize();
+    TGraph::Scale(c1, option);
+    InvalidateLOD();
+}
+
+void LODGraph::Sort(Bool_t (*greater)(const TGraph*, Int_t, Int_t),
+                    Bool_t ascending, Int_t low, Int_t high)
+{
+    Materialize();
+    TGraph::Sort(greater, ascending, low, high);
+    InvalidateLOD();
+}
+
+void LODGraph::BuildPyramid()
+{
+    fLevels.clear();
+    fIndexedN = fNpoints;
+
+    fSorted = true;
+    for (Int_t i = 1; i < fNpoints && fSorted; ++i)
+        fSorted = fX[i] >= fX[i - 1];   // false on NaN too
+    if (!fSorted || fNpoints == 0) return;
+
+    Level base;
+    int nBlocks = (fNpoints + kBlock - 1) / kBlock;
+    base.minIdx.resize(nBlocks);
+    base.maxIdx.resize(nBlocks);
+    for (int b = 0; b < nBlocks; ++b) {
+        int begin = b * kBlock;
+        int end   = std::min(fNpoints, begin + kBlock);
+        int lo = begin, hi = begin;
+        for (int i = begin + 1; i < end; ++i) {
+            if (fY[i] < fY[lo]) lo = i;
+            if (fY[i] > fY[hi]) hi = i;
+        }
+        base.minIdx[b] = lo;
+        base.maxIdx[b] = hi;
+    }
+    fLevels.push_back(std::move(base));
+
+    // Level k+1 entry j merges entries 2j and 2j+1 of level k
+    while (fLevels.back().minIdx.size() > 1) {
+        const size_t k = fLevels.size() - 1;
+        const size_t n = fLevels[k].minIdx.size();
+        Level next;
+        next.minIdx.resize((n + 1) / 2);
+        next.maxIdx.resize((n + 1) / 2);
+        for (size_t j = 0; j < next.minIdx.size(); ++j) {
+            int lo = fLevels[k].minIdx[2 * j];
+            int hi = fLevels[k].maxIdx[2 * j];
+            if (2 * j + 1 < n) {
+                int lo2 = fLevels[k].minIdx[2 * j + 1];
+                int hi2 = fLevels[k].maxIdx[2 * j + 1];
+                if (fY[lo2] < fY[lo]) lo = lo2;
+                if (fY[hi2] > fY[hi]) hi = hi2;
+            }
+            next.minIdx[j] = lo;
+            next.maxIdx[j] = hi;
+        }
+        fLevels.push_back(std::move(next));
+    }
+}
+
+// Indices of the lowest and highest y in [i0, i1), i0 < i1: the partial
+// blocks at both ends point by point, whole blocks from the pyramid
+void LODGraph::RangeMinMax(int i0, int i1, int& imin, int& imax) const
+{
+    imin = imax = i0;
+    auto take = [this, &imin, &imax](int lo, int hi) {
+        if (fY[lo] < fY[imin]) imin = lo;
+        if (fY[hi] > fY[imax]) imax = hi;
+    };
+
+    int b0 = (i0 + kBlock - 1) / kBlock;
+    int b1 = i1 / kBlock;
+    if (b0 >= b1) {
+        for (int i = i0; i < i1; ++i) take(i, i);
+        return;
+    }
+    for (int i = i0; i < b0 * kBlock; ++i) take(i, i);
+    for (int i = b1 * kBlock; i < i1; ++i) take(i, i);
+    for (size_t k = 0; b0 < b1; ++k, b0 >>= 1, b1 >>= 1) {
+        const Level& level = fLevels[k];
+        if (b0 & 1) { take(level.minIdx[b0], level.maxIdx[b0]); ++b0; }
+        if (b1 & 1) { --b1; take(level.minIdx[b1], level.maxIdx[b1]); }
+    }
+}
+
+// ============================================================================
+// Decimation
+// ============================================================================
+void LODGraph::Decimate(double xmin, double xmax, int pixels, bool logx)
+{
+    fShownX.clear();
+    fShownY.clear();
+    fDecimated = false;
+    if (!(xmax > xmin)) return;
+
+    const double lmin = logx ? std::log10(xmin) : xmin;
+    const double lmax = logx ? std::log10(xmax) : xmax;
+    auto column = [&](double x) {
+        double u = ((logx ? std::log10(x) : x) - lmin) / (lmax - lmin);
+        return std::min(pixels - 1, std::max(0, (int)std::floor(u * pixels)));
+    };
+    auto edge = [&](int c) {   // lower x edge of pixel column c
+        double u = lmin + (lmax - lmin) * c / pixels;
+        return logx ? std::pow(10.0, u) : u;
+    };
+    auto push = [this](int i) {
+        fShownX.push_back(fX[i]);
+        fShownY.push_back(fY[i]);
+    };
+    // First, lowest, highest, last of a column, in drawing order
+    auto pushColumn = [&push](int first, int lo, int hi, int last) {
+        int idx[4] = { first, lo, hi, last };
+        std::sort(idx, idx + 4);
+        for (int k = 0; k < 4; ++k)
+            if (k == 0 || idx[k] != idx[k - 1]) push(idx[k]);
+    };
+
+    if (fSorted) {
+        int i0 = std::lower_bound(fX, fX + fNpoints, xmin) - fX;
+        int i1 = std::upper_bound(fX, fX + fNpoints, xmax) - fX;
+        // One point beyond each side keeps the line running to the frame
+        i0 = std::max(0, i0 - 1);
+        i1 = std::min(fNpoints, i1 + 1);
+
+        if (i1 - i0 <= 4 * pixels) {   // zoomed in to the raw points
+            for (int i = i0; i < i1; ++i) push(i);
+        } else {
+            for (int i = i0; i < i1;) {
+                if (fX[i] < xmin || fX[i] > xmax) { push(i++); continue; }
+                int c = column(fX[i]);
+                int j = c + 1 < pixels
+                    ? (int)(std::lower_bound(fX + i, fX + i1, edge(c + 1)) - fX)
+                    : (int)(std::upper_bound(fX + i, fX + i1, xmax) - fX);
+                if (j <= i) j = i + 1;   // rounding at the edge: always advance
+                int lo, hi;
+                RangeMinMax(i, j, lo, hi);
+                pushColumn(i, lo, hi, j - 1);
+                i = j;
+            }
+        }
+    } else {
+        struct Column { int first = -1, last = -1, lo = -1, hi = -1; };
+        std::vector<Column> columns(pixels);
+        for (int i = 0; i < fNpoints; ++i) {
+            double x = fX[i];
+            if (!(x >= xmin && x <= xmax)) continue;
+            Column& col = columns[column(x)];
+            if (col.first < 0) { col.first = col.lo = col.hi = i; }
+            if (fY[i] < fY[col.lo]) col.lo = i;
+            if (fY[i] > fY[col.hi]) col.hi = i;
+            col.last = i;
+        }
+        std::vector<int> keep;
+        for (const Column& col : columns) {
+            if (col.first < 0) continue;
+            keep.insert(keep.end(), { col.first, col.lo, col.hi, col.last });
+        }
+        std::sort(keep.begin(), keep.end());
+        keep.erase(std::unique(keep.begin(), keep.end()), keep.end());
+        for (int i : keep) push(i);
+    }
+    fDecimated = !fShownX.empty();
+}
+
+// ============================================================================
+// Painting / picking
+// ============================================================================
+void LODGraph::Paint(Option_t* option)
+{
+    fDecimated = false;
+    if (fNpoints < kMinPoints || !gPad) {
+        TGraph::Paint(option);
+        return;
+    }
+
+    // Visible x range: the graph's own axis when it draws one ("A"),
+    // otherwise the frame it is drawn into
+    TString opt = option;
+    opt.ToLower();
+    opt.ReplaceAll("same", "");
+    double xmin, xmax;
+    if (opt.Contains("a")) {
+        TAxis* axis = GetHistogram()->GetXaxis();   // ranged on all points, once
+        xmin = axis->GetBinLowEdge(axis->GetFirst());
+        xmax = axis->GetBinUpEdge(axis->GetLast());
+    } else {
+        xmin = gPad->GetUxmin();
+        xmax = gPad->GetUxmax();
+        if (gPad->GetLogx()) {
+            xmin = std::pow(10.0, xmin);
+            xmax = std::pow(10.0, xmax);
+        }
+    }
+    int pixels = (int)(gPad->GetWw() * gPad->GetAbsWNDC() *
+                       (1.0 - gPad->GetLeftMargin() - gPad->GetRightMargin()));
+    pixels = std::max(pixels, 100);
+
+    if (fIndexedN != fNpoints) BuildPyramid();
+    Decimate(xmin, xmax, pixels, gPad->GetLogx() && xmin > 0);
+    if (!fDecimated) {
+        TGraph::Paint(option);
+        return;
+    }
+
+    // Paint the decimated series in place of the points, then put them back
+    Double_t* x = fX;
+    Double_t* y = fY;
+    Int_t     n = fNpoints;
+    fX       = fShownX.data();
+    fY       = fShownY.data();
+    fNpoints = (Int_t)fShownX.size();
+    TGraph::Paint(option);
+    fX       = x;
+    fY       = y;
+    fNpoints = n;
+}
+
+Int_t LODGraph::DistancetoPrimitive(Int_t px, Int_t py)
+{
+    if (!fDecimated) return TGraph::DistancetoPrimitive(px, py);
+
+    // Mouse moves would otherwise walk all points
+    Double_t* x = fX;
+    Double_t* y = fY;
+    Int_t     n = fNpoints;
+    fX       = fShownX.data();
+    fY       = fShownY.data();
+    fNpoints = (Int_t)fShownX.size();
+    Int_t distance = TGraph::DistancetoPrimitive(px, py);
+    fX       = x;
+    fY       = y;
+    fNpoints = n;
+    return distance;
+}
@@ -0,0 +1,142 @@
+#include "MasterHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+// ============================================================================
+// MasterHistogram
+// ============================================================================
+bool MasterHistogram::Build(const ColumnData::Column& values)
+{
+    bool any = false;
+    double lo = 0.0, hi = 0.0;
+    fNegInf = fPosInf = 0.0;
+    for (double v : values) {
+        if (!std::isfinite(v)) {
+            if (v == -INFINITY)     fNegInf += 1;
+            else if (v == INFINITY) fPosInf += 1;
+            continue;   // NaN is dropped
+        }
+        if (!any) { lo = hi = v; any = true; }
+        else      { lo = std::min(lo, v); hi = std::max(hi, v); }
+    }
+    if (!any) return false;
+
+    fMin   = lo;
+    fMax   = hi > lo ? hi : lo + 1.0;   // one distinct value: any width will do
+    fWidth = (fMax - fMin) / kBins;
+    fCount.assign(kBins, 0.0);
+    fSumX.assign(kBins, 0.0);
+    fSumX2.assign(kBins, 0.0);
+
+    const double scale = kBins / (fMax - fMin);
+    for (double v : values) {
+        if (!std::isfinite(v)) continue;
+        int bin = std::min(kBins - 1, (int)((v - fMin) * scale));   // max -> last bin
+        fCount[bin] += 1;
+        fSumX[bin]  += v;
+        fSumX2[bin] += v * v;
+    }
+    return true;
+}
+
+bool MasterHistogram::CanDerive(int nbins, double xmin, double xmax) const
+{
+    if (fCount.empty() || nbins <= 0 || !(xmax > xmin)) return false;
+    // Each master bin then lies inside one target bin: nothing is moved
+    double ratio  = (xmax - xmin) / nbins / fWidth;
+    double offset = (xmin - fMin) / fWidth;
+    auto whole = [](double r) {
+        return std::fabs(r - std::round(r)) < 1e-9 * std::max(1.0, std::fabs(r));
+    };
+    return ratio >= 1 && whole(ratio) && whole(offset);
+}
+
+bool MasterHistogram::AlignRange(int nbins, double& xmin, double& xmax) const
+{
+    if (fCount.empty() || nbins <= 0 || !(xmax > xmin)) return false;
+    double first = std::floor((xmin - fMin) / fWidth);   // master edge <= xmin
+    double per   = std::max(1.0, std::ceil((xmax - fMin - first * fWidth) / nbins / fWidth));
+    double lo    = fMin + first * fWidth;
+    double hi    = lo + nbins * per * fWidth;
+    if (hi - lo > kMaxWiden * (xmax - xmin)) return false;   // bins too fine for the master
+    xmin = lo;
+    xmax = hi;
+    return true;
+}
+
+void MasterHistogram::FillHistogram(TH1& h) const
+{
+    const TAxis* axis  = h.GetXaxis();
+    const int    nbins = h.GetNbinsX();
+    std::vector<double> contents(nbins + 2, 0.0);
+    double stats[4] = { 0.0, 0.0, 0.0, 0.0 };   // sumw, sumw2, sumwx, sumwx2
+    double entries  = fNegInf + fPosInf;
+
+    for (int k = 0; k < kBins; ++k) {
+        if (fCount[k] == 0) continue;
+        int bin = axis->FindFixBin(fMin + (k + 0.5) * fWidth);
+        contents[bin] += fCount[k];
+        entries       += fCount[k];
+        if (bin >= 1 && bin <= nbins) {   // TH1 statistics leave out under/overflow
+            stats[0] += fCount[k];
+            stats[1] += fCount[k];
+            stats[2] += fSumX[k];
+            stats[3] += fSumX2[k];
+        }
+    }
+    contents[0]         += fNegInf;
+    contents[nbins + 1] += fPosInf;
+
+    for (int bin = 0; bin <= nbins + 1; ++bin)
+        if (contents[bin] != 0) h.SetBinContent(bin, contents[bin]);
+    h.SetEntries(entries);
+    h.PutStats(stats);
+}
+
+// ============================================================================
+// MasterHistCache
+// ============================================================================
+MasterHistCache& MasterHistCache::Instance()
+{
+    static MasterHistCache cache;
+    return cache;
+}
+
+std::shared_ptr<const MasterHistogram> MasterHistCache::Get(const ColumnData& data, int column)
+{
+    if (column < 0 || column >= (int)data.data.size()) return nullptr;
+
+    Key key(data.uid, column);
+    Entry existing;
+    std::promise<std::shared_ptr<const MasterHistogram>> promise;
+    {
+        std::lock_guard<std::mutex> lock(fMutex);
+        auto it = fEntries.find(key);
+        if (it != fEntries.end()) {
+            existing = it->second;
+        } else {
+            fEntries[key] = promise.get_future().share();
+            fOrder.push_back(key);
+            while (fOrder.size() > kMaxEntries) {
+                fEntries.erase(fOrder.front());   // holders keep their shared_ptr
+                fOrder.pop_front();
+            }
+        }
+    }
+    if (existing.valid()) return existing.get();   // may wait for another thread's build
+
+    // Build outside the lock: other columns need not wait
+    auto master = std::make_shared<MasterHistogram>();
+    std::shared_ptr<const MasterHistogram> result;
+    if (master->Build(data.data[column])) result = master;
+    promise.set_value(result);
+    return result;
+}
+
+void MasterHistCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    fEntries.clear();
+    fOrder.clear();
+}
@@ -0,0 +1,145 @@
+#include "PlotCache.h"
+
+#include <TGraph.h>
+#include <TGraphErrors.h>
+#include <TH1.h>
+#include <TList.h>
+
+#include <sstream>
+
+// ============================================================================
+// Keys
+// ============================================================================
+std::string PlotCache::MakeKey(const PlotConfig& config)
+{
+    std::ostringstream key;
+    key.precision(17);
+    key << "t" << config.type << "|x" << config.xColumn;
+
+    switch (PlotCreator::GetTypeInfo(config.type).family) {
+        case PlotTypeInfo::kGraph:
+            key << "|y" << config.yColumn;
+            break;
+        case PlotTypeInfo::kGraphErrors:
+            key << "|y" << config.yColumn
+                << "|ex" << config.xErrColumn << "|ey" << config.yErrColumn;
+            break;
+        case PlotTypeInfo::kHist1D:
+            key << "|b" << config.bins << "|" << config.xMin << "," << config.xMax;
+            break;
+        case PlotTypeInfo::kHist2D:
+            key << "|y" << config.yColumn
+                << "|b" << config.bins << "," << config.binsY
+                << "|" << config.xMin << "," << config.xMax
+                << "|" << config.yMin << "," << config.yMax;
+            break;
+        case PlotTypeInfo::kHist3D:
+            key << "|y" << config.yColumn << "|z" << config.zColumn
+                << "|b" << config.bins << "," << config.binsY << "," << config.binsZ
+                << "|" << config.xMin << "," << config.xMax
+                << "|" << config.yMin << "," << config.yMax
+                << "|" << config.zMin << "," << config.zMax;
+            break;
+        case PlotTypeInfo::kProfile1D:
+            key << "|y" << config.yColumn
+                << "|b" << config.bins
+                << "|" << config.xMin << "," << config.xMax
+                << "|" << config.yMin << "," << config.yMax;
+            break;
+        case PlotTypeInfo::kProfile2D:
+            key << "|y" << config.yColumn << "|z" << config.zColumn
+                << "|b" << config.bins << "," << config.binsY
+                << "|" << config.xMin << "," << config.xMax
+                << "|" << config.yMin << "," << config.yMax
+                << "|" << config.zMin << "," << config.zMax;
+            break;
+    }
+    if (PlotCreator::GetTypeInfo(config.type).family >= PlotTypeInfo::kHist1D)
+        key << "|w" << config.weightColumn;
+    key << "|c" << config.cut;
+    key << "|" << config.title;
+    return key.str();
+}
+
+// ============================================================================
+// Building / reuse
+// ============================================================================
+TObject* PlotCache::Build(const ColumnData& data, const PlotConfig& config)
+{
+    TObject* obj = PlotCreator::Create(data, config);
+
+    // The cache deletes it, not whatever file happens to be gDirectory
+    if (obj && obj->InheritsFrom(TH1::Class()))
+        static_cast<TH1*>(obj)->SetDirectory(nullptr);
+    return obj;
+}
+
+// Back to the state PlotCreator leaves a new object in: no fits, the
+// config's colour
+void PlotCache::Reset(TObject* obj, const PlotConfig& config)
+{
+    if (obj->InheritsFrom(TGraph::Class())) {
+        TGraph* g = static_cast<TGraph*>(obj);
+        if (TList* functions = g->GetListOfFunctions()) functions->Delete();
+        g->SetLineColor(config.color);
+        g->SetMarkerColor(config.color);
+    } else if (obj->InheritsFrom(TH1::Class())) {
+        TH1* h = static_cast<TH1*>(obj);
+        if (TList* functions = h->GetListOfFunctions()) functions->Delete();
+        if (h->GetDimension() == 1) h->SetLineColor(config.color);
+    }
+}
+
+// ============================================================================
+// Passes
+// ============================================================================
+void PlotCache::BeginPass(const ColumnData& data)
+{
+    if (data.uid != fDataUid) {
+        Clear();   // another table: nothing can be reused
+        fDataUid = data.uid;
+    }
+    for (auto& entry : fEntries) entry.second.used = false;
+    fOccurrences.clear();
+    fBuilt  = 0;
+    fReused = 0;
+}
+
+TObject* PlotCache::Get(const ColumnData& data, const PlotConfig& config)
+{
+    // Identical configs in one run are separate plots, each with its own object
+    std::string key = MakeKey(config);
+    key += "#" + std::to_string(fOccurrences[key]++);
+
+    Entry& entry = fEntries[key];
+    entry.used = true;
+    if (entry.object) {
+        Reset(entry.object.get(), config);
+        ++fReused;
+        return entry.object.get();
+    }
+
+    entry.object.reset(Build(data, config));
+    if (!entry.object) {
+        fEntries.erase(key);
+        return nullptr;
+    }
+    ++fBuilt;
+    return entry.object.get();
+}
+
+void PlotCache::EndPass()
+{
+    for (auto it = fEntries.begin(); it != fEntries.end();) {
+        if (it->second.used) ++it;
+        else                 it = fEntries.erase(it);
+    }
+    fOccurrences.clear();
+}
+
+void PlotCache::Clear()
+{
+    fEntries.clear();
+    fOccurrences.clear();
+    fDataUid = 0;
+}
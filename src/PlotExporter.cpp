@@ -0,0 +1,307 @@
+#include "PlotExporter.h"
+#include "ThreadPool.h"
+
+#include <TROOT.h>
+#include <TSystem.h>
+#include <TVirtualX.h>
+
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+
+namespace {
+
+// One result per line on the worker pipe: index, ok, seconds, message, files...
+std::string Sanitize(std::string s) {
+    std::replace_if(s.begin(), s.end(),
+                    [](char c) { return c == '\t' || c == '\n' || c == '\r'; }, ' ');
+    return s;
+}
+
+std::string EncodeResult(size_t index, const BatchResult& r) {
+    std::ostringstream os;
+    os << index << '\t' << (r.ok ? 1 : 0) << '\t' << r.seconds << '\t' << Sanitize(r.message);
+    for (const auto& f : r.written) os << '\t' << Sanitize(f);
+    os << '\n';
+    return os.str();
+}
+
+bool DecodeResult(const std::string& line, size_t& index, BatchResult& r) {
+    std::vector<std::string> fields;
+    std::string field;
+    std::istringstream is(line);
+    while (std::getline(is, field, '\t')) fields.push_back(field);
+    if (fields.size() < 3) return false;
+
+    char* end = nullptr;
+    index = std::strtoul(fields[0].c_str(), &end, 10);
+    if (end == fields[0].c_str()) return false;
+    r.ok      = (fields[1] == "1");
+    r.seconds = std::strtod(fields[2].c_str(), nullptr);
+    r.message = fields.size() > 3 ? fields[3] : "";
+    r.written.assign(fields.begin() + std::min<size_t>(4, fields.size()), fields.end());
+    return true;
+}
+
+void WriteAll(int fd, const std::string& s) {
+    const char* p = s.data();
+    size_t left = s.size();
+    while (left > 0) {
+        ssize_t n = write(fd, p, left);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        p += n;
+        left -= n;
+    }
+}
+
+struct Worker {
+    pid_t               pid = -1;
+    int                 fd  = -1;
+    std::vector<size_t> indices;
+    std::string         buffer;
+};
+
+} // namespace
+
+unsigned PlotExporter::DefaultWorkers()
+{
+    return ThreadPool::DefaultSize();
+}
+
+// ============================================================================
+// Render jobs[indices] here, on up to nThreads threads
+// ============================================================================
+std::vector<BatchResult> PlotExporter::RenderInProcess(
+    const std::vector<BatchJob>& jobs, const std::vector<size_t>& indices,
+    const DataLookup& lookup, unsigned nThreads,
+    const std::function<void(size_t, const BatchResult&)>& done)
+{
+    // Never open windows, even when called from the GUI process
+    Bool_t wasBatch = gROOT->IsBatch();
+    gROOT->SetBatch(kTRUE);
+
+    auto renderOne = [&](size_t index) {
+        const BatchJob& job = jobs[index];
+        BatchResult r;
+        std::shared_ptr<const ColumnData> data = lookup(job.input);
+        if (!data) {
+            r.name    = job.name;
+            r.message = "cannot read input " + job.input;
+            return r;
+        }
+        try {
+            r = BatchEngine::RenderJob(job, *data);
+        } catch (const std::exception& e) {
+            r.name    = job.name;
+            r.message = e.what();
+        }
+        return r;
+    };
+
+    std::vector<BatchResult> results(indices.size());
+    if (nThreads <= 1 || indices.size() <= 1) {
+        for (size_t k = 0; k < indices.size(); ++k) {
+            results[k] = renderOne(indices[k]);
+            done(indices[k], results[k]);
+        }
+    } else {
+        ThreadPool pool(std::min<unsigned>(nThreads, (unsigned)indices.size()));
+        std::vector<std::future<BatchResult>> futures;
+        for (size_t index : indices)
+            futures.push_back(pool.Submit([&renderOne, index]() { return renderOne(index); }));
+        for (size_t k = 0; k < indices.size(); ++k) {
+            results[k] = futures[k].get();
+            done(indices[k], results[k]);
+        }
+    }
+
+    gROOT->SetBatch(wasBatch);
+    return results;
+}
+
+// ============================================================================
+// Render all jobs, fanned out over nWorkers forked processes
+// ============================================================================
+std::vector<BatchResult> PlotExporter::Render(const std::vector<BatchJob>& jobs,
+                                              const DataLookup& lookup,
+                                              unsigned nWorkers, unsigned nThreads,
+                                              const Progress& progress)
+{
+    std::vector<BatchResult> results(jobs.size());
+    std::vector<bool>        reported(jobs.size(), false);
+    size_t nDone = 0;
+    auto report = [&](size_t index, const BatchResult& r) {
+        if (index >= jobs.size() || reported[index]) return;
+        results[index]      = r;
+        results[index].name = jobs[index].name;
+        reported[index]     = true;
+        ++nDone;
+        if (progress) progress(nDone, jobs.size());
+    };
+
+    if (nWorkers == 0 || jobs.empty()) {
+        std::vector<size_t> all(jobs.size());
+        std::iota(all.begin(), all.end(), 0);
+        RenderInProcess(jobs, all, lookup, nThreads, report);
+        return results;
+    }
+
+    nWorkers = std::min<unsigned>(nWorkers, (unsigned)jobs.size());
+    std::vector<Worker> workers(nWorkers);
+    for (size_t i = 0; i < jobs.size(); ++i)
+        workers[i % nWorkers].indices.push_back(i);
+
+    // Buffered output would otherwise be flushed once per child too
+    std::cout.flush();
+    std::cerr.flush();
+    fflush(nullptr);
+
+    std::vector<size_t> unforked;
+    for (auto& w : workers) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            unforked.insert(unforked.end(), w.indices.begin(), w.indices.end());
+            continue;
+        }
+        pid_t pid = fork();
+        if (pid < 0) {
+            close(fds[0]);
+            close(fds[1]);
+            unforked.insert(unforked.end(), w.indices.begin(), w.indices.end());
+            continue;
+        }
+        if (pid == 0) {
+            // Worker: offscreen only, and keep off the parent's display
+            close(fds[0]);
+            for (auto& other : workers)
+                if (other.fd >= 0) close(other.fd);
+            gROOT->SetBatch(kTRUE);
+            if (gGXBatch) gVirtualX = gGXBatch;
+
+            RenderInProcess(jobs, w.indices, lookup, nThreads,
+                            [&](size_t index, const BatchResult& r) {
+                                WriteAll(fds[1], EncodeResult(index, r));
+                            });
+            close(fds[1]);
+            std::cout.flush();
+            std::cerr.flush();
+            fflush(nullptr);
+            _exit(0);
+        }
+        close(fds[1]);
+        w.pid = pid;
+        w.fd  = fds[0];
+    }
+
+    // Collect result lines until every worker has closed its pipe
+    for (;;) {
+        std::vector<pollfd>  pfds;
+        std::vector<Worker*> owners;
+        for (auto& w : workers) {
+            if (w.fd < 0) continue;
+            pfds.push_back({ w.fd, POLLIN, 0 });
+            owners.push_back(&w);
+        }
+        if (pfds.empty()) break;
+
+        if (poll(pfds.data(), pfds.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            for (auto* w : owners) { close(w->fd); w->fd = -1; }
+            break;
+        }
+
+        for (size_t k = 0; k < pfds.size(); ++k) {
+            if (!(pfds[k].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            Worker& w = *owners[k];
+            char buf[4096];
+            ssize_t got = read(w.fd, buf, sizeof(buf));
+            if (got < 0 && errno == EINTR) continue;
+            if (got <= 0) {
+                close(w.fd);
+                w.fd = -1;
+                continue;
+            }
+            w.buffer.append(buf, got);
+            size_t nl;
+            while ((nl = w.buffer.find('\n')) != std::string::npos) {
+                std::string line = w.buffer.substr(0, nl);
+                w.buffer.erase(0, nl + 1);
+                size_t index = 0;
+                BatchResult r;
+                if (DecodeResult(line, index, r)) report(index, r);
+            }
+        }
+    }
+
+    // Jobs a worker never reported (crash, kill) are failures, not hangs
+    for (auto& w : workers) {
+        if (w.pid < 0) continue;
+        int status = 0;
+        while (waitpid(w.pid, &status, 0) < 0 && errno == EINTR) {}
+        std::string why = WIFSIGNALED(status)
+            ? "worker killed by signal " + std::to_string(WTERMSIG(status))
+            : "worker exited with status " + std::to_string(WEXITSTATUS(status));
+        for (size_t index : w.indices) {
+            if (reported[index]) continue;
+            BatchResult r;
+            r.message = why;
+            report(index, r);
+        }
+    }
+
+    // No fork available: still produce the plots, just here
+    if (!unforked.empty())
+        RenderInProcess(jobs, unforked, lookup, nThreads, report);
+
+    return results;
+}
+
+// ============================================================================
+// Manifest
+// ============================================================================
+bool PlotExporter::WriteManifest(const std::string& path,
+                                 const std::vector<BatchJob>& jobs,
+                                 const std::vector<BatchResult>& results)
+{
+    TString dir = gSystem->GetDirName(path.c_str());
+    if (dir.Length() > 0 && gSystem->AccessPathName(dir))
+        gSystem->mkdir(dir, kTRUE);
+
+    std::ofstream out(path);
+    if (!out.is_open()) return false;
+
+    out << "# AdvancedPlotGUI export manifest\n";
+    out << "# job\tstatus\tformat\tbytes\tseconds\tfile\n";
+    for (size_t i = 0; i < jobs.size() && i < results.size(); ++i) {
+        const BatchResult& r = results[i];
+        for (const auto& file : jobs[i].outputs) {
+            bool written = std::find(r.written.begin(), r.written.end(), file) != r.written.end();
+            Long64_t bytes = 0;
+            FileStat_t st;
+            if (written && gSystem->GetPathInfo(file.c_str(), st) == 0) bytes = st.fSize;
+
+            size_t dot = file.find_last_of('.');
+            std::string format = dot == std::string::npos ? "" : file.substr(dot + 1);
+            std::transform(format.begin(), format.end(), format.begin(),
+                           [](unsigned char c) { return std::tolower(c); });
+
+            out << jobs[i].name << '\t' << (written ? "ok" : "missing") << '\t'
+                << format << '\t' << bytes << '\t' << r.seconds << '\t' << file << '\n';
+        }
+    }
+    return out.good();
+}
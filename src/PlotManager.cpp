@@ -3,9 +3,16 @@
 #include "ColumnSelectorDialog.h"
 #include "PlotTypes.h"    // defines PlotConfig and PlotCreator
 #include "ErrorHandling.h"
+#include "PlotExporter.h"
+#include "PlotCache.h"
+#include "BatchFitter.h"
+#include "RooFitBackend.h"
+#include "UnbinnedFit.h"
+#include "RowSelection.h"
 
 #include <TGClient.h>
 #include <TGMsgBox.h>
+#include <TGFileDialog.h>
 #include <TCanvas.h>
 #include <TGraph.h>
 #include <TGraphErrors.h>
@@ -17,13 +24,6 @@
 #include <TSystem.h>
 #include <TStyle.h>
 
-#include <RooRealVar.h>
-#include <RooDataHist.h>
-#include <RooGaussian.h>
-#include <RooPlot.h>
-#include <RooFitResult.h>
-#include <RooFit.h>
-
 #include <iostream>
 
 
@@ -115,6 +115,9 @@ void PlotManager::CreatePlots(const std::string& canvasTitle, Bool_t overlayMode
         return;
     }
 
+    // Unchanged plots come back from the cache; what the run does not use
+    // any more is deleted at the end
+    fPlotCache.BeginPass(data);
     if (dividedMode) {
         CreateDividedCanvas(canvasTitle, fitType, customFunc, data);
     } else if (overlayMode) {
@@ -122,11 +125,188 @@ void PlotManager::CreatePlots(const std::string& canvasTitle, Bool_t overlayMode
     } else {
         CreateSeparateCanvases(canvasTitle, fitType, customFunc, data);
     }
+    RunQueuedFits(fitType, customFunc);
+    fPlotCache.EndPass();
+    std::cout << "[Plot] " << fPlotCache.GetBuilt() << " object(s) built, "
+              << fPlotCache.GetReused() << " reused" << std::endl;
     
     gSystem->ProcessEvents();
     ShowInfo(fMainGUI, "Plot Created", "Check the Plot Info in the terminal.\n\n");
 }
 
+// ============================================================================
+// Export plots to files (offscreen, parallel)
+// ============================================================================
+void PlotManager::ExportPlots(const std::string& canvasTitle, Bool_t overlayMode,
+                              Bool_t dividedMode, Int_t nRows, Int_t nCols,
+                              FitUtils::FitType fitType, const std::string& customFunc,
+                              std::shared_ptr<const ColumnData> data)
+{
+    if (fPlotConfigs.empty()) {
+        new TGMsgBox(gClient->GetRoot(), fMainGUI,
+            "Warning", "No plots configured. Use 'Add Plot...' to create plots.",
+            kMBIconExclamation, kMBOk);
+        return;
+    }
+    if (!data || data->data.empty()) {
+        ShowError(fMainGUI, "No Data", "No data loaded to export.");
+        return;
+    }
+
+    const char* filetypes[] = {
+        "PNG image",      "*.png",
+        "PDF document",   "*.pdf",
+        "SVG image",      "*.svg",
+        "All files",      "*",
+        nullptr, nullptr
+    };
+    TGFileInfo fileInfo;
+    fileInfo.fFileTypes = filetypes;
+    fileInfo.fIniDir    = StrDup(".");
+    new TGFileDialog(gClient->GetRoot(), fMainGUI, kFDSave, &fileInfo);
+    if (!fileInfo.fFilename) return;
+
+    // <dir>/<stem>.<ext>: one canvas -> that file, several -> <stem>_N.<ext>
+    std::string base = fileInfo.fFilename;
+    std::string stem = base, ext = "png";
+    size_t dot   = base.find_last_of('.');
+    size_t slash = base.find_last_of('/');
+    if (dot != std::string::npos && (slash == std::string::npos || dot > slash)) {
+        stem = base.substr(0, dot);
+        ext  = base.substr(dot + 1);
+    }
+
+    auto makePlot = [&](size_t i) {
+        BatchPlot plot;
+        plot.config       = fPlotConfigs[i];
+        plot.config.color = (i % 9) + 1;
+        plot.fit          = fitType;
+        plot.fitFormula   = customFunc;
+        return plot;
+    };
+
+    std::vector<BatchJob> jobs;
+    if (dividedMode || overlayMode) {
+        BatchJob job;
+        job.name    = canvasTitle;
+        job.input   = data->filename;
+        job.overlay = !dividedMode;
+        job.nCols   = nCols;
+        job.nRows   = nRows;
+        for (size_t i = 0; i < fPlotConfigs.size(); ++i) job.plots.push_back(makePlot(i));
+        job.outputs.push_back(stem + "." + ext);
+        jobs.push_back(job);
+    } else {
+        for (size_t i = 0; i < fPlotConfigs.size(); ++i) {
+            BatchJob job;
+            job.name  = canvasTitle + "_" + std::to_string(i + 1);
+            job.input = data->filename;
+            job.plots.push_back(makePlot(i));
+            job.outputs.push_back(fPlotConfigs.size() == 1
+                ? stem + "." + ext
+                : stem + "_" + std::to_string(i + 1) + "." + ext);
+            jobs.push_back(job);
+        }
+    }
+
+    fMainGUI->EnablePlotControls(kFALSE);
+    fMainGUI->SetLoadProgress(0, Form("Exporting %zu canvas(es) ...", jobs.size()));
+    gSystem->ProcessEvents();
+
+    // Workers inherit the loaded table through fork(); nothing is re-read
+    std::vector<BatchResult> results = PlotExporter::Render(
+        jobs, [data](const std::string&) { return data; },
+        PlotExporter::DefaultWorkers(), 1,
+        [this](size_t done, size_t total) {
+            fMainGUI->SetLoadProgress(100.0f * done / total,
+                                      Form("Exported %zu/%zu", done, total));
+            gSystem->ProcessEvents();
+        });
+
+    std::string manifest = stem + ".manifest.tsv";
+    Bool_t manifestOK = PlotExporter::WriteManifest(manifest, jobs, results);
+
+    size_t nWritten = 0, nFailed = 0;
+    for (const auto& r : results) {
+        nWritten += r.written.size();
+        if (!r.ok) {
+            ++nFailed;
+            std::cerr << "[Export] " << r.name << ": " << r.message << std::endl;
+        }
+    }
+
+    fMainGUI->SetLoadProgress(100, Form("Exported %zu file(s)", nWritten));
+    fMainGUI->EnablePlotControls(kTRUE);
+
+    TString msg = Form("Wrote %zu file(s) for %zu canvas(es).\n", nWritten, jobs.size());
+    msg += manifestOK ? Form("Manifest: %s", manifest.c_str())
+                      : Form("Could not write manifest %s", manifest.c_str());
+    if (nFailed > 0) {
+        msg += Form("\n\n%zu canvas(es) failed; see the terminal.", nFailed);
+        ShowWarning(fMainGUI, "Export", msg.Data());
+    } else {
+        ShowInfo(fMainGUI, "Export", msg.Data());
+    }
+}
+
+// ============================================================================
+// Build (or reuse) one plot, draw it into the current pad, add it to the
+// legend and apply or queue its fit; nullptr if it could not be built
+// ============================================================================
+TObject* PlotManager::DrawPlot(const PlotConfig& config, Bool_t same, FitUtils::FitType fitType,
+                               const std::string& customFunc, const ColumnData& data,
+                               TLegend* legend)
+{
+    TObject* obj = fPlotCache.Get(data, config);
+    if (!obj) return nullptr;
+
+    const PlotTypeInfo& info = PlotCreator::GetTypeInfo(config.type);
+    obj->Draw(same && info.sameOption ? info.sameOption : info.drawOption);
+
+    if (legend && info.legendOption) {
+        std::string legendLabel = info.dimension >= 2
+            ? Form("%s vs %s",
+                   data.headers[config.xColumn].c_str(),
+                   data.headers[config.yColumn].c_str())
+            : data.headers[config.xColumn];
+        legend->AddEntry(obj, legendLabel.c_str(), info.legendOption);
+    }
+
+    switch (info.family) {
+        case PlotTypeInfo::kGraph:
+        case PlotTypeInfo::kGraphErrors:
+        case PlotTypeInfo::kProfile1D:   // a TF1 through the bin means, never RooFit
+            QueueFit(obj, fitType, config.color);
+            break;
+        case PlotTypeInfo::kHist1D: {
+            TH1* h = static_cast<TH1*>(obj);
+            bool unbinned = fMainGUI->UseUnbinnedFit() &&
+                (fitType == FitUtils::kGaus || fitType == FitUtils::kCustom);
+            // The likelihood has no event weights: weighted histograms are fitted binned
+            if (unbinned && config.weightColumn >= 0) {
+                std::cerr << "Unbinned fit: not available for weighted histograms, "
+                             "fitting the bins instead" << std::endl;
+                unbinned = false;
+            }
+            if (unbinned) {
+                ApplyUnbinnedFit(h, data, config, fitType, customFunc);
+            } else if (fitType == FitUtils::kGaus) {
+                ApplyRooFitGaussian(h, config.color);
+            } else {
+                QueueFit(h, fitType, config.color);
+            }
+            break;
+        }
+        case PlotTypeInfo::kHist2D:
+            ApplyFit(obj, fitType, config.color, customFunc);
+            break;
+        case PlotTypeInfo::kHist3D:
+        case PlotTypeInfo::kProfile2D:
+            break;
+    }
+    return obj;
+}
+
 // ============================================================================
 // Create divided canvas
 // ============================================================================
@@ -145,52 +325,7 @@ void PlotManager::CreateDividedCanvas(const std::string& title, FitUtils::FitTyp
         config.color = (i % 9) + 1;
         if (config.color == 0) config.color = 1;
 
-        if (config.type == PlotConfig::kTGraph) {
-            TGraph* g = PlotCreator::CreateTGraph(data, config);
-            if (g) {
-                g->Draw("APL");
-                gROOT->GetListOfGlobals()->Add(g);
-                ApplyFit(g, fitType, config.color, customFunc);
-            }
-        } else if (config.type == PlotConfig::kTGraphErrors) {
-            TGraphErrors* g = PlotCreator::CreateTGraphErrors(data, config);
-            if (g) {
-                g->Draw("APE");
-                gROOT->GetListOfGlobals()->Add(g);
-                ApplyFit(g, fitType, config.color, customFunc);
-            }
-        } else if (config.type == PlotConfig::kTH1D || 
-                   config.type == PlotConfig::kTH1F || 
-                   config.type == PlotConfig::kTH1I) {
-            TH1* h = PlotCreator::CreateTH1(data, config);
-            if (h) {
-                h->Draw();
-                gROOT->GetListOfGlobals()->Add(h);
-                
-                if (fitType == FitUtils::kGaus) {
-                    ApplyRooFitGaussian(h, config.color);
-                } else {
-                    ApplyFit(h, fitType, config.color, customFunc);
-                }
-            }
-        } else if (config.type == PlotConfig::kTH2D || 
-                   config.type == PlotConfig::kTH2F || 
-                   config.type == PlotConfig::kTH2I) {
-            TH2* h = PlotCreator::CreateTH2(data, config);
-            if (h) {
-                h->Draw("COLZ");
-                gROOT->GetListOfGlobals()->Add(h);
-                ApplyFit(h, fitType, config.color, customFunc);
-            }
-        } else if (config.type == PlotConfig::kTH3D || 
-                   config.type == PlotConfig::kTH3F || 
-                   config.type == PlotConfig::kTH3I) {
-            TH3* h = PlotCreator::CreateTH3(data, config);
-            if (h) {
-                h->Draw("ISO");
-                gROOT->GetListOfGlobals()->Add(h);
-            }
-        }
+        DrawPlot(config, kFALSE, fitType, customFunc, data, nullptr);
     }
 
     canvas->Update();
@@ -218,69 +353,8 @@ void PlotManager::CreateOverlayCanvas(const std::string& title, FitUtils::FitTyp
         config.color = (i % 9) + 1;
         if (config.color == 0) config.color = 1;
 
-        if (config.type == PlotConfig::kTGraph) {
-            TGraph* g = PlotCreator::CreateTGraph(data, config);
-            if (g) {
-                g->Draw(firstDraw ? "APL" : "PL SAME");
-                gROOT->GetListOfGlobals()->Add(g);
-                
-                std::string legendLabel = Form("%s vs %s", 
-                    data.headers[config.xColumn].c_str(),
-                    data.headers[config.yColumn].c_str());
-                padLegend->AddEntry(g, legendLabel.c_str(), "lp");
-                
-                ApplyFit(g, fitType, config.color, customFunc);
-                firstDraw = kFALSE;
-            }
-        } else if (config.type == PlotConfig::kTGraphErrors) {
-            TGraphErrors* g = PlotCreator::CreateTGraphErrors(data, config);
-            if (g) {
-                g->Draw(firstDraw ? "APE" : "PE SAME");
-                gROOT->GetListOfGlobals()->Add(g);
-                
-                std::string legendLabel = Form("%s vs %s", 
-                    data.headers[config.xColumn].c_str(),
-                    data.headers[config.yColumn].c_str());
-                padLegend->AddEntry(g, legendLabel.c_str(), "lpe");
-                
-                ApplyFit(g, fitType, config.color, customFunc);
-                firstDraw = kFALSE;
-            }
-        } else if (config.type == PlotConfig::kTH1D || 
-                   config.type == PlotConfig::kTH1F || 
-                   config.type == PlotConfig::kTH1I) {
-            TH1* h = PlotCreator::CreateTH1(data, config);
-            if (h) {
-                h->Draw(firstDraw ? "" : "SAME");
-                gROOT->GetListOfGlobals()->Add(h);
-                
-                std::string legendLabel = Form("%s", data.headers[config.xColumn].c_str());
-                padLegend->AddEntry(h, legendLabel.c_str(), "l");
-                
-                if (fitType == FitUtils::kGaus) {
-                    ApplyRooFitGaussian(h, config.color);
-                } else {
-                    ApplyFit(h, fitType, config.color, customFunc);
-                }
-                firstDraw = kFALSE;
-            }
-        } else if (config.type == PlotConfig::kTH2D || 
-                   config.type == PlotConfig::kTH2F || 
-                   config.type == PlotConfig::kTH2I) {
-            TH2* h = PlotCreator::CreateTH2(data, config);
-            if (h) {
-                h->Draw("COLZ");
-                gROOT->GetListOfGlobals()->Add(h);
-            }
-        } else if (config.type == PlotConfig::kTH3D || 
-                   config.type == PlotConfig::kTH3F || 
-                   config.type == PlotConfig::kTH3I) {
-            TH3* h = PlotCreator::CreateTH3(data, config);
-            if (h) {
-                h->Draw("ISO");
-                gROOT->GetListOfGlobals()->Add(h);
-            }
-        }
+        if (DrawPlot(config, !firstDraw, fitType, customFunc, data, padLegend))
+            firstDraw = kFALSE;
         
         // Draw legend if it has entries
         if (padLegend->GetNRows() > 0) {
@@ -311,67 +385,7 @@ void PlotManager::CreateSeparateCanvases(const std::string& title, FitUtils::Fit
         canvasLegend->SetFillColor(0);
         canvasLegend->SetTextSize(0.03);
 
-        if (config.type == PlotConfig::kTGraph) {
-            TGraph* g = PlotCreator::CreateTGraph(data, config);
-            if (g) {
-                g->Draw("APL");
-                gROOT->GetListOfGlobals()->Add(g);
-                
-                std::string legendLabel = Form("%s vs %s", 
-                    data.headers[config.xColumn].c_str(),
-                    data.headers[config.yColumn].c_str());
-                canvasLegend->AddEntry(g, legendLabel.c_str(), "lp");
-                
-                ApplyFit(g, fitType, config.color, customFunc);
-            }
-        } else if (config.type == PlotConfig::kTGraphErrors) {
-            TGraphErrors* g = PlotCreator::CreateTGraphErrors(data, config);
-            if (g) {
-                g->Draw("APE");
-                gROOT->GetListOfGlobals()->Add(g);
-                
-                std::string legendLabel = Form("%s vs %s", 
-                    data.headers[config.xColumn].c_str(),
-                    data.headers[config.yColumn].c_str());
-                canvasLegend->AddEntry(g, legendLabel.c_str(), "lpe");
-                
-                ApplyFit(g, fitType, config.color, customFunc);
-            }
-        } else if (config.type == PlotConfig::kTH1D || 
-                   config.type == PlotConfig::kTH1F || 
-                   config.type == PlotConfig::kTH1I) {
-            TH1* h = PlotCreator::CreateTH1(data, config);
-            if (h) {
-                h->Draw();
-                gROOT->GetListOfGlobals()->Add(h);
-                
-                std::string legendLabel = Form("%s", data.headers[config.xColumn].c_str());
-                canvasLegend->AddEntry(h, legendLabel.c_str(), "l");
-                
-                if (fitType == FitUtils::kGaus) {
-                    ApplyRooFitGaussian(h, config.color);
-                } else {
-                    ApplyFit(h, fitType, config.color, customFunc);
-                }
-            }
-        } else if (config.type == PlotConfig::kTH2D || 
-                   config.type == PlotConfig::kTH2F || 
-                   config.type == PlotConfig::kTH2I) {
-            TH2* h = PlotCreator::CreateTH2(data, config);
-            if (h) {
-                h->Draw("COLZ");
-                gROOT->GetListOfGlobals()->Add(h);
-                ApplyFit(h, fitType, config.color, customFunc);
-            }
-        } else if (config.type == PlotConfig::kTH3D || 
-                   config.type == PlotConfig::kTH3F || 
-                   config.type == PlotConfig::kTH3I) {
-            TH3* h = PlotCreator::CreateTH3(data, config);
-            if (h) {
-                h->Draw("ISO");
-                gROOT->GetListOfGlobals()->Add(h);
-            }
-        }
+        DrawPlot(config, kFALSE, fitType, customFunc, data, canvasLegend);
         
         // Draw legend if it has entries
         if (canvasLegend->GetNRows() > 0) {
@@ -393,36 +407,119 @@ void PlotManager::ApplyFit(TObject* obj, FitUtils::FitType type, Int_t color,
 }
 
 // ============================================================================
-// Apply RooFit Gaussian
+// Queue a TF1 fit; RunQueuedFits() fits everything queued in one batch
 // ============================================================================
-void PlotManager::ApplyRooFitGaussian(TH1* hist, Int_t color)
+void PlotManager::QueueFit(TObject* obj, FitUtils::FitType type, Int_t color)
 {
-    if (!hist) return;
+    if (!obj || type == FitUtils::kNoFit) return;
+    fPendingFits.push_back({ obj, gPad, color });
+}
 
-    Double_t mean = hist->GetMean();
-    Double_t sigma = hist->GetRMS();
-    Double_t min = hist->GetXaxis()->GetXmin();
-    Double_t max = hist->GetXaxis()->GetXmax();
+// ============================================================================
+// Run the queued fits concurrently and attach the results to their objects
+// ============================================================================
+void PlotManager::RunQueuedFits(FitUtils::FitType type, const std::string& customFunc)
+{
+    if (fPendingFits.empty()) return;
+
+    std::vector<TObject*> objects;
+    for (const auto& pending : fPendingFits) objects.push_back(pending.object);
+
+    FitSpec spec;
+    spec.type    = type;
+    spec.formula = customFunc;
+    // Periodic fits have many local minima: try several frequencies at once
+    if (type == FitUtils::kSine || type == FitUtils::kSineOffset || type == FitUtils::kDampedSine)
+        spec.starts = kPeriodicFitStarts;
+
+    std::vector<TF1*>   fitted;
+    std::vector<FitRow> rows = BatchFitter::FitAll(objects, spec, 0, &fitted);
+
+    for (size_t i = 0; i < fPendingFits.size(); ++i) {
+        TF1* fit = fitted[i];
+        if (!fit) continue;
+        fit->SetLineColor(fPendingFits[i].color);
+        fit->SetLineWidth(2);
+        fit->SetLineStyle(2);  // dashed line
+
+        // As TGraph::Fit/TH1::Fit do: the object owns and paints its fit
+        TObject* obj = fPendingFits[i].object;
+        TList* functions = obj->InheritsFrom(TGraph::Class())
+            ? static_cast<TGraph*>(obj)->GetListOfFunctions()
+            : static_cast<TH1*>(obj)->GetListOfFunctions();
+        functions->Add(fit);
+
+        if (fPendingFits[i].pad) {
+            fPendingFits[i].pad->Modified();
+            fPendingFits[i].pad->Update();
+        }
+    }
 
-    RooRealVar x("x", "x", min, max);
-    RooDataHist data("data", "dataset", x, hist);
+    BatchFitter::PrintTable(rows, std::cout);
+    fPendingFits.clear();
+}
 
-    RooRealVar mu("mu", "mean", mean, mean - 3*sigma, mean + 3*sigma);
-    RooRealVar sig("sig", "sigma", sigma, 0.1*sigma, 3*sigma);
-    RooGaussian gauss("gauss", "gaussian", x, mu, sig);
+// ============================================================================
+// Unbinned fit of the histogram's column, drawn over the histogram
+// ============================================================================
+void PlotManager::ApplyUnbinnedFit(TH1* hist, const ColumnData& data, const PlotConfig& config,
+                                   FitUtils::FitType fitType, const std::string& customFunc)
+{
+    if (!hist) return;
 
-    RooFitResult* result = gauss.fitTo(data, RooFit::Save(), RooFit::PrintLevel(-1));
+    UnbinnedSpec spec;
+    spec.type    = fitType;
+    spec.formula = customFunc;
+    spec.xMin    = hist->GetXaxis()->GetXmin();
+    spec.xMax    = hist->GetXaxis()->GetXmax();
+
+    // The rows of the plot's cut only
+    UnbinnedResult result;
+    std::string cutError;
+    std::shared_ptr<const RowSelection> sel =
+        config.cut.empty() ? nullptr : CutCache::Instance().Get(data, config.cut, cutError);
+    if (sel && config.xColumn >= 0 && config.xColumn < (int)data.data.size()) {
+        sel = DropNulls(sel, data, { config.xColumn });
+        const ColumnData::Column& column = data.data[config.xColumn];
+        ColumnData::Column values;
+        values.reserve(sel->Count());
+        sel->ForEach(column.size(), [&](size_t i) { values.push_back(column[i]); });
+        result = UnbinnedFit::Fit(values, spec);
+    } else if (config.cut.empty()) {
+        result = UnbinnedFit::Fit(data, config.xColumn, spec);
+    } else {
+        std::cerr << "Unbinned fit: bad cut " << cutError << std::endl;
+        return;
+    }
+    UnbinnedFit::Print(result, std::cout);
+
+    TF1* curve = result.status >= 0
+        ? UnbinnedFit::MakeCurve(result, spec, hist->GetXaxis()->GetBinWidth(1),
+                                 Form("unbinned_%s", hist->GetName()))
+        : nullptr;
+    if (!curve) return;
+    curve->SetLineColor(config.color);
+    curve->SetLineWidth(2);
+    curve->SetLineStyle(2);  // dashed line
+    hist->GetListOfFunctions()->Add(curve);
+
+    if (gPad) {
+        gPad->Modified();
+        gPad->Update();
+    }
+}
 
-    RooPlot* frame = x.frame();
-    data.plotOn(frame);
-    gauss.plotOn(frame, RooFit::LineColor(color));
-    frame->Draw("same");
+// ============================================================================
+// Apply RooFit Gaussian
+// ============================================================================
+void PlotManager::ApplyRooFitGaussian(TH1* hist, Int_t color)
+{
+    if (!hist) return;
 
-    std::cout << "\n=== RooFit Gaussian Fit Results ===" << std::endl;
-    result->Print();
-    std::cout << "Mean: " << mu.getVal() << " ± " << mu.getError() << std::endl;
-    std::cout << "Sigma: " << sig.getVal() << " ± " << sig.getError() << std::endl;
-    std::cout << "===================================\n" << std::endl;
+    RooFitBackend& backend = RooFitBackend::Instance();
+    RooFitGaussResult result = backend.FitGaussian(hist);
+    backend.DrawGaussian(hist, result, color);
+    RooFitBackend::Print(result, std::cout);
 }
 
 // ============================================================================
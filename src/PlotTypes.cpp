@@ -1,203 +1,354 @@
 #include "PlotTypes.h"
+#include "MasterHistogram.h"
+#include "LODGraph.h"
+#include "ColumnGraphErrors.h"
+#include "RowSelection.h"
 
 #include <TH1D.h>
 #include <TH1F.h>
 #include <TH1I.h>
 #include <TH2D.h>
 #include <TH2F.h>
+#include <TH2I.h>
 #include <TH3D.h>
 #include <TH3F.h>
+#include <TH3I.h>
+#include <TProfile.h>
+#include <TProfile2D.h>
 #include <TGraph.h>
 #include <TGraphErrors.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <initializer_list>
 #include <iostream>
 #include <string>
+#include <utility>
 
 // ============================================================================
 // Helper: unique histogram name counter so ROOT never complains about
 // duplicate names when multiple plots are created in the same session.
+// Atomic: batch jobs create plots from several threads at once.
 // ============================================================================
-static int gPlotCount = 0;
+static std::atomic<int> gPlotCount{0};
 static std::string UniqueName(const char* prefix)
 {
     return std::string(prefix) + "_" + std::to_string(++gPlotCount);
 }
 
-namespace PlotCreator {
+// ============================================================================
+// Helpers for 1-D histograms of a column: the range for auto-range from the
+// column's MasterHistogram (no scan, widened onto master edges), and the
+// fill derived from it when the binning allows, from the raw values
+// otherwise.
+// ============================================================================
+static void AutoRange(const MasterHistogram* master, const ColumnData::Column& values,
+                      int nbins, double& xmin, double& xmax)
+{
+    if (master) {
+        xmin = master->GetMin();
+        xmax = master->GetMax();
+    } else {
+        for (double v : values) {
+            if (xmin == xmax) { xmin = xmax = v; }
+            else { xmin = std::min(xmin, v); xmax = std::max(xmax, v); }
+        }
+    }
+    double margin = (xmax - xmin) * 0.05;
+    xmin -= margin;  xmax += margin;
+    if (master) master->AlignRange(nbins, xmin, xmax);   // derived fill is exact
+}
+
+template <class H>
+static void FillColumn(H* h, const MasterHistogram* master, const ColumnData::Column& values)
+{
+    const TAxis* axis = h->GetXaxis();
+    if (master && master->CanDerive(axis->GetNbins(), axis->GetXmin(), axis->GetXmax())) {
+        master->FillHistogram(*h);
+        return;
+    }
+    for (double v : values) h->H::Fill(v);   // qualified: no virtual call
+}
+
+static void ColumnRange(const ColumnData::Column& v, double& lo, double& hi)
+{
+    lo = hi = 0.0;
+    bool any = false;
+    for (double x : v) {
+        if (x != x) continue;   // null
+        if (!any) { lo = hi = x; any = true; }
+        else      { lo = std::min(lo, x); hi = std::max(hi, x); }
+    }
+    double m = (hi - lo) * 0.05; lo -= m; hi += m;
+}
 
 // ============================================================================
-// 1-D Histograms
+// Cuts — the RowSelection of cfg.cut (CutCache: evaluated once per table
+// and cut term) without the rows where one of the plotted columns is null,
+// nullptr for all rows. Every fill loop below goes through ForEachRow,
+// which visits only the selected rows.
 // ============================================================================
-TH1* CreateTH1(const ColumnData& data, const PlotConfig& cfg)
+static bool ResolveCut(const ColumnData& data, const PlotConfig& cfg, const char* what,
+                       std::shared_ptr<const RowSelection>& sel,
+                       std::initializer_list<int> columns)
 {
-    return CreateTH1D(data, cfg);
+    sel.reset();
+    if (cfg.cut.find_first_not_of(" \t") != std::string::npos) {
+        std::string error;
+        sel = CutCache::Instance().Get(data, cfg.cut, error);
+        if (!sel) {
+            std::cerr << "[PlotCreator] Create" << what << ": bad cut " << error << "\n";
+            return false;
+        }
+    }
+    sel = DropNulls(sel, data, columns);
+    return true;
 }
 
-TH1D* CreateTH1D(const ColumnData& data, const PlotConfig& cfg)
+template <class F>
+static void ForEachRow(const RowSelection* sel, int n, F&& f)
+{
+    if (!sel) {
+        for (int i = 0; i < n; ++i) f(i);
+        return;
+    }
+    sel->ForEach((size_t)n, [&f](size_t i) { f((int)i); });
+}
+
+// The selected values of the first n entries of v
+static std::vector<double> Gather(const ColumnData::Column& v, const RowSelection& sel, int n)
+{
+    std::vector<double> out;
+    out.reserve(std::min(sel.Count(), (size_t)n));
+    sel.ForEach((size_t)n, [&](size_t i) { out.push_back(v[i]); });
+    return out;
+}
+
+// ============================================================================
+// Histogram fill paths — one per dimension, templated on the histogram
+// class, so every storage type is filled directly and its Fill calls are
+// resolved at compile time.
+// ============================================================================
+// The weight column of cfg, or nullptr for unweighted fills; n is cut to
+// its length. A bad index is reported and the fill stays unweighted.
+static const double* WeightColumn(const ColumnData& data, const PlotConfig& cfg, int& n)
+{
+    if (cfg.weightColumn < 0) return nullptr;
+    if (cfg.weightColumn >= (int)data.data.size()) {
+        std::cerr << "[PlotCreator] weight column " << cfg.weightColumn
+                  << " out of range, filling unweighted\n";
+        return nullptr;
+    }
+    const auto& wv = data.data[cfg.weightColumn];
+    n = std::min(n, (int)wv.size());
+    return wv.data();
+}
+
+template <class H>
+static H* BuildTH1(const ColumnData& data, const PlotConfig& cfg, const char* prefix)
 {
     if (cfg.xColumn < 0 || cfg.xColumn >= (int)data.data.size()) {
-        std::cerr << "[PlotCreator] CreateTH1D: xColumn " << cfg.xColumn
+        std::cerr << "[PlotCreator] Create" << H::Class_Name() << ": xColumn " << cfg.xColumn
                   << " out of range (" << data.data.size() << " columns)\n";
         return nullptr;
     }
 
-    std::string name  = UniqueName("h1d");
+    const auto& xv = data.data[cfg.xColumn];
+    int n = (int)xv.size();
+    const double* w = WeightColumn(data, cfg, n);
+    std::shared_ptr<const RowSelection> sel;
+    if (!ResolveCut(data, cfg, H::Class_Name(), sel, { cfg.xColumn, cfg.weightColumn }))
+        return nullptr;
+
+    std::string name  = UniqueName(prefix);
     std::string title = cfg.title.empty()
         ? data.headers[cfg.xColumn]
         : cfg.title;
+    std::string yTitle = w ? "Sum of " + data.headers[cfg.weightColumn] : "Counts";
+
+    // Built once per column; later binnings and ranges come from it
+    auto master = MasterHistCache::Instance().Get(data, cfg.xColumn);
 
     double xmin = cfg.xMin;
     double xmax = cfg.xMax;
-    if (xmin == xmax) {   // auto-range
-        for (double v : data.data[cfg.xColumn]) {
-            if (xmin == xmax) { xmin = xmax = v; }
-            else { xmin = std::min(xmin, v); xmax = std::max(xmax, v); }
-        }
-        double margin = (xmax - xmin) * 0.05;
-        xmin -= margin;  xmax += margin;
-    }
+    if (xmin == xmax)   // auto-range
+        AutoRange(master.get(), xv, cfg.bins, xmin, xmax);
 
-    TH1D* h = new TH1D(name.c_str(),
-                        (title + ";" + data.headers[cfg.xColumn] + ";Counts").c_str(),
-                        cfg.bins, xmin, xmax);
+    H* h = new H(name.c_str(),
+                 (title + ";" + data.headers[cfg.xColumn] + ";" + yTitle).c_str(),
+                 cfg.bins, xmin, xmax);
     h->SetLineColor(cfg.color);
     h->SetLineWidth(2);
 
-    for (double v : data.data[cfg.xColumn])
-        h->Fill(v);
-
+    const double* x = xv.data();
+    if (w) {   // the master holds counts of all rows only
+        h->Sumw2();
+        ForEachRow(sel.get(), n, [&](int i) { h->H::Fill(x[i], w[i]); });
+    } else if (sel) {
+        ForEachRow(sel.get(), n, [&](int i) { h->H::Fill(x[i]); });
+    } else {
+        FillColumn(h, master.get(), xv);
+    }
     return h;
 }
 
-TH1F* CreateTH1F(const ColumnData& data, const PlotConfig& cfg)
+template <class H>
+static H* BuildTH2(const ColumnData& data, const PlotConfig& cfg, const char* prefix)
 {
-    if (cfg.xColumn < 0 || cfg.xColumn >= (int)data.data.size()) return nullptr;
+    int nc = (int)data.data.size();
+    if (cfg.xColumn < 0 || cfg.xColumn >= nc ||
+        cfg.yColumn < 0 || cfg.yColumn >= nc) {
+        std::cerr << "[PlotCreator] Create" << H::Class_Name()
+                  << ": column index out of range\n";
+        return nullptr;
+    }
 
-    std::string name  = UniqueName("h1f");
-    std::string title = cfg.title.empty() ? data.headers[cfg.xColumn] : cfg.title;
+    const auto& xv = data.data[cfg.xColumn];
+    const auto& yv = data.data[cfg.yColumn];
+    int n = (int)std::min(xv.size(), yv.size());
+    const double* w = WeightColumn(data, cfg, n);
+    std::shared_ptr<const RowSelection> sel;
+    if (!ResolveCut(data, cfg, H::Class_Name(), sel,
+                    { cfg.xColumn, cfg.yColumn, cfg.weightColumn })) return nullptr;
 
     double xmin = cfg.xMin, xmax = cfg.xMax;
-    if (xmin == xmax) {
-        for (double v : data.data[cfg.xColumn]) {
-            if (xmin == xmax) { xmin = xmax = v; }
-            else { xmin = std::min(xmin, v); xmax = std::max(xmax, v); }
-        }
-        double m = (xmax - xmin) * 0.05; xmin -= m; xmax += m;
-    }
+    double ymin = cfg.yMin, ymax = cfg.yMax;
+    if (xmin == xmax) ColumnRange(xv, xmin, xmax);
+    if (ymin == ymax) ColumnRange(yv, ymin, ymax);
 
-    TH1F* h = new TH1F(name.c_str(),
-                        (title + ";" + data.headers[cfg.xColumn] + ";Counts").c_str(),
-                        cfg.bins, (float)xmin, (float)xmax);
-    h->SetLineColor(cfg.color);
-    h->SetLineWidth(2);
-    for (double v : data.data[cfg.xColumn]) h->Fill((float)v);
+    std::string name  = UniqueName(prefix);
+    std::string title = cfg.title.empty()
+        ? (data.headers[cfg.yColumn] + " vs " + data.headers[cfg.xColumn])
+        : cfg.title;
+
+    H* h = new H(name.c_str(),
+                 (title + ";" + data.headers[cfg.xColumn] + ";" +
+                  data.headers[cfg.yColumn]).c_str(),
+                 cfg.bins, xmin, xmax,
+                 cfg.binsY, ymin, ymax);
+
+    const double* x = xv.data();
+    const double* y = yv.data();
+    if (w) {
+        h->Sumw2();
+        ForEachRow(sel.get(), n, [&](int i) { h->H::Fill(x[i], y[i], w[i]); });
+    } else {
+        ForEachRow(sel.get(), n, [&](int i) { h->H::Fill(x[i], y[i]); });
+    }
     return h;
 }
 
-TH1I* CreateTH1I(const ColumnData& data, const PlotConfig& cfg)
+template <class H>
+static H* BuildTH3(const ColumnData& data, const PlotConfig& cfg, const char* prefix)
 {
-    if (cfg.xColumn < 0 || cfg.xColumn >= (int)data.data.size()) return nullptr;
+    int nc = (int)data.data.size();
+    if (cfg.xColumn < 0 || cfg.xColumn >= nc ||
+        cfg.yColumn < 0 || cfg.yColumn >= nc ||
+        cfg.zColumn < 0 || cfg.zColumn >= nc) {
+        std::cerr << "[PlotCreator] Create" << H::Class_Name()
+                  << ": column index out of range\n";
+        return nullptr;
+    }
 
-    std::string name  = UniqueName("h1i");
-    std::string title = cfg.title.empty() ? data.headers[cfg.xColumn] : cfg.title;
+    const auto& xv = data.data[cfg.xColumn];
+    const auto& yv = data.data[cfg.yColumn];
+    const auto& zv = data.data[cfg.zColumn];
+    int n = (int)std::min({xv.size(), yv.size(), zv.size()});
+    const double* w = WeightColumn(data, cfg, n);
+    std::shared_ptr<const RowSelection> sel;
+    if (!ResolveCut(data, cfg, H::Class_Name(), sel,
+                    { cfg.xColumn, cfg.yColumn, cfg.zColumn, cfg.weightColumn })) return nullptr;
 
     double xmin = cfg.xMin, xmax = cfg.xMax;
-    if (xmin == xmax) {
-        for (double v : data.data[cfg.xColumn]) {
-            if (xmin == xmax) { xmin = xmax = v; }
-            else { xmin = std::min(xmin, v); xmax = std::max(xmax, v); }
-        }
-        double m = (xmax - xmin) * 0.05; xmin -= m; xmax += m;
-    }
+    double ymin = cfg.yMin, ymax = cfg.yMax;
+    double zmin = cfg.zMin, zmax = cfg.zMax;
+    if (xmin == xmax) ColumnRange(xv, xmin, xmax);
+    if (ymin == ymax) ColumnRange(yv, ymin, ymax);
+    if (zmin == zmax) ColumnRange(zv, zmin, zmax);
 
-    TH1I* h = new TH1I(name.c_str(),
-                        (title + ";" + data.headers[cfg.xColumn] + ";Counts").c_str(),
-                        cfg.bins, (int)xmin, (int)xmax);
-    h->SetLineColor(cfg.color);
-    h->SetLineWidth(2);
-    for (double v : data.data[cfg.xColumn]) h->Fill((int)v);
+    std::string name  = UniqueName(prefix);
+    std::string title = cfg.title.empty()
+        ? (data.headers[cfg.xColumn] + " vs " + data.headers[cfg.yColumn] +
+           " vs " + data.headers[cfg.zColumn])
+        : cfg.title;
+
+    H* h = new H(name.c_str(),
+                 (title + ";" + data.headers[cfg.xColumn] + ";" +
+                  data.headers[cfg.yColumn] + ";" +
+                  data.headers[cfg.zColumn]).c_str(),
+                 cfg.bins,  xmin, xmax,
+                 cfg.binsY, ymin, ymax,
+                 cfg.binsZ, zmin, zmax);
+
+    const double* x = xv.data();
+    const double* y = yv.data();
+    const double* z = zv.data();
+    if (w) {
+        h->Sumw2();
+        ForEachRow(sel.get(), n, [&](int i) { h->H::Fill(x[i], y[i], z[i], w[i]); });
+    } else {
+        ForEachRow(sel.get(), n, [&](int i) { h->H::Fill(x[i], y[i], z[i]); });
+    }
     return h;
 }
 
 // ============================================================================
-// 2-D Histograms
+// Profile fill paths — mean and spread of y per x bin, of z per (x, y)
+// bin. A y (z) range in the config restricts the values accepted.
 // ============================================================================
-TH2* CreateTH2(const ColumnData& data, const PlotConfig& cfg)
-{
-    return CreateTH2D(data, cfg);
-}
-
-TH2D* CreateTH2D(const ColumnData& data, const PlotConfig& cfg)
+static TProfile* BuildProfile(const ColumnData& data, const PlotConfig& cfg, const char* prefix)
 {
     int nc = (int)data.data.size();
     if (cfg.xColumn < 0 || cfg.xColumn >= nc ||
         cfg.yColumn < 0 || cfg.yColumn >= nc) {
-        std::cerr << "[PlotCreator] CreateTH2D: column index out of range\n";
+        std::cerr << "[PlotCreator] CreateTProfile: column index out of range\n";
         return nullptr;
     }
 
     const auto& xv = data.data[cfg.xColumn];
     const auto& yv = data.data[cfg.yColumn];
     int n = (int)std::min(xv.size(), yv.size());
-
-    auto autoRange = [](const std::vector<double>& v, double& lo, double& hi) {
-        lo = hi = v[0];
-        for (double x : v) { lo = std::min(lo, x); hi = std::max(hi, x); }
-        double m = (hi - lo) * 0.05; lo -= m; hi += m;
-    };
+    const double* w = WeightColumn(data, cfg, n);
+    std::shared_ptr<const RowSelection> sel;
+    if (!ResolveCut(data, cfg, "TProfile", sel,
+                    { cfg.xColumn, cfg.yColumn, cfg.weightColumn })) return nullptr;
 
     double xmin = cfg.xMin, xmax = cfg.xMax;
-    double ymin = cfg.yMin, ymax = cfg.yMax;
-    if (xmin == xmax) autoRange(xv, xmin, xmax);
-    if (ymin == ymax) autoRange(yv, ymin, ymax);
+    if (xmin == xmax) ColumnRange(xv, xmin, xmax);
 
-    std::string name  = UniqueName("h2d");
+    std::string name  = UniqueName(prefix);
     std::string title = cfg.title.empty()
-        ? (data.headers[cfg.yColumn] + " vs " + data.headers[cfg.xColumn])
+        ? ("mean " + data.headers[cfg.yColumn] + " vs " + data.headers[cfg.xColumn])
         : cfg.title;
+    std::string titles = title + ";" + data.headers[cfg.xColumn] + ";" +
+                         data.headers[cfg.yColumn];
 
-    TH2D* h = new TH2D(name.c_str(),
-                        (title + ";" + data.headers[cfg.xColumn] + ";" +
-                         data.headers[cfg.yColumn]).c_str(),
-                        cfg.bins, xmin, xmax,
-                        cfg.binsY, ymin, ymax);
-
-    for (int i = 0; i < n; ++i) h->Fill(xv[i], yv[i]);
-    return h;
-}
+    TProfile* h = cfg.yMin != cfg.yMax
+        ? new TProfile(name.c_str(), titles.c_str(), cfg.bins, xmin, xmax, cfg.yMin, cfg.yMax)
+        : new TProfile(name.c_str(), titles.c_str(), cfg.bins, xmin, xmax);
+    h->SetLineColor(cfg.color);
+    h->SetMarkerColor(cfg.color);
+    h->SetLineWidth(2);
 
-TH2F* CreateTH2F(const ColumnData& data, const PlotConfig& cfg)
-{
-    // Delegate through TH2D logic for simplicity
-    TH2D* tmp = CreateTH2D(data, cfg);
-    if (!tmp) return nullptr;
-    std::string name = UniqueName("h2f");
-    TH2F* h = new TH2F(name.c_str(), tmp->GetTitle(),
-                        tmp->GetNbinsX(), tmp->GetXaxis()->GetXmin(), tmp->GetXaxis()->GetXmax(),
-                        tmp->GetNbinsY(), tmp->GetYaxis()->GetXmin(), tmp->GetYaxis()->GetXmax());
-    // Copy bin contents
-    for (int ix = 1; ix <= tmp->GetNbinsX(); ++ix)
-        for (int iy = 1; iy <= tmp->GetNbinsY(); ++iy)
-            h->SetBinContent(ix, iy, (float)tmp->GetBinContent(ix, iy));
-    delete tmp;
+    const double* x = xv.data();
+    const double* y = yv.data();
+    if (w) {
+        ForEachRow(sel.get(), n, [&](int i) { h->TProfile::Fill(x[i], y[i], w[i]); });
+    } else {
+        ForEachRow(sel.get(), n, [&](int i) { h->TProfile::Fill(x[i], y[i]); });
+    }
     return h;
 }
 
-// ============================================================================
-// 3-D Histograms
-// ============================================================================
-TH3* CreateTH3(const ColumnData& data, const PlotConfig& cfg)
-{
-    return CreateTH3D(data, cfg);
-}
-
-TH3D* CreateTH3D(const ColumnData& data, const PlotConfig& cfg)
+static TProfile2D* BuildProfile2D(const ColumnData& data, const PlotConfig& cfg, const char* prefix)
 {
     int nc = (int)data.data.size();
     if (cfg.xColumn < 0 || cfg.xColumn >= nc ||
         cfg.yColumn < 0 || cfg.yColumn >= nc ||
         cfg.zColumn < 0 || cfg.zColumn >= nc) {
-        std::cerr << "[PlotCreator] CreateTH3D: column index out of range\n";
+        std::cerr << "[PlotCreator] CreateTProfile2D: column index out of range\n";
         return nullptr;
     }
 
@@ -205,55 +356,248 @@ TH3D* CreateTH3D(const ColumnData& data, const PlotConfig& cfg)
     const auto& yv = data.data[cfg.yColumn];
     const auto& zv = data.data[cfg.zColumn];
     int n = (int)std::min({xv.size(), yv.size(), zv.size()});
-
-    auto autoRange = [](const std::vector<double>& v, double& lo, double& hi) {
-        lo = hi = v[0];
-        for (double x : v) { lo = std::min(lo, x); hi = std::max(hi, x); }
-        double m = (hi - lo) * 0.05; lo -= m; hi += m;
-    };
+    const double* w = WeightColumn(data, cfg, n);
+    std::shared_ptr<const RowSelection> sel;
+    if (!ResolveCut(data, cfg, "TProfile2D", sel,
+                    { cfg.xColumn, cfg.yColumn, cfg.zColumn, cfg.weightColumn })) return nullptr;
 
     double xmin = cfg.xMin, xmax = cfg.xMax;
     double ymin = cfg.yMin, ymax = cfg.yMax;
-    double zmin = cfg.zMin, zmax = cfg.zMax;
-    if (xmin == xmax) autoRange(xv, xmin, xmax);
-    if (ymin == ymax) autoRange(yv, ymin, ymax);
-    if (zmin == zmax) autoRange(zv, zmin, zmax);
+    if (xmin == xmax) ColumnRange(xv, xmin, xmax);
+    if (ymin == ymax) ColumnRange(yv, ymin, ymax);
 
-    std::string name  = UniqueName("h3d");
+    std::string name  = UniqueName(prefix);
     std::string title = cfg.title.empty()
-        ? (data.headers[cfg.xColumn] + " vs " + data.headers[cfg.yColumn] +
-           " vs " + data.headers[cfg.zColumn])
+        ? ("mean " + data.headers[cfg.zColumn] + " vs " + data.headers[cfg.xColumn] +
+           ", " + data.headers[cfg.yColumn])
         : cfg.title;
+    std::string titles = title + ";" + data.headers[cfg.xColumn] + ";" +
+                         data.headers[cfg.yColumn] + ";" + data.headers[cfg.zColumn];
+
+    TProfile2D* h = cfg.zMin != cfg.zMax
+        ? new TProfile2D(name.c_str(), titles.c_str(), cfg.bins, xmin, xmax,
+                         cfg.binsY, ymin, ymax, cfg.zMin, cfg.zMax)
+        : new TProfile2D(name.c_str(), titles.c_str(), cfg.bins, xmin, xmax,
+                         cfg.binsY, ymin, ymax);
+
+    const double* x = xv.data();
+    const double* y = yv.data();
+    const double* z = zv.data();
+    if (w) {
+        ForEachRow(sel.get(), n, [&](int i) { h->TProfile2D::Fill(x[i], y[i], z[i], w[i]); });
+    } else {
+        ForEachRow(sel.get(), n, [&](int i) { h->TProfile2D::Fill(x[i], y[i], z[i]); });
+    }
+    return h;
+}
+
+// ============================================================================
+// PlotTraits — one specialization per PlotType: the ROOT class it builds,
+// how it is named, drawn and put in a legend, and Build(). The dispatch
+// table below is generated from them, so a new plot type is a PlotType
+// entry plus a specialization here (and its Build()).
+// ============================================================================
+template <PlotConfig::PlotType T> struct PlotTraits;   // no default: every type is spelled out
+
+template <class H, int Dim>
+struct HistTraits {
+    using Object = H;
+    static constexpr PlotTypeInfo::Family kFamily =
+        Dim == 1 ? PlotTypeInfo::kHist1D : Dim == 2 ? PlotTypeInfo::kHist2D : PlotTypeInfo::kHist3D;
+    static constexpr int         kDimension    = Dim;
+    static constexpr const char* kDrawOption   = Dim == 1 ? "" : Dim == 2 ? "COLZ" : "ISO";
+    static constexpr const char* kSameOption   = Dim == 1 ? "SAME" : Dim == 2 ? "COLZ SAME" : nullptr;
+    static constexpr const char* kLegendOption = Dim == 1 ? "l" : nullptr;
+
+    static H* Build(const ColumnData& data, const PlotConfig& cfg, const char* prefix) {
+        if constexpr (Dim == 1)      return BuildTH1<H>(data, cfg, prefix);
+        else if constexpr (Dim == 2) return BuildTH2<H>(data, cfg, prefix);
+        else                         return BuildTH3<H>(data, cfg, prefix);
+    }
+};
+
+#define HIST_TRAITS(TYPE, CLASS, DIM, PREFIX)                                    \
+    template <> struct PlotTraits<PlotConfig::TYPE> : HistTraits<CLASS, DIM> {   \
+        static constexpr const char* kName = #CLASS;                             \
+        static CLASS* Build(const ColumnData& data, const PlotConfig& cfg) {     \
+            return HistTraits<CLASS, DIM>::Build(data, cfg, PREFIX);             \
+        }                                                                        \
+    };
 
-    TH3D* h = new TH3D(name.c_str(),
-                        (title + ";" + data.headers[cfg.xColumn] + ";" +
-                         data.headers[cfg.yColumn] + ";" +
-                         data.headers[cfg.zColumn]).c_str(),
-                        cfg.bins,  xmin, xmax,
-                        cfg.binsY, ymin, ymax,
-                        cfg.binsZ, zmin, zmax);
+HIST_TRAITS(kTH1D, TH1D, 1, "h1d")
+HIST_TRAITS(kTH1F, TH1F, 1, "h1f")
+HIST_TRAITS(kTH1I, TH1I, 1, "h1i")
+HIST_TRAITS(kTH2D, TH2D, 2, "h2d")
+HIST_TRAITS(kTH2F, TH2F, 2, "h2f")
+HIST_TRAITS(kTH2I, TH2I, 2, "h2i")
+HIST_TRAITS(kTH3D, TH3D, 3, "h3d")
+HIST_TRAITS(kTH3F, TH3F, 3, "h3f")
+HIST_TRAITS(kTH3I, TH3I, 3, "h3i")
+
+#undef HIST_TRAITS
+
+template <> struct PlotTraits<PlotConfig::kTProfile> {
+    using Object = TProfile;
+    static constexpr const char*          kName         = "TProfile";
+    static constexpr PlotTypeInfo::Family kFamily       = PlotTypeInfo::kProfile1D;
+    static constexpr int                  kDimension    = 2;
+    static constexpr const char*          kDrawOption   = "";
+    static constexpr const char*          kSameOption   = "SAME";
+    static constexpr const char*          kLegendOption = "lp";
+    static TProfile* Build(const ColumnData& data, const PlotConfig& cfg) {
+        return BuildProfile(data, cfg, "prof");
+    }
+};
+
+template <> struct PlotTraits<PlotConfig::kTProfile2D> {
+    using Object = TProfile2D;
+    static constexpr const char*          kName         = "TProfile2D";
+    static constexpr PlotTypeInfo::Family kFamily       = PlotTypeInfo::kProfile2D;
+    static constexpr int                  kDimension    = 3;
+    static constexpr const char*          kDrawOption   = "COLZ";
+    static constexpr const char*          kSameOption   = "COLZ SAME";
+    static constexpr const char*          kLegendOption = nullptr;
+    static TProfile2D* Build(const ColumnData& data, const PlotConfig& cfg) {
+        return BuildProfile2D(data, cfg, "prof2d");
+    }
+};
+
+template <> struct PlotTraits<PlotConfig::kTGraph> {
+    using Object = TGraph;
+    static constexpr const char*          kName         = "TGraph";
+    static constexpr PlotTypeInfo::Family kFamily       = PlotTypeInfo::kGraph;
+    static constexpr int                  kDimension    = 2;
+    static constexpr const char*          kDrawOption   = "APL";
+    static constexpr const char*          kSameOption   = "PL SAME";
+    static constexpr const char*          kLegendOption = "lp";
+    static TGraph* Build(const ColumnData& data, const PlotConfig& cfg) {
+        return PlotCreator::CreateTGraph(data, cfg);
+    }
+};
+
+template <> struct PlotTraits<PlotConfig::kTGraphErrors> {
+    using Object = TGraphErrors;
+    static constexpr const char*          kName         = "TGraphErrors";
+    static constexpr PlotTypeInfo::Family kFamily       = PlotTypeInfo::kGraphErrors;
+    static constexpr int                  kDimension    = 2;
+    static constexpr const char*          kDrawOption   = "APE";
+    static constexpr const char*          kSameOption   = "PE SAME";
+    static constexpr const char*          kLegendOption = "lpe";
+    static TGraphErrors* Build(const ColumnData& data, const PlotConfig& cfg) {
+        return PlotCreator::CreateTGraphErrors(data, cfg);
+    }
+};
 
-    for (int i = 0; i < n; ++i) h->Fill(xv[i], yv[i], zv[i]);
-    return h;
+// ============================================================================
+// Dispatch table — kPlotTypes[type], built at compile time
+// ============================================================================
+template <PlotConfig::PlotType T>
+static TObject* CreateAs(const ColumnData& data, const PlotConfig& cfg)
+{
+    return PlotTraits<T>::Build(data, cfg);
 }
 
-TH3F* CreateTH3F(const ColumnData& data, const PlotConfig& cfg)
+template <PlotConfig::PlotType T>
+static constexpr PlotTypeInfo MakeTypeInfo()
 {
-    TH3D* tmp = CreateTH3D(data, cfg);
-    if (!tmp) return nullptr;
-    std::string name = UniqueName("h3f");
-    TH3F* h = new TH3F(name.c_str(), tmp->GetTitle(),
-                        tmp->GetNbinsX(), tmp->GetXaxis()->GetXmin(), tmp->GetXaxis()->GetXmax(),
-                        tmp->GetNbinsY(), tmp->GetYaxis()->GetXmin(), tmp->GetYaxis()->GetXmax(),
-                        tmp->GetNbinsZ(), tmp->GetZaxis()->GetXmin(), tmp->GetZaxis()->GetXmax());
-    for (int ix = 1; ix <= tmp->GetNbinsX(); ++ix)
-        for (int iy = 1; iy <= tmp->GetNbinsY(); ++iy)
-            for (int iz = 1; iz <= tmp->GetNbinsZ(); ++iz)
-                h->SetBinContent(ix, iy, iz, (float)tmp->GetBinContent(ix, iy, iz));
-    delete tmp;
-    return h;
+    using Traits = PlotTraits<T>;
+    return { Traits::kName, Traits::kFamily, Traits::kDimension,
+             Traits::kDrawOption, Traits::kSameOption, Traits::kLegendOption,
+             &CreateAs<T> };
+}
+
+template <int... I>
+static constexpr std::array<PlotTypeInfo, sizeof...(I)> MakeTypeTable(std::integer_sequence<int, I...>)
+{
+    return {{ MakeTypeInfo<static_cast<PlotConfig::PlotType>(I)>()... }};
+}
+
+static constexpr auto kPlotTypes =
+    MakeTypeTable(std::make_integer_sequence<int, PlotConfig::kNumPlotTypes>());
+
+std::string PlotConfig::GetDescription() const
+{
+    const PlotTypeInfo& info = PlotCreator::GetTypeInfo(type);
+    std::string desc = info.name;
+    desc += " col[" + std::to_string(xColumn) + "]";
+    if (info.dimension >= 2)
+        desc += " vs col[" + std::to_string(yColumn) + "]";
+    if (weightColumn >= 0 && info.family >= PlotTypeInfo::kHist1D)
+        desc += " w=col[" + std::to_string(weightColumn) + "]";
+    if (!cut.empty())
+        desc += " {" + cut + "}";
+    return desc;
 }
 
+namespace PlotCreator {
+
+// ============================================================================
+// Dispatch
+// ============================================================================
+const PlotTypeInfo& GetTypeInfo(PlotConfig::PlotType type)
+{
+    return kPlotTypes[type];
+}
+
+bool FindType(const std::string& name, PlotConfig::PlotType& type)
+{
+    auto lower = [](std::string s) {
+        for (char& c : s) c = (char)std::tolower((unsigned char)c);
+        return s;
+    };
+    for (size_t i = 0; i < kPlotTypes.size(); ++i) {
+        if (lower(kPlotTypes[i].name) == lower(name)) {
+            type = static_cast<PlotConfig::PlotType>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+TObject* Create(const ColumnData& data, const PlotConfig& cfg)
+{
+    if (cfg.type < 0 || cfg.type >= PlotConfig::kNumPlotTypes) return nullptr;
+    return kPlotTypes[cfg.type].create(data, cfg);
+}
+
+// ============================================================================
+// Histograms by dimension — the storage type of cfg.type when it has that
+// dimension, D otherwise
+// ============================================================================
+TH1* CreateTH1(const ColumnData& data, const PlotConfig& cfg)
+{
+    if (GetTypeInfo(cfg.type).family == PlotTypeInfo::kHist1D)
+        return static_cast<TH1*>(Create(data, cfg));
+    return CreateTH1D(data, cfg);
+}
+
+TH2* CreateTH2(const ColumnData& data, const PlotConfig& cfg)
+{
+    if (GetTypeInfo(cfg.type).family == PlotTypeInfo::kHist2D)
+        return static_cast<TH2*>(Create(data, cfg));
+    return CreateTH2D(data, cfg);
+}
+
+TH3* CreateTH3(const ColumnData& data, const PlotConfig& cfg)
+{
+    if (GetTypeInfo(cfg.type).family == PlotTypeInfo::kHist3D)
+        return static_cast<TH3*>(Create(data, cfg));
+    return CreateTH3D(data, cfg);
+}
+
+TH1D* CreateTH1D(const ColumnData& data, const PlotConfig& cfg) { return PlotTraits<PlotConfig::kTH1D>::Build(data, cfg); }
+TH1F* CreateTH1F(const ColumnData& data, const PlotConfig& cfg) { return PlotTraits<PlotConfig::kTH1F>::Build(data, cfg); }
+TH1I* CreateTH1I(const ColumnData& data, const PlotConfig& cfg) { return PlotTraits<PlotConfig::kTH1I>::Build(data, cfg); }
+TH2D* CreateTH2D(const ColumnData& data, const PlotConfig& cfg) { return PlotTraits<PlotConfig::kTH2D>::Build(data, cfg); }
+TH2F* CreateTH2F(const ColumnData& data, const PlotConfig& cfg) { return PlotTraits<PlotConfig::kTH2F>::Build(data, cfg); }
+TH2I* CreateTH2I(const ColumnData& data, const PlotConfig& cfg) { return PlotTraits<PlotConfig::kTH2I>::Build(data, cfg); }
+TH3D* CreateTH3D(const ColumnData& data, const PlotConfig& cfg) { return PlotTraits<PlotConfig::kTH3D>::Build(data, cfg); }
+TH3F* CreateTH3F(const ColumnData& data, const PlotConfig& cfg) { return PlotTraits<PlotConfig::kTH3F>::Build(data, cfg); }
+TH3I* CreateTH3I(const ColumnData& data, const PlotConfig& cfg) { return PlotTraits<PlotConfig::kTH3I>::Build(data, cfg); }
+
+TProfile*   CreateTProfile  (const ColumnData& data, const PlotConfig& cfg) { return PlotTraits<PlotConfig::kTProfile>::Build(data, cfg); }
+TProfile2D* CreateTProfile2D(const ColumnData& data, const PlotConfig& cfg) { return PlotTraits<PlotConfig::kTProfile2D>::Build(data, cfg); }
+
 // ============================================================================
 // Graphs
 // ============================================================================
@@ -269,8 +613,22 @@ TGraph* CreateTGraph(const ColumnData& data, const PlotConfig& cfg)
     const auto& xv = data.data[cfg.xColumn];
     const auto& yv = data.data[cfg.yColumn];
     int n = (int)std::min(xv.size(), yv.size());
-
-    TGraph* g = new TGraph(n, xv.data(), yv.data());
+    std::shared_ptr<const RowSelection> sel;
+    if (!ResolveCut(data, cfg, "TGraph", sel, { cfg.xColumn, cfg.yColumn })) return nullptr;
+
+    // Paints a per-pixel decimated series; fits still see every point.
+    // A table held by a shared_ptr is borrowed, not copied; the points of
+    // a cut are copied out.
+    std::shared_ptr<const ColumnData> owner = data.weak_from_this().lock();
+    TGraph* g = nullptr;
+    if (sel) {
+        std::vector<double> x = Gather(xv, *sel, n), y = Gather(yv, *sel, n);
+        g = new LODGraph((Int_t)x.size(), x.data(), y.data());
+    } else if (owner) {
+        g = new LODGraph(owner, cfg.xColumn, cfg.yColumn, n);
+    } else {
+        g = new LODGraph(n, xv.data(), yv.data());
+    }
 
     std::string title = cfg.title.empty()
         ? (data.headers[cfg.yColumn] + " vs " + data.headers[cfg.xColumn])
@@ -298,16 +656,39 @@ TGraphErrors* CreateTGraphErrors(const ColumnData& data, const PlotConfig& cfg)
     const auto& yv = data.data[cfg.yColumn];
     int n = (int)std::min(xv.size(), yv.size());
 
-    // Error columns — fall back to zeros if not specified
-    std::vector<double> exv(n, 0.0), eyv(n, 0.0);
-    if (cfg.xErrColumn >= 0 && cfg.xErrColumn < nc)
-        for (int i = 0; i < n; ++i) exv[i] = data.data[cfg.xErrColumn][i];
-    if (cfg.yErrColumn >= 0 && cfg.yErrColumn < nc)
-        for (int i = 0; i < n; ++i) eyv[i] = data.data[cfg.yErrColumn][i];
+    int exc = (cfg.xErrColumn >= 0 && cfg.xErrColumn < nc) ? cfg.xErrColumn : -1;
+    int eyc = (cfg.yErrColumn >= 0 && cfg.yErrColumn < nc) ? cfg.yErrColumn : -1;
+    std::shared_ptr<const RowSelection> sel;
+    if (!ResolveCut(data, cfg, "TGraphErrors", sel, { cfg.xColumn, cfg.yColumn, exc, eyc }))
+        return nullptr;
 
-    TGraphErrors* g = new TGraphErrors(n,
-                                       xv.data(), yv.data(),
-                                       exv.data(), eyv.data());
+    // A table held by a shared_ptr is borrowed, not copied; a missing
+    // error column costs no array
+    std::shared_ptr<const ColumnData> owner = data.weak_from_this().lock();
+    auto covers = [&](int c) { return c < 0 || (int)data.data[c].size() >= n; };
+    TGraphErrors* g = nullptr;
+    if (sel) {   // the points of a cut are copied out
+        auto error = [&](int c) {   // 0 where there is no error value
+            std::vector<double> e;
+            sel->ForEach((size_t)n, [&](size_t i) {
+                e.push_back(c >= 0 && i < data.data[c].size() ? data.data[c][i] : 0.0);
+            });
+            return e;
+        };
+        std::vector<double> x  = Gather(xv, *sel, n), y  = Gather(yv, *sel, n);
+        std::vector<double> ex = error(exc),          ey = error(eyc);
+        g = new TGraphErrors((Int_t)x.size(), x.data(), y.data(), ex.data(), ey.data());
+    } else if (owner && covers(exc) && covers(eyc)) {
+        g = new ColumnGraphErrors(owner, cfg.xColumn, cfg.yColumn, exc, eyc, n);
+    } else {
+        // Error columns — fall back to zeros if not specified
+        std::vector<double> exv(n, 0.0), eyv(n, 0.0);
+        if (exc >= 0)
+            for (int i = 0; i < n && i < (int)data.data[exc].size(); ++i) exv[i] = data.data[exc][i];
+        if (eyc >= 0)
+            for (int i = 0; i < n && i < (int)data.data[eyc].size(); ++i) eyv[i] = data.data[eyc][i];
+        g = new TGraphErrors(n, xv.data(), yv.data(), exv.data(), eyv.data());
+    }
 
     std::string title = cfg.title.empty()
         ? (data.headers[cfg.yColumn] + " vs " + data.headers[cfg.xColumn])
@@ -0,0 +1,201 @@
+#include "RNTupleData.h"
+#include "DataReader.h"
+#include "RNTupleCompat.h"
+#include "ThreadPool.h"
+
+#include <TROOT.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <future>
+#include <type_traits>
+#include <utility>
+
+namespace {
+
+#ifndef APG_HAVE_RNTUPLE
+const char* kNoSupport = "this build has no RNTuple support (needs ROOT 6.28+ with ROOTNTuple)";
+#else
+using Reader = RNTupleAPI::RNTupleReader;
+
+// GetDescriptor() returned a pointer before 6.32
+template <class R>
+const auto& Descriptor(R& reader)
+{
+    if constexpr (std::is_pointer<decltype(reader.GetDescriptor())>::value)
+        return *reader.GetDescriptor();
+    else
+        return reader.GetDescriptor();
+}
+
+// Entries between two progress updates / cancel checks
+const Long64_t kStride = 1 << 16;
+
+struct FieldValues {
+    ColumnData::Column  values;
+    std::string         error;
+};
+
+template <class T>
+FieldValues ReadField(const std::string& path, const std::string& ntuple,
+                      const std::string& field, Long64_t entries, ReadProgress* progress)
+{
+    FieldValues result;
+    try {
+        auto reader = Reader::Open(ntuple, path);
+        auto view   = reader->GetView<T>(field);
+        result.values.reserve(entries);
+        for (Long64_t i = 0; i < entries; ++i) {
+            if (progress && i > 0 && i % kStride == 0) {
+                progress->processed += kStride;
+                if (progress->Cancelled()) break;
+            }
+            result.values.push_back((double)view((std::uint64_t)i));
+        }
+    } catch (const std::exception& e) {
+        result.error = "field " + field + ": " + e.what();
+    }
+    return result;
+}
+
+using FieldReader = FieldValues (*)(const std::string&, const std::string&,
+                                    const std::string&, Long64_t, ReadProgress*);
+
+// Scalar types that become columns, by their stored type name
+FieldReader ReaderFor(const std::string& type)
+{
+    static const std::pair<const char*, FieldReader> kTypes[] = {
+        { "double",        &ReadField<double>        },
+        { "float",         &ReadField<float>         },
+        { "std::int32_t",  &ReadField<std::int32_t>  },
+        { "std::int64_t",  &ReadField<std::int64_t>  },
+        { "std::uint32_t", &ReadField<std::uint32_t> },
+        { "std::uint64_t", &ReadField<std::uint64_t> },
+        { "std::int16_t",  &ReadField<std::int16_t>  },
+        { "std::uint16_t", &ReadField<std::uint16_t> },
+        { "std::int8_t",   &ReadField<std::int8_t>   },
+        { "std::uint8_t",  &ReadField<std::uint8_t>  },
+        { "char",          &ReadField<char>          },
+        { "bool",          &ReadField<bool>          }
+    };
+    for (const auto& t : kTypes)
+        if (type == t.first) return t.second;
+    return nullptr;
+}
+#endif
+
+} // namespace
+
+// ============================================================================
+// Detection
+// ============================================================================
+bool RNTupleData::Available()
+{
+#ifdef APG_HAVE_RNTUPLE
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool RNTupleData::IsRNTupleClass(const std::string& className)
+{
+    return className == "ROOT::RNTuple" || className == "ROOT::Experimental::RNTuple";
+}
+
+// ============================================================================
+// Describe
+// ============================================================================
+bool RNTupleData::Describe(const std::string& path, const std::string& ntuple,
+                           std::vector<FieldInfo>& fields, Long64_t& entries,
+                           std::string& error)
+{
+#ifdef APG_HAVE_RNTUPLE
+    try {
+        auto reader = Reader::Open(ntuple, path);
+        entries = (Long64_t)reader->GetNEntries();
+        fields.clear();
+        for (const auto& f : Descriptor(*reader).GetTopLevelFields()) {
+            std::string type = f.GetTypeName();
+            fields.push_back({ f.GetFieldName(), type, ReaderFor(type) != nullptr });
+        }
+        return true;
+    } catch (const std::exception& e) {
+        error = "Cannot open RNTuple " + ntuple + " in " + path + ": " + e.what();
+        return false;
+    }
+#else
+    (void)path; (void)fields; (void)entries;
+    error = "RNTuple " + ntuple + ": " + kNoSupport;
+    return false;
+#endif
+}
+
+// ============================================================================
+// Read
+// ============================================================================
+bool RNTupleData::Read(const std::string& path, const std::string& ntuple,
+                       ColumnData& data, ReadProgress* progress, std::string& error)
+{
+#ifdef APG_HAVE_RNTUPLE
+    std::vector<FieldInfo> fields;
+    Long64_t entries = 0;
+    if (!Describe(path, ntuple, fields, entries, error)) return false;
+
+    std::vector<const FieldInfo*> numeric;
+    for (const auto& f : fields) {
+        if (f.numeric) numeric.push_back(&f);
+        else std::cout << "  skipping field " << f.name << " [" << f.type << "]" << std::endl;
+    }
+    if (numeric.empty()) {
+        error = "RNTuple " + ntuple + " has no numeric scalar fields";
+        return false;
+    }
+    if (progress) progress->total = entries * (Long64_t)numeric.size();
+
+    // Columnar: each field on its own reader and thread
+    ROOT::EnableThreadSafety();
+    std::vector<std::future<FieldValues>> futures;
+    {
+        ThreadPool pool(std::min<unsigned>(ThreadPool::DefaultSize(), numeric.size()));
+        for (const FieldInfo* f : numeric) {
+            FieldReader read = ReaderFor(f->type);
+            std::string name = f->name;
+            futures.push_back(pool.Submit([read, path, ntuple, name, entries, progress]() {
+                return read(path, ntuple, name, entries, progress);
+            }));
+        }
+    }
+
+    std::vector<FieldValues> columns;
+    size_t rows = (size_t)entries;
+    for (auto& f : futures) {
+        columns.push_back(f.get());
+        if (!columns.back().error.empty()) {
+            error = "RNTuple " + ntuple + ": " + columns.back().error;
+            return false;
+        }
+        rows = std::min(rows, columns.back().values.size());   // shorter after a cancel
+    }
+
+    data.filename = path;
+    for (size_t i = 0; i < numeric.size(); ++i) {
+        columns[i].values.resize(rows);
+        data.headers.push_back(numeric[i]->name);
+        data.data.push_back(std::move(columns[i].values));
+        data.NullsFromNaN((int)data.data.size() - 1);
+    }
+    if (progress) {
+        progress->processed = progress->total.load();
+        progress->rows = (Long64_t)rows;
+    }
+
+    std::cout << "Extracted RNTuple: " << ntuple << " (" << numeric.size() << " of "
+              << fields.size() << " fields, " << rows << " entries)" << std::endl;
+    return true;
+#else
+    (void)path; (void)data; (void)progress;
+    error = "RNTuple " + ntuple + ": " + kNoSupport;
+    return false;
+#endif
+}
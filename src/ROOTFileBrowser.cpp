@@ -1,4 +1,5 @@
 #include "ROOTFileBrowser.h"
+#include "RNTupleData.h"
 
 #include <TGLayout.h>
 #include <TGSplitter.h>
@@ -212,7 +213,7 @@ void ROOTFileBrowser::ScanFile()
     // Create root categories
     TGListTreeItem* histItem = fObjectTree->AddItem(nullptr, "Histograms");
     TGListTreeItem* graphItem = fObjectTree->AddItem(nullptr, "Graphs");
-    TGListTreeItem* treeItem = fObjectTree->AddItem(nullptr, "TTrees");
+    TGListTreeItem* treeItem = fObjectTree->AddItem(nullptr, "TTrees / RNTuples");
     TGListTreeItem* otherItem = fObjectTree->AddItem(nullptr, "Other Objects");
     
     histItem->SetCheckBox(kTRUE);
@@ -228,6 +229,30 @@ void ROOTFileBrowser::ScanFile()
         const char* className = key->GetClassName();
         const char* objName = key->GetName();
         const char* objTitle = key->GetTitle();
+
+        // RNTuples are not TObjects: describe them from their metadata
+        if (GetObjectCategory(className) == "RNTuple") {
+            ROOTObjectInfo info;
+            info.name     = objName;
+            info.type     = "RNTuple";
+            info.category = "RNTuple";
+
+            std::vector<RNTupleData::FieldInfo> fields;
+            Long64_t entries = 0;
+            std::string error;
+            if (RNTupleData::Describe(fFilename, objName, fields, entries, error))
+                info.title = Form("%lld entries, %zu fields", entries, fields.size());
+            else
+                info.title = error;
+
+            TGListTreeItem* item = AddObjectToTree(info, treeItem);
+            for (const auto& f : fields) {
+                fObjectTree->AddItem(item, Form("%s : %s%s", f.name.c_str(), f.type.c_str(),
+                                                f.numeric ? "" : " (not loaded)"));
+            }
+            fObjects.push_back(info);
+            continue;
+        }
         
         TObject* obj = key->ReadObj();
         if (!obj) continue;
@@ -266,23 +291,24 @@ void ROOTFileBrowser::ScanFile()
     fObjectTree->OpenItem(treeItem);
     
     // Print summary
-    int nHist = 0, nGraph = 0, nTree = 0;
+    int nHist = 0, nGraph = 0, nTree = 0, nNTuple = 0;
     for (const auto& obj : fObjects) {
         if (obj.category == "Histogram") nHist++;
         else if (obj.category == "Graph") nGraph++;
         else if (obj.category == "Tree") nTree++;
+        else if (obj.category == "RNTuple") nNTuple++;
     }
     
     std::cout << "\n=== ROOT File Contents ===" << std::endl;
     std::cout << "Histograms: " << nHist << " | Graphs: " << nGraph 
-              << " | TTrees: " << nTree << std::endl;
+              << " | TTrees: " << nTree << " | RNTuples: " << nNTuple << std::endl;
     std::cout << "=========================\n" << std::endl;
 }
 
 // ============================================================================
 // Helper methods (same as before)
 // ============================================================================
-void ROOTFileBrowser::AddObjectToTree(const ROOTObjectInfo& obj, TGListTreeItem* parent)
+TGListTreeItem* ROOTFileBrowser::AddObjectToTree(const ROOTObjectInfo& obj, TGListTreeItem* parent)
 {
     std::string label = Form("%s : %s", obj.name.c_str(), obj.type.c_str());
     if (!obj.title.empty() && obj.title != obj.name) {
@@ -292,6 +318,7 @@ void ROOTFileBrowser::AddObjectToTree(const ROOTObjectInfo& obj, TGListTreeItem*
     TGListTreeItem* item = fObjectTree->AddItem(parent, label.c_str());
     item->SetCheckBox(kTRUE);
     item->SetUserData((void*)&obj);
+    return item;
 }
 
 std::string ROOTFileBrowser::GetObjectCategory(const char* className)
@@ -301,6 +328,7 @@ std::string ROOTFileBrowser::GetObjectCategory(const char* className)
         cn.find("TProfile") == 0) return "Histogram";
     if (cn.find("TGraph") == 0) return "Graph";
     if (cn == "TTree" || cn == "TNtuple" || cn == "TChain") return "Tree";
+    if (RNTupleData::IsRNTupleClass(cn)) return "RNTuple";
     return "Other";
 }
 
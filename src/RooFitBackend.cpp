@@ -0,0 +1,230 @@
+#include "RooFitBackend.h"
+#include "FitCache.h"
+#include "ThreadPool.h"
+
+#include <TString.h>
+#include <RVersion.h>
+
+#include <RooAbsPdf.h>
+#include <RooCmdArg.h>
+#include <RooDataHist.h>
+#include <RooFit.h>
+#include <RooFitResult.h>
+#include <RooGlobalFunc.h>
+#include <RooPlot.h>
+#include <RooRealVar.h>
+#include <RooWorkspace.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+// Below this many bins NumCPU's worker processes cost more than they save
+const int kMinParallelBins = 10000;
+
+// Likelihood evaluation backend for fitTo: the vectorized CPU backend
+// (EvalBackend from 6.30, BatchMode before), NumCPU on older ROOT
+RooCmdArg EvalArg(int nbins)
+{
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 30, 0)
+    (void)nbins;
+    return RooFit::EvalBackend("cpu");
+#elif ROOT_VERSION_CODE >= ROOT_VERSION(6, 26, 0)
+    (void)nbins;
+    return RooFit::BatchMode("cpu");
+#else
+    if (nbins >= kMinParallelBins) return RooFit::NumCPU(ThreadPool::DefaultSize());
+    return RooCmdArg::none();
+#endif
+}
+
+} // namespace
+
+// ============================================================================
+// Instance / workspaces
+// ============================================================================
+RooFitBackend& RooFitBackend::Instance()
+{
+    static RooFitBackend backend;
+    return backend;
+}
+
+RooFitBackend::Workspace& RooFitBackend::GetLocked(const TH1* hist)
+{
+    const TAxis* axis = hist->GetXaxis();
+    Shape shape(hist->GetNbinsX(), axis->GetXmin(), axis->GetXmax());
+
+    auto it = fWorkspaces.find(shape);
+    if (it == fWorkspaces.end()) {
+        if (fWorkspaces.size() >= kMaxWorkspaces) {
+            auto oldest = std::min_element(fWorkspaces.begin(), fWorkspaces.end(),
+                [](const std::pair<const Shape, Workspace>& a,
+                   const std::pair<const Shape, Workspace>& b) {
+                    return a.second.lastUse < b.second.lastUse;
+                });
+            fWorkspaces.erase(oldest);
+        }
+
+        double xmin  = axis->GetXmin();
+        double xmax  = axis->GetXmax();
+        double width = xmax - xmin;
+        Workspace entry;
+        entry.ws.reset(new RooWorkspace(Form("apg_gaus_%zu", (size_t)fTick)));
+        entry.ws->factory(Form("Gaussian::gauss(x[%.17g,%.17g],"
+                               "mean[%.17g,%.17g,%.17g],sigma[%.17g,%.17g,%.17g])",
+                               xmin, xmax,
+                               0.5 * (xmin + xmax), xmin, xmax,
+                               0.1 * width, 1e-6 * width, width));
+        entry.ws->var("x")->setBins(hist->GetNbinsX());
+        it = fWorkspaces.emplace(shape, std::move(entry)).first;
+    }
+    it->second.lastUse = ++fTick;
+    return it->second;
+}
+
+void RooFitBackend::Clear()
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    fWorkspaces.clear();
+}
+
+size_t RooFitBackend::GetNumWorkspaces()
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    return fWorkspaces.size();
+}
+
+// ============================================================================
+// FitGaussian
+// ============================================================================
+RooFitGaussResult RooFitBackend::FitGaussian(const TH1* hist)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    RooFitGaussResult result;
+    if (!hist || hist->GetDimension() != 1) {
+        result.message = "not a 1-D histogram";
+        return result;
+    }
+
+    std::lock_guard<std::mutex> lock(fMutex);
+    Workspace&  entry = GetLocked(hist);
+    RooRealVar* x     = entry.ws->var("x");
+    RooRealVar* mean  = entry.ws->var("mean");
+    RooRealVar* sigma = entry.ws->var("sigma");
+    RooAbsPdf*  gauss = entry.ws->pdf("gauss");
+
+    // Same histogram as before: restore instead of refitting
+    std::string key = FitCache::MakeKey(hist, "roofit-gaus|v2");
+    CachedFit cached;
+    if (!key.empty() && FitCache::Instance().Lookup(key, cached) && cached.params.size() == 2) {
+        result.mean       = cached.params[0];
+        result.meanError  = cached.errors[0];
+        result.sigma      = cached.params[1];
+        result.sigmaError = cached.errors[1];
+        result.minNll     = cached.chi2;
+        result.status     = cached.status;
+        result.valid      = cached.valid;
+        result.cached     = true;
+    } else {
+        // Seed from the last fit of this shape if it still describes the
+        // data, otherwise from the histogram's moments
+        double hMean = hist->GetMean();
+        double hRms  = hist->GetRMS();
+        double width = x->getMax() - x->getMin();
+        if (entry.fitted && std::fabs(entry.lastMean - hMean) <= std::max(hRms, entry.lastSigma)) {
+            mean->setVal(entry.lastMean);
+            sigma->setVal(entry.lastSigma);
+            result.seeded = true;
+        } else {
+            mean->setVal(hMean);
+            sigma->setVal(hRms > 0 ? std::min(hRms, width) : 0.1 * width);
+        }
+
+        RooDataHist data("data", "data", RooArgList(*x), hist);
+        std::unique_ptr<RooFitResult> fit(gauss->fitTo(data,
+                                                       RooFit::Save(true),
+                                                       RooFit::PrintLevel(-1),
+                                                       RooFit::Extended(false),
+                                                       EvalArg(hist->GetNbinsX())));
+        if (!fit) {
+            result.message = "RooFit returned no result";
+        } else {
+            result.status  = fit->status();
+            result.covQual = fit->covQual();
+            result.minNll  = fit->minNll();
+            result.edm     = fit->edm();
+            result.valid   = (result.status == 0);
+        }
+        result.mean       = mean->getVal();
+        result.meanError  = mean->getError();
+        result.sigma      = sigma->getVal();
+        result.sigmaError = sigma->getError();
+
+        if (fit && !key.empty()) {
+            CachedFit store;
+            store.parNames = { "mean", "sigma" };
+            store.params   = { result.mean, result.sigma };
+            store.errors   = { result.meanError, result.sigmaError };
+            store.chi2     = result.minNll;
+            store.ndf      = hist->GetNbinsX() - 2;
+            store.status   = result.status;
+            store.valid    = result.valid;
+            FitCache::Instance().Store(key, store);
+        }
+    }
+
+    if (result.status >= 0) {
+        entry.fitted    = true;
+        entry.lastMean  = result.mean;
+        entry.lastSigma = result.sigma;
+    }
+    if (!result.valid && result.message.empty()) result.message = "fit did not converge";
+
+    result.seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - t0).count();
+    return result;
+}
+
+// ============================================================================
+// Drawing / printing
+// ============================================================================
+void RooFitBackend::DrawGaussian(const TH1* hist, const RooFitGaussResult& result, int color)
+{
+    if (!hist || hist->GetDimension() != 1) return;
+
+    std::lock_guard<std::mutex> lock(fMutex);
+    Workspace&  entry = GetLocked(hist);
+    RooRealVar* x     = entry.ws->var("x");
+    RooAbsPdf*  gauss = entry.ws->pdf("gauss");
+    entry.ws->var("mean")->setVal(result.mean);
+    entry.ws->var("sigma")->setVal(result.sigma);
+
+    // plotOn copies into the frame, so the dataset can go out of scope
+    RooDataHist data("data", "data", RooArgList(*x), hist);
+    RooPlot* frame = x->frame();
+    data.plotOn(frame);
+    gauss->plotOn(frame, RooFit::LineColor(color));
+    frame->SetBit(kCanDelete);
+    frame->Draw("same");
+}
+
+void RooFitBackend::Print(const RooFitGaussResult& result, std::ostream& os)
+{
+    os << "\n=== RooFit Gaussian Fit Results ===\n";
+    os << "Mean:  " << std::setprecision(6) << result.mean
+       << " +- " << std::setprecision(3) << result.meanError << "\n";
+    os << "Sigma: " << std::setprecision(6) << result.sigma
+       << " +- " << std::setprecision(3) << result.sigmaError << "\n";
+    if (result.status >= 0)
+        os << "-log L = " << std::setprecision(10) << result.minNll
+           << "   status = " << result.status << "\n";
+    if (result.cached)      os << "(restored from fit cache)\n";
+    else if (result.seeded) os << "(seeded from the previous fit, "
+                               << std::setprecision(3) << result.seconds << " s)\n";
+    if (!result.message.empty()) os << "(" << result.message << ")\n";
+    os << "===================================\n" << std::endl;
+}
@@ -1,4 +1,6 @@
 #include "RootEntrySelector.h"
+#include "RNTupleData.h"
+#include "RowSelection.h"
 
 #include <TGLayout.h>
 #include <TGMsgBox.h>
@@ -12,9 +14,14 @@
 #include <TTreeFormula.h>
 #include <TEventList.h>
 
+#include <TH1D.h>
+
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <limits>
 
 ClassImp(RootEntrySelector)
 
@@ -289,6 +296,7 @@ void RootEntrySelector::ScanFile()
     if (!fFile) return;
     
     fObjectList.clear();
+    fNTuples.clear();
     fObjectCombo->RemoveAll();
     
     TIter next(fFile->GetListOfKeys());
@@ -299,8 +307,13 @@ void RootEntrySelector::ScanFile()
         TString className = key->GetClassName();
         TString objName = key->GetName();
         
-        // Accept histograms and trees
-        if (className.BeginsWith("TH") || className == "TTree") {
+        // Accept histograms, trees and RNTuples
+        bool isNTuple = RNTupleData::IsRNTupleClass(className.Data());
+        if (isNTuple) {
+            className = "RNTuple";
+            fNTuples[objName.Data()] = nullptr;
+        }
+        if (className.BeginsWith("TH") || className == "TTree" || isNTuple) {
             char entry[512];
             snprintf(entry, sizeof(entry), "%s [%s]", objName.Data(), className.Data());
             fObjectList.push_back(objName.Data());
@@ -350,6 +363,10 @@ void RootEntrySelector::UpdateObjectInfo()
     if (selected < 0 || selected >= (Int_t)fObjectList.size()) return;
     
     std::string objName = fObjectList[selected];
+    if (IsNTuple(objName)) {
+        UpdateNTupleInfo(objName);
+        return;
+    }
     TObject* obj = fFile->Get(objName.c_str());
     
     if (!obj) {
@@ -420,6 +437,11 @@ void RootEntrySelector::AddSelectionStep()
     
     std::string objName = fObjectList[selected];
     std::cout << "Object name: " << objName << std::endl;
+
+    if (IsNTuple(objName)) {
+        AddNTupleStep(objName);
+        return;
+    }
     
     // Get fresh object from file
     TObject* obj = fFile->Get(objName.c_str());
@@ -543,7 +565,15 @@ void RootEntrySelector::AddSelectionStep()
         }
     }
     
-    // Add to chain
+    AppendStep(step);
+    std::cout << "=== AddSelectionStep() END ===\n" << std::endl;
+}
+
+// ============================================================================
+// Add a step to the chain and the list box
+// ============================================================================
+void RootEntrySelector::AppendStep(const SelectionStep& step)
+{
     fSelectionChain.push_back(step);
     
     // Update list box with safe string handling
@@ -554,7 +584,6 @@ void RootEntrySelector::AddSelectionStep()
     
     std::cout << "\n✓ Added selection step " << fSelectionChain.size() << std::endl;
     std::cout << "  Description: " << step.GetDescription() << std::endl;
-    std::cout << "=== AddSelectionStep() END ===\n" << std::endl;
 }
 
 // ============================================================================
@@ -625,6 +654,14 @@ void RootEntrySelector::PlotCurrentSelection()
     // Get object name safely
     std::string objName = fObjectList[selected];
     std::cout << "Getting object: " << objName << std::endl;
+
+    if (IsNTuple(objName)) {
+        SelectionStep step = StepFromGUI(objName, "RNTuple");
+        TGTextEntry* te = fBranchCombo->GetTextEntry();
+        if (te && strlen(te->GetText()) > 0) step.objectName += std::string(":") + te->GetText();
+        PlotNTuple(step);
+        return;
+    }
     
     // Get fresh object from file
     TObject* obj = fFile->Get(objName.c_str());
@@ -966,6 +1003,16 @@ TCanvas* RootEntrySelector::PlotWithChain(const std::vector<SelectionStep>& chai
     if (!branchName.empty()) {
         std::cout << "Branch to plot: " << branchName << std::endl;
     }
+
+    // RNTuple: cumulative cut through CutCache on its table
+    if (IsNTuple(objName)) {
+        if (!DrawNTuple(finalStep, cumulativeCut)) {
+            delete c;
+            return nullptr;
+        }
+        c->Update();
+        return c;
+    }
     
     // Get object from file
     TObject* obj = fFile->Get(objName.c_str());
@@ -1189,6 +1236,185 @@ TCanvas* RootEntrySelector::PlotWithChain(const std::vector<SelectionStep>& chai
 
 */
 
+// ============================================================================
+// RNTuples: shown like trees (fields as branches); selections are evaluated
+// on the table read from the RNTuple, with the main window's cut syntax
+// (ColumnExpression) and entry ranges as row ranges
+// ============================================================================
+std::shared_ptr<ColumnData> RootEntrySelector::GetNTupleTable(const std::string& name)
+{
+    auto it = fNTuples.find(name);
+    if (it == fNTuples.end()) return nullptr;
+    if (!it->second) {
+        auto table = std::make_shared<ColumnData>();
+        std::string error;
+        if (!RNTupleData::Read(fFilename.Data(), name, *table, nullptr, error)) {
+            new TGMsgBox(gClient->GetRoot(), this, "Error", error.c_str(),
+                kMBIconStop, kMBOk);
+            return nullptr;
+        }
+        it->second = table;
+    }
+    return it->second;
+}
+
+void RootEntrySelector::UpdateNTupleInfo(const std::string& name)
+{
+    fCurrentTree = nullptr;
+    fCurrentHist = nullptr;
+    fBranchCombo->RemoveAll();
+    fBranchCombo->SetEnabled(kFALSE);
+
+    std::vector<RNTupleData::FieldInfo> fields;
+    Long64_t entries = 0;
+    std::string error;
+    if (!RNTupleData::Describe(fFilename.Data(), name, fields, entries, error)) {
+        fObjectInfoLabel->SetText(error.c_str());
+        fEntriesLabel->SetText("Entries: -");
+    } else {
+        int id = 0;
+        for (const auto& f : fields)
+            if (f.numeric) fBranchCombo->AddEntry(f.name.c_str(), id++);
+        if (id > 0) {
+            fBranchCombo->Select(0);
+            fBranchCombo->SetEnabled(kTRUE);
+        }
+        fObjectInfoLabel->SetText(Form("Type: RNTuple | Fields: %zu (%d numeric)",
+                                       fields.size(), id));
+        fEntriesLabel->SetText(Form("Entries: %lld", entries));
+        fEndEntry->SetNumber(entries - 1);
+    }
+
+    gClient->NeedRedraw(fObjectInfoLabel);
+    gClient->NeedRedraw(fEntriesLabel);
+}
+
+SelectionStep RootEntrySelector::StepFromGUI(const std::string& objName, const char* objType) const
+{
+    SelectionStep step;
+    step.objectName  = objName;
+    step.objectType  = objType;
+    step.entryStart  = (Long64_t)fStartEntry->GetNumber();
+    step.entryEnd    = (Long64_t)fEndEntry->GetNumber();
+    step.cutFormula  = fCutEntry->GetText();
+    step.drawOptions = fDrawOptEntry->GetText();
+    return step;
+}
+
+bool RootEntrySelector::AddNTupleStep(const std::string& name)
+{
+    SelectionStep step = StepFromGUI(name, "RNTuple");
+    TGTextEntry* te = fBranchCombo->GetTextEntry();
+    std::string field = te ? te->GetText() : "";
+
+    auto table = GetNTupleTable(name);
+    if (!table) return false;
+    if (field.empty() && !table->headers.empty()) field = table->headers[0];
+    if (std::find(table->headers.begin(), table->headers.end(), field) == table->headers.end()) {
+        new TGMsgBox(gClient->GetRoot(), this, "Error",
+            Form("Field '%s' is not a numeric field of RNTuple '%s'.",
+                 field.c_str(), name.c_str()),
+            kMBIconStop, kMBOk);
+        return false;
+    }
+
+    // Reject a bad cut now rather than when the chain is plotted
+    std::string error;
+    if (!CutCache::Instance().Get(*table, step.cutFormula, error)) {
+        new TGMsgBox(gClient->GetRoot(), this, "Invalid Cut", error.c_str(),
+            kMBIconExclamation, kMBOk);
+        return false;
+    }
+
+    step.objectName = name + ":" + field;
+    AppendStep(step);
+    return true;
+}
+
+TCanvas* RootEntrySelector::PlotNTuple(const SelectionStep& step)
+{
+    static int canvasCount = 0;
+    TCanvas* c = new TCanvas(Form("c_ntuple_%d", ++canvasCount),
+                             ("RNTuple: " + step.objectName).c_str(), 800, 600);
+    if (!DrawNTuple(step, step.cutFormula)) {
+        delete c;
+        return nullptr;
+    }
+    c->Update();
+    return c;
+}
+
+// Histogram of the step's field over the rows passing cut within its entry
+// range, drawn in the current pad (100 bins over the selected values'
+// range, as TTree::Draw)
+bool RootEntrySelector::DrawNTuple(const SelectionStep& step, const std::string& cut)
+{
+    std::string name = step.objectName, field;
+    size_t colon = name.find(':');
+    if (colon != std::string::npos) {
+        field = name.substr(colon + 1);
+        name  = name.substr(0, colon);
+    }
+
+    auto table = GetNTupleTable(name);
+    if (!table || table->headers.empty()) return false;
+    size_t column = field.empty() ? 0
+        : std::find(table->headers.begin(), table->headers.end(), field) - table->headers.begin();
+    if (column >= table->headers.size()) {
+        new TGMsgBox(gClient->GetRoot(), this, "Error",
+            Form("Field '%s' not found in RNTuple '%s'", field.c_str(), name.c_str()),
+            kMBIconStop, kMBOk);
+        return false;
+    }
+    field = table->headers[column];
+
+    std::string error;
+    auto selection = CutCache::Instance().Get(*table, cut, error);
+    if (!selection) {
+        new TGMsgBox(gClient->GetRoot(), this, "Invalid Cut", error.c_str(),
+            kMBIconExclamation, kMBOk);
+        return false;
+    }
+
+    const ColumnData::Column& values = table->data[column];
+    const size_t first = (size_t)std::max<Long64_t>(0, step.entryStart);
+    const size_t limit = step.entryEnd > 0
+        ? std::min(values.size(), (size_t)step.entryEnd + 1) : values.size();
+
+    double lo = std::numeric_limits<double>::infinity(), hi = -lo;
+    Long64_t n = 0;
+    selection->ForEach(limit, [&](size_t row) {
+        if (row < first || !std::isfinite(values[row])) return;
+        lo = std::min(lo, values[row]);
+        hi = std::max(hi, values[row]);
+        ++n;
+    });
+    std::cout << "→ " << n << " entries of " << name << " pass "
+              << (cut.empty() ? "(no cut)" : cut) << std::endl;
+    if (n == 0) {
+        new TGMsgBox(gClient->GetRoot(), this,
+            "Warning", "No entries passed the selection cuts!\n"
+                      "Check your cut formulas and entry ranges.",
+            kMBIconExclamation, kMBOk);
+        return false;
+    }
+    double margin = hi > lo ? 0.01 * (hi - lo) : 1.0;
+
+    static int histCount = 0;
+    TH1D* h = new TH1D(Form("h_%s_%d", field.c_str(), ++histCount),
+                       (field + (cut.empty() ? "" : " {" + cut + "}")).c_str(),
+                       100, lo - margin, hi + margin);
+    selection->ForEach(limit, [&](size_t row) {
+        if (row >= first) h->Fill(values[row]);
+    });
+    h->GetXaxis()->SetTitle(field.c_str());
+
+    std::string drawOpt = step.drawOptions;
+    if (drawOpt == "COLZ" || drawOpt == "colz") drawOpt = "";   // 1D
+    h->Draw(drawOpt.c_str());
+    return true;
+}
+
 // ============================================================================
 // Save selection chain to file
 // ============================================================================
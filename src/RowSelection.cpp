@@ -0,0 +1,189 @@
+#include "RowSelection.h"
+#include "ColumnExpression.h"
+
+#include <bitset>
+
+// ============================================================================
+// RowSelection
+// ============================================================================
+RowSelection::RowSelection(size_t rows, bool all)
+    : fWords((rows + 63) / 64, all ? ~uint64_t(0) : 0), fRows(rows)
+{
+    ClearTail();
+}
+
+void RowSelection::ClearTail()
+{
+    if (fRows % 64) fWords.back() &= (uint64_t(1) << (fRows % 64)) - 1;
+}
+
+size_t RowSelection::Count() const
+{
+    size_t n = 0;
+    for (uint64_t w : fWords) n += std::bitset<64>(w).count();
+    return n;
+}
+
+RowSelection& RowSelection::operator&=(const RowSelection& other)
+{
+    size_t common = std::min(fWords.size(), other.fWords.size());
+    for (size_t i = 0; i < common; ++i) fWords[i] &= other.fWords[i];
+    std::fill(fWords.begin() + common, fWords.end(), 0);
+    return *this;
+}
+
+RowSelection& RowSelection::operator|=(const RowSelection& other)
+{
+    if (other.fRows > fRows) {
+        fRows = other.fRows;
+        fWords.resize(other.fWords.size(), 0);
+    }
+    for (size_t i = 0; i < other.fWords.size(); ++i) fWords[i] |= other.fWords[i];
+    return *this;
+}
+
+void RowSelection::Invert()
+{
+    for (uint64_t& w : fWords) w = ~w;
+    ClearTail();
+}
+
+RowSelection& RowSelection::operator&=(const ValidityBitmap& valid)
+{
+    size_t common = std::min(fWords.size(), valid.NumWords());
+    for (size_t i = 0; i < common; ++i) fWords[i] &= valid.Words()[i];
+    return *this;
+}
+
+std::shared_ptr<const RowSelection> DropNulls(std::shared_ptr<const RowSelection> sel,
+                                              const ColumnData& data,
+                                              std::initializer_list<int> columns)
+{
+    std::shared_ptr<RowSelection> valid;
+    for (int c : columns) {
+        const ValidityBitmap* bitmap = c >= 0 ? data.Validity(c) : nullptr;
+        if (!bitmap) continue;
+        if (!valid) {
+            size_t rows = 0;
+            for (int d : columns)
+                if (d >= 0 && d < (int)data.data.size()) rows = std::max(rows, data.data[d].size());
+            valid = sel ? std::make_shared<RowSelection>(*sel)
+                        : std::make_shared<RowSelection>(rows, true);
+        }
+        *valid &= *bitmap;
+    }
+    return valid ? valid : sel;
+}
+
+// ============================================================================
+// CutCache
+// ============================================================================
+CutCache& CutCache::Instance()
+{
+    static CutCache cache;
+    return cache;
+}
+
+std::vector<std::vector<std::string>> CutCache::SplitTerms(const std::string& cut)
+{
+    auto trim = [](const std::string& s) {
+        size_t b = s.find_first_not_of(" \t\r\n");
+        if (b == std::string::npos) return std::string();
+        return s.substr(b, s.find_last_not_of(" \t\r\n") - b + 1);
+    };
+
+    std::vector<std::vector<std::string>> groups(1);
+    size_t start = 0;
+    int    depth = 0;
+    for (size_t i = 0; i < cut.size(); ++i) {
+        char c = cut[i];
+        if (c == '`') {   // quoted column name: skip to its end
+            size_t close = cut.find('`', i + 1);
+            if (close == std::string::npos) break;
+            i = close;
+        } else if (c == '(') {
+            ++depth;
+        } else if (c == ')') {
+            --depth;
+        } else if (depth == 0 && i + 1 < cut.size() &&
+                   ((c == '&' && cut[i + 1] == '&') || (c == '|' && cut[i + 1] == '|'))) {
+            groups.back().push_back(trim(cut.substr(start, i - start)));
+            if (c == '|') groups.emplace_back();
+            start = ++i + 1;
+        }
+    }
+    groups.back().push_back(trim(cut.substr(start)));
+    return groups;
+}
+
+std::shared_ptr<const RowSelection> CutCache::GetTerm(const ColumnData& data,
+                                                      const std::string& term,
+                                                      std::string& error)
+{
+    // Compiling is cheap and reports errors; only evaluations are cached
+    ColumnExpression expr;
+    if (!expr.Compile(term, data.headers, error)) {
+        error = "'" + term + "': " + error;
+        return nullptr;
+    }
+
+    Key key(data.uid, term);
+    Entry existing;
+    std::promise<std::shared_ptr<const RowSelection>> promise;
+    {
+        std::lock_guard<std::mutex> lock(fMutex);
+        auto it = fEntries.find(key);
+        if (it != fEntries.end()) {
+            existing = it->second;
+        } else {
+            fEntries[key] = promise.get_future().share();
+            fOrder.push_back(key);
+            while (fOrder.size() > kMaxEntries) {
+                fEntries.erase(fOrder.front());   // holders keep their shared_ptr
+                fOrder.pop_front();
+            }
+        }
+    }
+    if (existing.valid()) return existing.get();   // may wait for another thread's evaluation
+
+    auto selection = std::make_shared<RowSelection>();
+    expr.Select(data, *selection);
+    promise.set_value(selection);
+    return selection;
+}
+
+std::shared_ptr<const RowSelection> CutCache::Get(const ColumnData& data, const std::string& cut,
+                                                  std::string& error)
+{
+    if (cut.find_first_not_of(" \t\r\n") == std::string::npos)
+        return std::make_shared<RowSelection>(data.GetNumRows(), true);
+
+    auto groups = SplitTerms(cut);
+    if (groups.size() == 1 && groups[0].size() == 1 && !groups[0][0].empty())
+        return GetTerm(data, groups[0][0], error);   // the cached bitmap itself
+
+    std::shared_ptr<RowSelection> result;
+    for (const auto& group : groups) {
+        std::shared_ptr<RowSelection> all;
+        for (const auto& term : group) {
+            if (term.empty()) {
+                error = "empty term in cut '" + cut + "'";
+                return nullptr;
+            }
+            auto selection = GetTerm(data, term, error);
+            if (!selection) return nullptr;
+            if (!all) all = std::make_shared<RowSelection>(*selection);
+            else      *all &= *selection;
+        }
+        if (!result) result = all;
+        else         *result |= *all;
+    }
+    return result;
+}
+
+void CutCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    fEntries.clear();
+    fOrder.clear();
+}
@@ -7,6 +7,10 @@
 #include <TROOT.h>
 #include <TSystem.h>
 #include <TCanvas.h>
+#include <TClass.h>
+#include <TFile.h>
+#include <TH1.h>
+#include <TKey.h>
 #include <TObjString.h>
 #include <TObjArray.h>
 #include <TGMsgBox.h>
@@ -14,8 +18,18 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <memory>
 #include <string>
 
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <regex>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
 // ============================================================================
 // Constructor
 // ============================================================================
@@ -24,8 +38,20 @@ ScriptEngine::ScriptEngine(AdvancedPlotGUI* mainGUI)
       fCoutStream(nullptr),
       fCerrStream(nullptr),
       fOldCout(nullptr),
-      fOldCerr(nullptr)
+      fOldCerr(nullptr),
+      fRunning(false),
+      fReaderDone(false),
+      fChildPid(-1),
+      fChildGroup(-1),
+      fChildStatus(0),
+      fPollTimer(nullptr),
+      fLanguage(0),
+      fInterrupts(0),
+      fOutPipe{-1, -1},
+      fErrPipe{-1, -1}
 {
+    // The GUI receives HandleTimer() and forwards it to PollScript()
+    fPollTimer = new TTimer(fMainGUI, 100);
 }
 
 // ============================================================================
@@ -33,6 +59,21 @@ ScriptEngine::ScriptEngine(AdvancedPlotGUI* mainGUI)
 // ============================================================================
 ScriptEngine::~ScriptEngine()
 {
+    if (fRunning) {   // GUI closed while a script runs: it goes with it
+        kill(-fChildGroup, SIGKILL);
+        if (fChildPid > 0)
+            while (waitpid(fChildPid, &fChildStatus, 0) < 0 && errno == EINTR) {}
+        if (fReaderThread.joinable()) fReaderThread.join();
+        close(fOutPipe[0]);
+        close(fErrPipe[0]);
+        for (const auto& file : fTmpFiles) gSystem->Unlink(file.Data());
+        if (!fCanvasFile.IsNull()) gSystem->Unlink(fCanvasFile.Data());
+    }
+    if (fPollTimer) {
+        fPollTimer->TurnOff();
+        delete fPollTimer;
+        fPollTimer = nullptr;
+    }
     RestoreStreams();
     delete fCoutStream;
     delete fCerrStream;
@@ -52,14 +93,32 @@ static void AppendOutput(TGTextView* out, const char* line)
     }
 }
 
+static bool WriteTextFile(const TString& path, const std::string& text)
+{
+    std::ofstream f(path.Data());
+    if (!f.is_open()) return false;
+    f << text;
+    return f.good();
+}
+
 // ============================================================================
 // RunScript
-// Strategy:
-//   C++ mode  – write the script to a tmp .C file exactly as typed,
-//               then execute with ROOT's ".x file.C" command.
-//               This handles both bare-statement scripts and
-//               scripts with a named void function correctly.
-//   Python    – execute the whole string via TPython::Exec.
+// Strategy: the script runs in a child process, so the GUI stays
+// responsive, its output streams line by line and Interrupt can always
+// stop it.
+//   C++ mode  – write the script to a tmp .C file exactly as typed and run
+//               "root -l -b -q file.C". A ROOT file open in the GUI is
+//               passed first, so gDirectory->GetFile() finds it.
+//   Python    – write it to a tmp .py file and run it with python3 -u
+//               through a small wrapper.
+//   Compiled  – (C++ with the "Compiled" box ticked) "root ... macro.C+":
+//               ACLiC builds the macro into a content-addressed cache and
+//               reuses the library while the script text is unchanged.
+// The child runs in batch mode (nothing it draws appears on screen); when
+// it ends, its canvases are written to a ROOT file and drawn here
+// (ShowScriptCanvases). Its stdout/stderr are pipes, read by a reader
+// thread and streamed into the output view by PollScript(), which also
+// shows the elapsed time. The GUI's own stdout/stderr are never touched.
 // ============================================================================
 void ScriptEngine::RunScript(Int_t language)
 {
@@ -67,6 +126,12 @@ void ScriptEngine::RunScript(Int_t language)
     TGTextView* output = fMainGUI->GetScriptOutput();
     if (!editor) return;
 
+    if (fRunning) {
+        AppendOutput(output, ">>> A script is already running (use Interrupt to stop it).");
+        return;
+    }
+    if (language != 0 && language != 1) return;
+
     TString code = editor->GetText()->AsString();
     if (code.IsNull() || code.IsWhitespace()) {
         AppendOutput(output, ">>> (script editor is empty)");
@@ -74,70 +139,453 @@ void ScriptEngine::RunScript(Int_t language)
     }
 
     AppendOutput(output, ">>> Running script...");
-    gSystem->ProcessEvents();
+
+    fLanguage     = language;
+    fTmpFiles.clear();
+    fCompileMacro = "";
+    fCompileHash  = "";
+
+    if (language == 0 && fMainGUI->UseCompiledScripts() &&
+        !PrepareCompiledScript(code, output)) return;
+
+    // Temp files go in a directory of their own, so a macro can be named
+    // after its entry function
+    const int pid = (int)gSystem->GetPid();
+    TString   dir = Form("/tmp/apg_%d", pid);
+    gSystem->mkdir(dir.Data(), kTRUE);
+    fCanvasFile = Form("/tmp/apg_canvases_%d.root", pid);
+    gSystem->Unlink(fCanvasFile.Data());   // never show an earlier run's canvases
+
+    std::vector<std::string> args;
+    bool written = true;
 
     if (language == 0) {  // ROOT / C++
-        // ------------------------------------------------------------------
-        // Write exactly what the user typed into a temp .C file.
-        // ROOT's ".x file.C" will:
-        //   - If the file has a void funcname(){} matching the filename,
-        //     it compiles and calls it.
-        //   - Otherwise it interprets the file top-to-bottom.
-        // Either way it is correct, natural ROOT behaviour.
-        // ------------------------------------------------------------------
-        TString tmpFile = Form("/tmp/apg_script_%d.C", (int)gSystem->GetPid());
-
-        {
-            std::ofstream f(tmpFile.Data());
-            if (!f.is_open()) {
-                AppendOutput(output, ">>> ERROR: Cannot write temp file");
-                return;
-            }
-            f << code.Data();
+        TString macro = fCompileMacro.IsNull() ? TString("") : fCompileMacro + "+";
+        if (macro.IsNull()) {
+            // --------------------------------------------------------------
+            // Write exactly what the user typed into a temp .C file, named
+            // after the 'Entry' function when the script defines it.
+            // ROOT's "root file.C" will:
+            //   - If the file has a void funcname(){} matching the filename,
+            //     it compiles and calls it.
+            //   - Otherwise it interprets the file top-to-bottom.
+            // Either way it is correct, natural ROOT behaviour.
+            // --------------------------------------------------------------
+            std::string entry = fMainGUI->GetScriptEntryPoint().Data();
+            static const std::regex identifier("[A-Za-z_]\\w*");
+            bool named = std::regex_match(entry, identifier) && DefinesFunction(code, entry);
+            macro = Form("%s/%s.C", dir.Data(), named ? entry.c_str() : "apg_script");
+            fTmpFiles.push_back(macro);
+            written = WriteTextFile(macro, code.Data());
         }
 
-        // Capture stdout/stderr so we can mirror them in the output view
-        RedirectStreams();
+        // Around the script: line-buffer stdout (a pipe is block-buffered),
+        // and afterwards keep the canvases for ShowScriptCanvases()
+        TString begin = dir + "/apg_begin.C";
+        TString end   = dir + "/apg_end.C";
+        fTmpFiles.push_back(begin);
+        fTmpFiles.push_back(end);
+        written = written &&
+            WriteTextFile(begin, "void apg_begin() { setvbuf(stdout, nullptr, _IOLBF, 0); }\n") &&
+            WriteTextFile(end, std::string("void apg_end() {\n"
+                "    if (gROOT->GetListOfCanvases()->GetSize() == 0) return;\n"
+                "    TFile f(\"") + fCanvasFile.Data() + "\", \"RECREATE\");\n"
+                "    TIter next(gROOT->GetListOfCanvases());\n"
+                "    while (TObject* c = next()) c->Write();\n"
+                "}\n");
+
+        fProgram = RootExecutable();
+        args = { fProgram.Data(), "-l", "-b", "-q" };
+        TFile* current = gDirectory ? gDirectory->GetFile() : nullptr;
+        if (current && !gSystem->AccessPathName(current->GetName()))
+            args.push_back(current->GetName());
+        args.push_back(begin.Data());
+        args.push_back(macro.Data());
+        args.push_back(end.Data());
+
+    } else {  // Python
+        TString script  = dir + "/apg_script.py";
+        TString wrapper = dir + "/apg_run.py";
+        fTmpFiles.push_back(script);
+        fTmpFiles.push_back(wrapper);
+        // PyROOT takes -b from sys.argv, as root does; the canvases are
+        // saved even when the script fails or is interrupted
+        written = WriteTextFile(script, code.Data()) &&
+            WriteTextFile(wrapper,
+                "import runpy, sys\n"
+                "script, out = sys.argv[1], sys.argv[2]\n"
+                "sys.argv = [script, '-b']\n"
+                "try:\n"
+                "    runpy.run_path(script, run_name='__main__')\n"
+                "finally:\n"
+                "    ROOT = sys.modules.get('ROOT')\n"
+                "    if ROOT is not None and ROOT.gROOT.GetListOfCanvases().GetSize() > 0:\n"
+                "        f = ROOT.TFile.Open(out, 'RECREATE')\n"
+                "        for c in ROOT.gROOT.GetListOfCanvases():\n"
+                "            c.Write()\n"
+                "        f.Close()\n");
+
+        fProgram = PythonExecutable();
+        args = { fProgram.Data(), "-u", wrapper.Data(), script.Data(), fCanvasFile.Data() };
+    }
+    fTmpFiles.push_back(dir);   // last: removed once empty
+
+    if (!written) {
+        AppendOutput(output, ">>> ERROR: Cannot write temp file");
+        for (const auto& file : fTmpFiles) gSystem->Unlink(file.Data());
+        return;
+    }
+
+    if (!StartChild(args)) {
+        AppendOutput(output, Form(">>> ERROR: Cannot start %s", fProgram.Data()));
+        for (const auto& file : fTmpFiles) gSystem->Unlink(file.Data());
+        return;
+    }
 
-        Int_t err = 0;
-        gROOT->ProcessLine(Form(".x %s", tmpFile.Data()), &err);
+    fRunning    = true;
+    fInterrupts = 0;
+    fStartTime  = std::chrono::steady_clock::now();
+    fMainGUI->SetScriptRunning(kTRUE);
+    fPollTimer->TurnOn();
+}
 
-        gSystem->ProcessEvents();
-        FlushStreams(output);
-        RestoreStreams();
+// ============================================================================
+// Compiled mode.
+// The editor contents are hashed (FNV-1a over the text and the ROOT
+// version) and written once to <cache>/apg_<hash>.C together with a small
+// entry point named like the file, which is what "root macro.C+" calls.
+// The file is never rewritten while the hash matches, so ACLiC finds its
+// apg_<hash>_C.so up to date and only loads it.
+// The entry point is the function in the GUI's 'Entry' field; a script
+// without it is an error, not an interpreted run. fCompileMacro stays ""
+// to fall back to the interpreter when the cache cannot be written;
+// false = abort.
+// ============================================================================
+TString ScriptEngine::CompiledCacheDir()
+{
+    const char* env = gSystem->Getenv("APG_ACLIC_CACHE");
+    if (env && env[0]) return env;
+    return Form("%s/.cache/AdvancedPlotGUI/aclic", gSystem->HomeDirectory());
+}
+
+std::string ScriptEngine::HashScript(const TString& code)
+{
+    unsigned long long h = 1469598103934665603ULL;   // FNV-1a 64
+    auto mix = [&h](const char* p, Ssiz_t n) {
+        for (Ssiz_t i = 0; i < n; ++i) {
+            h ^= (unsigned char)p[i];
+            h *= 1099511628211ULL;
+        }
+    };
+    mix(code.Data(), code.Length());
+    const char* version = gROOT->GetVersion();
+    mix(version, (Ssiz_t)strlen(version));
+    return Form("%016llx", h);
+}
+
+// Whether code defines name() (no parameters), the signature possibly
+// split across lines
+bool ScriptEngine::DefinesFunction(const TString& code, const std::string& name)
+{
+    const std::regex def("(^|[^\\w:])[A-Za-z_][\\w:<>]*[\\s*&]+" + name +
+                         "\\s*\\(\\s*(void)?\\s*\\)\\s*\\{");
+    return std::regex_search(code.Data(), def);
+}
+
+bool ScriptEngine::PrepareCompiledScript(const TString& code, TGTextView* output)
+{
+    // As ROOT does for ".x file.C+": the function named after the macro,
+    // unless the user entered another
+    std::string entry = fMainGUI->GetScriptEntryPoint().Data();
+    static const std::regex identifier("[A-Za-z_]\\w*");
+    if (entry.empty() || !std::regex_match(entry, identifier)) {
+        AppendOutput(output, ">>> ERROR: Compiled mode needs the function to call in 'Entry'"
+                             " (set from the file name on Load/Save).");
+        return false;
+    }
+    if (!DefinesFunction(code, entry)) {
+        AppendOutput(output, Form(">>> ERROR: Compiled mode: the script defines no '%s()'"
+                                  " to call (see 'Entry').", entry.c_str()));
+        return false;
+    }
 
-        if (err) {
-            AppendOutput(output, ">>> Script finished with errors (see above).");
-        } else {
-            AppendOutput(output, ">>> Script finished OK.");
+    std::string hash  = HashScript(code + "\n" + entry.c_str());
+    std::string name  = "apg_" + hash;
+    TString     dir   = CompiledCacheDir();
+    TString     macro = Form("%s/%s.C", dir.Data(), name.c_str());
+
+    if (gSystem->AccessPathName(macro.Data())) {   // kTRUE = does not exist
+        gSystem->mkdir(dir.Data(), kTRUE);
+        std::ofstream f(macro.Data());
+        if (!f.is_open()) {
+            AppendOutput(output, Form(">>> ERROR: Cannot write %s; running interpreted.", macro.Data()));
+            return true;
         }
+        f << code.Data() << "\n\n"
+          << "// ---- generated by AdvancedPlotGUI: ACLiC entry point ----\n"
+          << "void " << name << "() { " << entry << "(); }\n";
+        AppendOutput(output, Form(">>> Compiling %s() with ACLiC (%s)...", entry.c_str(), hash.c_str()));
+    } else {
+        AppendOutput(output, Form(">>> Compiled cache hit (%s)", hash.c_str()));
+    }
+
+    fCompileMacro = macro;
+    fCompileHash  = hash;
+    return true;
+}
+
+// ============================================================================
+// Programs that run scripts
+// ============================================================================
+TString ScriptEngine::RootExecutable()
+{
+    TString exe = TROOT::GetBinDir() + "/root";
+    return gSystem->AccessPathName(exe.Data(), kExecutePermission) ? TString("root") : exe;
+}
 
-        gSystem->Unlink(tmpFile.Data());
+TString ScriptEngine::PythonExecutable()
+{
+    const char* env = gSystem->Getenv("APG_PYTHON");
+    return env && env[0] ? env : "python3";
+}
 
-    } else if (language == 1) {  // Python
-        RedirectStreams();
+// ============================================================================
+// Interrupt – stop the running script. The first press sends SIGINT to the
+// script's process group: Python raises KeyboardInterrupt, ROOT breaks off
+// the macro. A second press kills it.
+// ============================================================================
+void ScriptEngine::Interrupt()
+{
+    if (!fRunning || fChildGroup <= 0) return;
 
-        Bool_t ok = TPython::Exec(code.Data());
+    ++fInterrupts;
+    kill(-fChildGroup, fInterrupts == 1 ? SIGINT : SIGKILL);
 
-        gSystem->ProcessEvents();
-        FlushStreams(output);
-        RestoreStreams();
+    TGTextView* output = fMainGUI->GetScriptOutput();
+    if (output) {
+        output->AddLine(fInterrupts == 1
+            ? ">>> Interrupt requested (press again to kill the script)..."
+            : ">>> Killing the script...");
+        output->ShowBottom();
+    }
+}
+
+// ============================================================================
+// Timer callback routed from AdvancedPlotGUI::HandleTimer()
+// ============================================================================
+Bool_t ScriptEngine::HandleTimer(TTimer* timer)
+{
+    if (timer != fPollTimer) return kFALSE;
+    PollScript();
+    return kTRUE;
+}
 
-        if (!ok) {
-            AppendOutput(output, ">>> ERROR: Python execution failed (check syntax).");
-        } else {
-            AppendOutput(output, ">>> Python script finished OK.");
+// ============================================================================
+// PollScript – stream captured lines to the output view (GUI thread) and
+// finish once the child has exited and its output is read
+// ============================================================================
+void ScriptEngine::PollScript()
+{
+    if (!fRunning) return;
+
+    TGTextView* output = fMainGUI->GetScriptOutput();
+    std::vector<std::string> lines = fOutputQueue.Drain();
+    if (output && !lines.empty()) {
+        for (const auto& line : lines) output->AddLine(line.c_str());
+        output->ShowBottom();
+    }
+
+    if (fChildPid > 0 && waitpid(fChildPid, &fChildStatus, WNOHANG) == fChildPid)
+        fChildPid = -1;
+    if (fChildPid < 0 && fReaderDone) {
+        FinishScript();
+        return;
+    }
+
+    double elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - fStartTime).count();
+    fMainGUI->SetScriptStatus(Form("%s %.1f s",
+        fInterrupts ? "Interrupting..." : "Running", elapsed));
+}
+
+// ============================================================================
+// FinishScript – flush the tail of the output, report, show the canvases
+// ============================================================================
+void ScriptEngine::FinishScript()
+{
+    fPollTimer->TurnOff();
+    if (fReaderThread.joinable()) fReaderThread.join();
+    close(fOutPipe[0]); fOutPipe[0] = -1;
+    close(fErrPipe[0]); fErrPipe[0] = -1;
+
+    TGTextView* output = fMainGUI->GetScriptOutput();
+    if (output) {
+        for (const auto& line : fOutputQueue.Drain()) output->AddLine(line.c_str());
+    }
+
+    double elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - fStartTime).count();
+    bool exited = WIFEXITED(fChildStatus);
+    int  code   = exited ? WEXITSTATUS(fChildStatus) : 0;
+
+    if (fInterrupts) {
+        AppendOutput(output, Form(">>> Script interrupted after %.1f s.", elapsed));
+    } else if (exited && code == 127) {   // exec failed in the child
+        AppendOutput(output, Form(">>> ERROR: Cannot run %s (not installed or not in PATH?).",
+                                  fProgram.Data()));
+    } else if (!exited || code != 0) {
+        if (!fCompileHash.empty())
+            AppendOutput(output, ">>> Compiled mode: check the #include lines ACLiC needs,"
+                                 " or untick 'Compiled' to interpret.");
+        AppendOutput(output, exited
+            ? Form(">>> Script finished with errors (exit status %d, see above).", code)
+            : Form(">>> Script ended by signal %d.", WTERMSIG(fChildStatus)));
+    } else {
+        AppendOutput(output, Form(">>> %s finished OK (%.1f s).",
+                                  fLanguage == 1 ? "Python script" : "Script", elapsed));
+    }
+
+    for (const auto& file : fTmpFiles) gSystem->Unlink(file.Data());
+    fTmpFiles.clear();
+    ShowScriptCanvases();
+
+    fRunning = false;
+    fMainGUI->SetScriptRunning(kFALSE);
+}
+
+// ============================================================================
+// ShowScriptCanvases – draw the canvases the script left behind
+// ============================================================================
+void ScriptEngine::ShowScriptCanvases()
+{
+    if (fCanvasFile.IsNull() || gSystem->AccessPathName(fCanvasFile.Data())) return;
+
+    // The drawn objects must outlive the file
+    Bool_t addDirectory = TH1::AddDirectoryStatus();
+    TH1::AddDirectory(kFALSE);
+    int shown = 0;
+    {
+        std::unique_ptr<TFile> file(TFile::Open(fCanvasFile.Data(), "READ"));
+        if (file && !file->IsZombie()) {
+            TIter next(file->GetListOfKeys());
+            while (TKey* key = (TKey*)next()) {
+                TClass* cls = TClass::GetClass(key->GetClassName());
+                if (!cls || !cls->InheritsFrom(TCanvas::Class())) continue;
+                if (TCanvas* c = (TCanvas*)key->ReadObj()) {
+                    c->Draw();
+                    ++shown;
+                }
+            }
         }
     }
+    TH1::AddDirectory(addDirectory);
+    gSystem->Unlink(fCanvasFile.Data());
 
-    // Refresh all canvases that may have been created/modified
-    TIter nextCanvas(gROOT->GetListOfCanvases());
-    TCanvas* c;
-    while ((c = (TCanvas*)nextCanvas())) {
-        c->Modified();
-        c->Update();
+    if (shown > 0)
+        AppendOutput(fMainGUI->GetScriptOutput(),
+                     Form(">>> Showing %d canvas%s drawn by the script.", shown, shown == 1 ? "" : "es"));
+}
+
+// ============================================================================
+// StartChild – run args[0] with stdout/stderr on pipes read by a reader
+// thread, in its own process group so Interrupt reaches everything it
+// started (ACLiC's compiler included)
+// ============================================================================
+Bool_t ScriptEngine::StartChild(const std::vector<std::string>& args)
+{
+    if (pipe(fOutPipe) != 0) return kFALSE;
+    if (pipe(fErrPipe) != 0) {
+        close(fOutPipe[0]); close(fOutPipe[1]);
+        return kFALSE;
     }
-    gSystem->ProcessEvents();
+
+    // Built before fork(): the child only calls async-signal-safe functions
+    std::vector<char*> argv;
+    for (const auto& a : args) argv.push_back(const_cast<char*>(a.c_str()));
+    argv.push_back(nullptr);
+
+    std::cout.flush();
+    std::cerr.flush();
+    fflush(nullptr);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fOutPipe[0]); close(fOutPipe[1]);
+        close(fErrPipe[0]); close(fErrPipe[1]);
+        return kFALSE;
+    }
+    if (pid == 0) {
+        setpgid(0, 0);
+        int devNull = open("/dev/null", O_RDONLY);
+        if (devNull >= 0) dup2(devNull, STDIN_FILENO);
+        dup2(fOutPipe[1], STDOUT_FILENO);
+        dup2(fErrPipe[1], STDERR_FILENO);
+        close(fOutPipe[0]); close(fOutPipe[1]);
+        close(fErrPipe[0]); close(fErrPipe[1]);
+        execvp(argv[0], argv.data());
+        _exit(127);
+    }
+    setpgid(pid, pid);   // also here: Interrupt may come before the child runs
+    fChildPid    = pid;
+    fChildGroup  = pid;
+    fChildStatus = 0;
+
+    close(fOutPipe[1]); fOutPipe[1] = -1;
+    close(fErrPipe[1]); fErrPipe[1] = -1;
+    fcntl(fOutPipe[0], F_SETFD, FD_CLOEXEC);   // not inherited by later children
+    fcntl(fErrPipe[0], F_SETFD, FD_CLOEXEC);
+
+    fOutputQueue.Clear();
+    fReaderDone = false;
+    fReaderThread = std::thread(&ScriptEngine::ReadCapturedOutput, this);
+    return kTRUE;
+}
+
+// ============================================================================
+// Reader thread: split both pipes into lines, queue them for the GUI and
+// mirror the raw bytes to the terminal. Ends when the child (and whatever
+// it started) has closed both pipes.
+// ============================================================================
+void ScriptEngine::ReadCapturedOutput()
+{
+    struct pollfd fds[2] = {
+        { fOutPipe[0], POLLIN, 0 },
+        { fErrPipe[0], POLLIN, 0 }
+    };
+    std::string partial[2];
+    const char* prefix[2] = { "", "ERR: " };
+    int terminal[2] = { STDOUT_FILENO, STDERR_FILENO };
+    int nOpen = 2;
+    char buf[4096];
+
+    while (nOpen > 0) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        for (int k = 0; k < 2; ++k) {
+            if (fds[k].fd < 0 || !(fds[k].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            ssize_t n = read(fds[k].fd, buf, sizeof(buf));
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                if (!partial[k].empty()) fOutputQueue.Push(prefix[k] + partial[k]);
+                partial[k].clear();
+                fds[k].fd = -1;
+                --nOpen;
+                continue;
+            }
+            if (write(terminal[k], buf, n) < 0) { /* terminal gone; keep capturing */ }
+
+            partial[k].append(buf, n);
+            size_t pos;
+            while ((pos = partial[k].find('\n')) != std::string::npos) {
+                std::string line = partial[k].substr(0, pos);
+                partial[k].erase(0, pos + 1);
+                if (!line.empty()) fOutputQueue.Push(prefix[k] + line);
+            }
+        }
+    }
+    fReaderDone = true;
 }
 
 // ============================================================================
@@ -153,6 +601,11 @@ void ScriptEngine::RunCommand(Int_t language)
     cmd.Strip(TString::kBoth);
     if (cmd.IsNull()) return;
 
+    if (fRunning) {
+        AppendOutput(output, ">>> A script is running; wait for it or press Interrupt.");
+        return;
+    }
+
     AppendOutput(output, Form("root [>] %s", cmd.Data()));
 
     RedirectStreams();
@@ -179,6 +632,23 @@ void ScriptEngine::RunCommand(Int_t language)
     cmdEntry->Clear();
 }
 
+// ============================================================================
+// Compiled mode calls the function named after a C++ macro file, as
+// ".x name.C+" does
+// ============================================================================
+void ScriptEngine::SetEntryFromFile(const char* path)
+{
+    TString name = gSystem->BaseName(path);
+    Ssiz_t dot = name.Last('.');
+    if (dot == kNPOS) return;
+    TString ext = name(dot + 1, name.Length());
+    ext.ToLower();
+    if (ext != "c" && ext != "cpp" && ext != "cxx" && ext != "cc") return;
+    name.Remove(dot);
+    static const std::regex identifier("[A-Za-z_]\\w*");
+    if (std::regex_match(name.Data(), identifier)) fMainGUI->SetScriptEntryPoint(name.Data());
+}
+
 // ============================================================================
 // LoadScript – load a file into the editor
 // ============================================================================
@@ -218,6 +688,8 @@ void ScriptEngine::LoadScript()
         editor->LoadBuffer(content.c_str());
     }
 
+    SetEntryFromFile(fileInfo.fFilename);
+
     TGTextView* output = fMainGUI->GetScriptOutput();
     TString fname(fileInfo.fFilename);
     if (output) {
@@ -262,6 +734,7 @@ void ScriptEngine::SaveScript()
     TString content = editor->GetText()->AsString();
     file << content.Data();
     file.close();
+    SetEntryFromFile(fileInfo.fFilename);
 
     TGTextView* output = fMainGUI->GetScriptOutput();
     if (output) AppendOutput(output, Form(">>> Saved: %s", fileInfo.fFilename));
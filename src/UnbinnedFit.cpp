@@ -0,0 +1,356 @@
+#include "UnbinnedFit.h"
+#include "BatchFitter.h"
+#include "FitModels.h"
+#include "ThreadPool.h"
+
+#include <TDirectory.h>
+#include <TH1D.h>
+#include <TMath.h>
+#include <TROOT.h>
+
+#include <Math/Factory.h>
+#include <Math/Functor.h>
+#include <Math/GaussIntegrator.h>
+#include <Math/Minimizer.h>
+#include <Math/ProbFuncMathCore.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+
+namespace {
+
+// Below this many values splitting the sum is not worth the hand-off
+const size_t kMinParallel = 50000;
+
+// log() floor for points where the density is zero or negative
+const double kTiny = 1e-300;
+
+// ============================================================================
+// Density — the unnormalised model, callable from several threads at once:
+// registry models are pure functions, formulas get one TF1 copy per chunk
+// ============================================================================
+class Density {
+private:
+    std::shared_ptr<const FitModel>   fModel;
+    std::vector<std::unique_ptr<TF1>> fCopies;
+    bool                              fGaus = false;
+
+public:
+    bool Init(const UnbinnedSpec& spec, size_t nChunks,
+              std::vector<std::string>& parNames, std::string& title, std::string& error)
+    {
+        std::string name = spec.ModelName();
+        FitModelRegistry& registry = FitModelRegistry::Instance();
+        if (!name.empty()) {
+            fModel = registry.Find(name);
+            if (!fModel) {
+                error = "unknown fit model '" + name + "'";
+                return false;
+            }
+            fGaus    = (name == "gaus");
+            parNames = fModel->parNames;
+            title    = fModel->title;
+            return true;
+        }
+
+        for (size_t c = 0; c < nChunks; ++c) {
+            std::string fname = "unbinned_" + std::to_string(c);
+            TF1* f = registry.MakeFormulaFunction(spec.formula, fname.c_str(), 0, 1);
+            if (!f) {
+                error = "cannot use formula '" + spec.formula + "'";
+                return false;
+            }
+            fCopies.emplace_back(f);
+        }
+        for (int i = 0; i < fCopies[0]->GetNpar(); ++i) parNames.push_back(fCopies[0]->GetParName(i));
+        title = spec.formula;
+        return true;
+    }
+
+    bool IsGaus() const { return fGaus; }
+
+    double operator()(size_t chunk, double x, const double* p) const {
+        return fModel ? fModel->eval(&x, p) : fCopies[chunk]->EvalPar(&x, p);
+    }
+
+    // Integral over [a, b]; uses chunk 0, so calling thread only
+    double Integral(const double* p, double a, double b) const {
+        if (fGaus) {
+            // [0]*exp(-0.5*((x-[1])/[2])^2) in closed form
+            double sigma = std::fabs(p[2]);
+            if (sigma <= 0) return 0.0;
+            return p[0] * sigma * std::sqrt(2.0 * TMath::Pi()) *
+                   (ROOT::Math::normal_cdf((b - p[1]) / sigma) -
+                    ROOT::Math::normal_cdf((a - p[1]) / sigma));
+        }
+        ROOT::Math::Functor1D f([this, p](double x) { return (*this)(0, x, p); });
+        ROOT::Math::GaussIntegrator integrator;
+        integrator.SetFunction(f);
+        return integrator.Integral(a, b);
+    }
+};
+
+// Starting values from a quick binned fit of the same model
+std::vector<double> StartValues(const ColumnData::Column& values, const UnbinnedSpec& spec,
+                                double a, double b, size_t npar)
+{
+    TDirectory::TContext context(nullptr);   // keep the histogram out of gDirectory
+    TH1D h("unbinned_prefit", "", 100, a, b);
+    for (double x : values)
+        if (x >= a && x <= b) h.Fill(x);
+
+    FitSpec binned;
+    binned.type    = spec.type;
+    binned.formula = spec.formula;
+    binned.model   = spec.model;
+    std::vector<TF1*>   fitted;
+    std::vector<FitRow> rows = BatchFitter::FitAll({ &h }, binned, 1, &fitted);
+    delete fitted[0];
+
+    if (rows[0].params.size() == npar) return rows[0].params;
+    return std::vector<double>(npar, 1.0);
+}
+
+// Parameters the normalised density does not depend on at p. Column i is
+// d log f / d p[i] at points across [a, b], minus its mean over the points:
+// a change of log f that is the same everywhere goes into the normalisation.
+// Taken from the last parameter back, a column that lies in the span of the
+// ones kept (Gram-Schmidt residual ~ 0) is a flat direction of -log L and
+// its parameter is fixed. That covers an amplitude ([0]*gaus), a scale
+// shared by several parameters ([0]+[1]*x) and a non-linear one (expo's
+// exp([0]+[1]*x)).
+std::vector<bool> FindFlatParameters(const Density& density, const std::vector<double>& p,
+                                     double a, double b)
+{
+    const size_t npar = p.size();
+    std::vector<bool> fixed(npar, false);
+
+    const int nPoints = std::max<int>(16, 2 * (int)npar + 4);
+    std::vector<double> xs;
+    for (int k = 0; k < nPoints; ++k) {
+        double x = a + (b - a) * (k + 0.5) / nPoints;
+        double f = density(0, x, p.data());
+        if (f > 0 && std::isfinite(f)) xs.push_back(x);
+    }
+    if (xs.size() <= npar) return fixed;   // too few points to tell
+
+    std::vector<std::vector<double>> kept;   // orthonormal
+    for (size_t i = npar; i-- > 0;) {
+        double h = 1e-5 * std::max(1.0, std::fabs(p[i]));
+        std::vector<double> up = p, down = p;
+        up[i]   += h;
+        down[i] -= h;
+
+        std::vector<double> col(xs.size());
+        double mean = 0.0, raw = 0.0;
+        bool ok = true;
+        for (size_t k = 0; k < xs.size() && ok; ++k) {
+            double fu = density(0, xs[k], up.data());
+            double fd = density(0, xs[k], down.data());
+            ok = fu > 0 && fd > 0 && std::isfinite(fu) && std::isfinite(fd);
+            if (!ok) break;
+            col[k] = (std::log(fu) - std::log(fd)) / (2 * h);
+            mean += col[k];
+            raw  += col[k] * col[k];
+        }
+        if (!ok) continue;   // leave it to the fit
+        mean /= xs.size();
+        for (double& c : col) c -= mean;
+
+        for (const auto& e : kept) {
+            double dot = 0.0;
+            for (size_t k = 0; k < col.size(); ++k) dot += col[k] * e[k];
+            for (size_t k = 0; k < col.size(); ++k) col[k] -= dot * e[k];
+        }
+        double rest = 0.0;
+        for (double c : col) rest += c * c;
+
+        if (rest <= 1e-12 * raw) {   // relative residual below 1e-6
+            fixed[i] = true;
+            continue;
+        }
+        rest = std::sqrt(rest);
+        for (double& c : col) c /= rest;
+        kept.push_back(std::move(col));
+    }
+    return fixed;
+}
+
+} // namespace
+
+// ============================================================================
+// Fit
+// ============================================================================
+UnbinnedResult UnbinnedFit::Fit(const ColumnData& data, int column, const UnbinnedSpec& spec)
+{
+    if (column < 0 || column >= (int)data.data.size()) {
+        UnbinnedResult result;
+        result.message = "no column " + std::to_string(column);
+        return result;
+    }
+    const ValidityBitmap* valid = data.Validity(column);
+    if (!valid) return Fit(data.data[column], spec);   // in place
+
+    // Nulls left out
+    const ColumnData::Column& all = data.data[column];
+    ColumnData::Column values;
+    values.reserve(all.size() - valid->NullCount());
+    for (size_t i = 0; i < all.size(); ++i)
+        if (valid->Test(i)) values.push_back(all[i]);
+    return Fit(values, spec);
+}
+
+UnbinnedResult UnbinnedFit::Fit(const ColumnData::Column& values, const UnbinnedSpec& spec)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    UnbinnedResult result;
+
+    double a = spec.xMin, b = spec.xMax;
+    if (a >= b && !values.empty()) {
+        auto range = std::minmax_element(values.begin(), values.end());
+        a = *range.first;
+        b = *range.second;
+    }
+    result.xMin = a;
+    result.xMax = b;
+    result.nEvents = std::count_if(values.begin(), values.end(),
+                                   [a, b](double x) { return x >= a && x <= b; });
+    if (result.nEvents < 2 || a >= b) {
+        result.message = "too few values in range";
+        return result;
+    }
+
+    unsigned nThreads = spec.nThreads ? spec.nThreads : ThreadPool::DefaultSize();
+    if (values.size() < kMinParallel) nThreads = 1;
+    result.nThreads = nThreads;
+    ROOT::EnableThreadSafety();
+
+    Density density;
+    std::string error;
+    if (!density.Init(spec, nThreads, result.parNames, result.model, error)) {
+        result.message = error;
+        return result;
+    }
+    const size_t npar = result.parNames.size();
+
+    std::vector<double> start = StartValues(values, spec, a, b, npar);
+    result.fixed = FindFlatParameters(density, start, a, b);
+
+    // -log L = n log(norm) - sum_i log f(x_i), the sum split in chunks that
+    // read the column in place
+    std::unique_ptr<ThreadPool> pool(nThreads > 1 ? new ThreadPool(nThreads) : nullptr);
+    const size_t chunkSize = (values.size() + nThreads - 1) / nThreads;
+    const double n = (double)result.nEvents;
+
+    auto partial = [&](size_t c, const double* p) {
+        double sum = 0.0;
+        size_t end = std::min(values.size(), (c + 1) * chunkSize);
+        for (size_t i = c * chunkSize; i < end; ++i) {
+            double x = values[i];
+            if (!(x >= a && x <= b)) continue;   // also skips NaN
+            double f = density(c, x, p);
+            sum -= std::log(f > kTiny ? f : kTiny);
+        }
+        return sum;
+    };
+    auto nll = [&](const double* p) -> double {
+        double norm = density.Integral(p, a, b);
+        if (!(norm > 0) || !std::isfinite(norm)) return 1e30;
+        double sum = n * std::log(norm);
+        if (!pool) return sum + partial(0, p);
+
+        std::vector<std::future<double>> parts;
+        for (size_t c = 0; c < nThreads; ++c)
+            parts.push_back(pool->Submit([&partial, c, p]() { return partial(c, p); }));
+        for (auto& part : parts) sum += part.get();   // fixed order: reproducible
+        return sum;
+    };
+
+    std::unique_ptr<ROOT::Math::Minimizer> minimizer(
+        ROOT::Math::Factory::CreateMinimizer("Minuit2", "Migrad"));
+    if (!minimizer) {
+        result.message = "Minuit2 not available";
+        return result;
+    }
+    ROOT::Math::Functor fcn(nll, npar);
+    minimizer->SetFunction(fcn);
+    minimizer->SetErrorDef(0.5);   // -log L, not chi2
+    minimizer->SetPrintLevel(0);
+    for (size_t i = 0; i < npar; ++i) {
+        double step = start[i] != 0 ? 0.1 * std::fabs(start[i]) : 0.1;
+        const std::string& name = result.parNames[i];
+        if (result.fixed[i])
+            minimizer->SetFixedVariable(i, name, start[i]);
+        else if (density.IsGaus() && i == 2)
+            minimizer->SetLowerLimitedVariable(i, name, std::fabs(start[i]), step, 0.0);
+        else
+            minimizer->SetVariable(i, name, start[i], step);
+    }
+
+    result.valid = minimizer->Minimize();
+    minimizer->Hesse();
+    result.status = minimizer->Status();
+    result.nll    = minimizer->MinValue();
+    result.params.assign(minimizer->X(), minimizer->X() + npar);
+    result.errors.assign(minimizer->Errors(), minimizer->Errors() + npar);
+    for (size_t i = 0; i < npar; ++i)
+        if (result.fixed[i]) result.errors[i] = 0.0;
+    if (!result.valid) result.message = "fit did not converge";
+
+    result.seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - t0).count();
+    return result;
+}
+
+// ============================================================================
+// Drawing / printing
+// ============================================================================
+TF1* UnbinnedFit::MakeCurve(const UnbinnedResult& result, const UnbinnedSpec& spec,
+                            double binWidth, const char* name)
+{
+    if (result.params.empty()) return nullptr;
+
+    auto density = std::make_shared<Density>();
+    std::vector<std::string> parNames;
+    std::string title, error;
+    if (!density->Init(spec, 1, parNames, title, error)) return nullptr;
+
+    double norm = density->Integral(result.params.data(), result.xMin, result.xMax);
+    if (!(norm > 0)) return nullptr;
+    double scale = result.nEvents * binWidth / norm;
+
+    TF1* curve = new TF1(name,
+                         [density, scale](double* x, double* p) { return scale * (*density)(0, x[0], p); },
+                         result.xMin, result.xMax, (int)result.params.size(), 1,
+                         TF1::EAddToList::kNo);
+    for (size_t i = 0; i < result.params.size(); ++i) {
+        curve->SetParName(i, result.parNames[i].c_str());
+        curve->SetParameter(i, result.params[i]);
+        curve->SetParError(i, result.errors[i]);
+    }
+    return curve;
+}
+
+void UnbinnedFit::Print(const UnbinnedResult& result, std::ostream& os)
+{
+    os << "\n=== Unbinned ML Fit: " << result.model << " ===\n";
+    os << "Events in [" << result.xMin << ", " << result.xMax << "]: " << result.nEvents
+       << "   threads: " << result.nThreads
+       << "   time: " << std::setprecision(3) << result.seconds << " s\n";
+    for (size_t i = 0; i < result.params.size(); ++i) {
+        os << "  " << std::left << std::setw(12) << result.parNames[i] << std::right
+           << " = " << std::setprecision(6) << result.params[i];
+        if (result.fixed[i]) os << "  (fixed: normalisation)";
+        else                 os << " +- " << std::setprecision(3) << result.errors[i];
+        os << "\n";
+    }
+    if (result.status >= 0)
+        os << "-log L = " << std::setprecision(10) << result.nll << "   status = " << result.status << "\n";
+    if (!result.message.empty()) os << "(" << result.message << ")\n";
+    os << "===================================\n" << std::endl;
+}